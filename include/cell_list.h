@@ -0,0 +1,93 @@
+//
+// Created by Neil Kaushikkar on 5/18/21.
+//
+
+#ifndef IDEAL_GAS_CELL_LIST_H
+#define IDEAL_GAS_CELL_LIST_H
+
+#include "gas_particle.h"
+
+#include <vector>
+
+namespace idealgas {
+
+/**
+ * A uniform grid over a rectangular region that groups particles by the cell
+ * their center lies in. Every particle within one cell width of another is in
+ * the same cell or one of the 8 cells surrounding it, so neighbour searches
+ * only need to look at nearby cells instead of every particle.
+ */
+class CellList {
+ public:
+  CellList();
+
+  /**
+   * Creates an empty grid whose cells are at least the given width.
+   * @param lower_corner - the corner of the region closest to the origin
+   * @param upper_corner - the corner of the region furthest from the origin
+   * @param min_cell_size - the smallest width and height allowed for a cell
+   * @throws std::invalid_argument if the cell size is not positive
+   */
+  CellList(const glm::vec2& lower_corner, const glm::vec2& upper_corner,
+           float min_cell_size);
+
+  /**
+   * Places every particle into the cell containing its center. Particles
+   * outside of the region are placed in the nearest cell along the border.
+   * Runs in O(n) using a counting sort, and reuses memory between builds.
+   * @param particles - the particles to place, which are referred to by index
+   */
+  void Build(const std::vector<GasParticle>& particles);
+
+  size_t GetColumnCount() const;
+
+  size_t GetRowCount() const;
+
+  float GetCellWidth() const;
+
+  float GetCellHeight() const;
+
+  /**
+   * Finds the column of the cell that a position falls in.
+   * @param position - a point, which may be outside of the region
+   * @return the column index, clamped to the grid
+   */
+  size_t FindColumn(const glm::vec2& position) const;
+
+  /**
+   * Finds the row of the cell that a position falls in.
+   * @param position - a point, which may be outside of the region
+   * @return the row index, clamped to the grid
+   */
+  size_t FindRow(const glm::vec2& position) const;
+
+  /**
+   * Getter for the particles in a single cell.
+   * @param column - the column of the cell
+   * @param row - the row of the cell
+   * @return a pointer to the 1st particle index in the cell, which is followed
+   * by the rest of the cell's particle indices up to GetCellEnd
+   */
+  const size_t* GetCellBegin(size_t column, size_t row) const;
+
+  const size_t* GetCellEnd(size_t column, size_t row) const;
+
+ private:
+  glm::vec2 lower_corner_;
+  size_t column_count_;
+  size_t row_count_;
+  float cell_width_;
+  float cell_height_;
+
+  // where each cell's particles start in particle_indices_; the last entry
+  // holds the total number of particles
+  std::vector<size_t> cell_starts_;
+  // the indices of the particles, sorted by the cell they belong to
+  std::vector<size_t> particle_indices_;
+  // the cell of each particle, kept between builds to avoid reallocating
+  std::vector<size_t> particle_cells_;
+};
+
+}  // namespace idealgas
+
+#endif  // IDEAL_GAS_CELL_LIST_H
@@ -0,0 +1,44 @@
+//
+// Created by Neil Kaushikkar on 5/22/21.
+//
+
+#ifndef IDEAL_GAS_COLLISION_EVENT_H
+#define IDEAL_GAS_COLLISION_EVENT_H
+
+#include "record_stream.h"
+
+#include <cstdint>
+
+namespace idealgas {
+
+/**
+ * The kinds of collision a CollisionEvent can describe.
+ */
+enum class CollisionEventKind : uint32_t {
+  kParticleCollision = 0,
+  kWallCollision = 1
+};
+
+/**
+ * A compact, fixed-size record of a single collision. These are written to
+ * event files as raw bytes, 32 bytes per event in native byte order.
+ */
+struct CollisionEvent {
+  uint64_t frame;
+  CollisionEventKind kind;
+  // the index of the (1st) particle in the container
+  uint32_t particle_id;
+  // the index of the 2nd particle, or the ContainerWall that was hit
+  uint32_t other_id;
+  // the magnitude of the momentum transferred to the (1st) particle
+  float impulse;
+  // where the collision happened, or the particle's position for wall hits
+  float x_position;
+  float y_position;
+};
+
+typedef AsyncRecordStream<CollisionEvent> CollisionEventStream;
+
+}  // namespace idealgas
+
+#endif  // IDEAL_GAS_COLLISION_EVENT_H
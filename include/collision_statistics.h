@@ -0,0 +1,109 @@
+//
+// Created by Neil Kaushikkar on 5/21/21.
+//
+
+#ifndef IDEAL_GAS_COLLISION_STATISTICS_H
+#define IDEAL_GAS_COLLISION_STATISTICS_H
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace idealgas {
+
+/**
+ * Counts particle collisions for every pair of particle types, along with the
+ * distance each particle travelled between collisions. A container tallies a
+ * single frame into one of these and merges it into its running totals once
+ * the frame is over, so the totals are only touched once per frame.
+ */
+class CollisionStatistics {
+ public:
+  CollisionStatistics() = default;
+
+  /**
+   * Creates empty statistics for the given particle types.
+   * @param type_names - the names of the particle types
+   * @param type_counts - the number of particles of each type
+   */
+  CollisionStatistics(const std::vector<std::string>& type_names,
+                      const std::vector<size_t>& type_counts);
+
+  /**
+   * Counts a collision between particles of the given types.
+   * @param type_one - the index of the 1st particle's type
+   * @param type_two - the index of the 2nd particle's type
+   */
+  void RecordCollision(size_t type_one, size_t type_two);
+
+  /**
+   * Counts the distance a particle travelled before colliding.
+   * @param type - the index of the particle's type
+   * @param path_length - the distance travelled since its last collision
+   */
+  void RecordFreePath(size_t type, float path_length);
+
+  /**
+   * Counts a frame having passed.
+   */
+  void RecordFrame();
+
+  /**
+   * Adds the counts from other statistics over the same particle types.
+   * @param other - the statistics to add to these
+   */
+  void Merge(const CollisionStatistics& other);
+
+  /**
+   * Sets every count back to 0, keeping the particle types.
+   */
+  void Clear();
+
+  /**
+   * Getter for the number of collisions between 2 types of particles.
+   * @param type_one - the name of the 1st particle type
+   * @param type_two - the name of the 2nd particle type, which may be the same
+   * @return the number of collisions, or 0 if either type does not exist
+   */
+  size_t GetCollisionCount(const std::string& type_one,
+                           const std::string& type_two) const;
+
+  /**
+   * Computes how often a particle of a type collides with any other particle.
+   * @param type_name - the name of the particle type
+   * @return the average collisions per particle per frame
+   */
+  double GetCollisionFrequency(const std::string& type_name) const;
+
+  /**
+   * Computes the average distance a particle of a type travels between
+   * collisions. The 1st path of each particle starts when it was created.
+   * @param type_name - the name of the particle type
+   * @return the mean free path, or 0 if no particles of the type collided
+   */
+  double GetMeanFreePath(const std::string& type_name) const;
+
+  size_t GetFrameCount() const;
+
+ private:
+  std::vector<std::string> type_names_;
+  std::vector<size_t> type_counts_;
+
+  size_t frame_count_ = 0;
+  // collisions between each pair of types, with the lower type index first
+  std::vector<size_t> collision_counts_;
+  // the summed free path lengths, and how many were summed, for each type
+  std::vector<double> free_path_sums_;
+  std::vector<size_t> free_path_counts_;
+
+  /**
+   * Finds the index of a particle type.
+   * @param type_name - the name of the particle type
+   * @return the index of the type, or the number of types if it doesn't exist
+   */
+  size_t FindType(const std::string& type_name) const;
+};
+
+}  // namespace idealgas
+
+#endif  // IDEAL_GAS_COLLISION_STATISTICS_H
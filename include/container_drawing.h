@@ -0,0 +1,28 @@
+//
+// Created by Neil Kaushikkar on 6/5/21.
+//
+
+#ifndef IDEAL_GAS_CONTAINER_DRAWING_H
+#define IDEAL_GAS_CONTAINER_DRAWING_H
+
+#include "cinder/gl/gl.h"
+
+#include <vector>
+
+namespace idealgas {
+
+/**
+ * Draws the walls of the container and a circle for each particle, from
+ * copies of the particles' state rather than a GasContainer, so simulations
+ * and replays are drawn the same way.
+ * @param positions - where to draw each particle
+ * @param radii - the radius of each particle
+ * @param colors - the color of each particle
+ */
+void DrawContainerContents(const std::vector<glm::vec2>& positions,
+                           const std::vector<float>& radii,
+                           const std::vector<ci::Color8u>& colors);
+
+}  // namespace idealgas
+
+#endif  // IDEAL_GAS_CONTAINER_DRAWING_H
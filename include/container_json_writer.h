@@ -0,0 +1,134 @@
+//
+// Created by Neil Kaushikkar on 5/31/21.
+//
+
+#ifndef IDEAL_GAS_CONTAINER_JSON_WRITER_H
+#define IDEAL_GAS_CONTAINER_JSON_WRITER_H
+
+#include "gas_container.h"
+#include "parallel_for.h"
+
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace idealgas {
+
+/**
+ * How saved simulations are laid out.
+ */
+enum class JsonLayout {
+  // every value on its own line, indented by 2 spaces per level
+  kIndented,
+  // no whitespace at all, for the smallest files
+  kCompact
+};
+
+/**
+ * Writes a container as json straight from its particles, without building a
+ * json tree of it first. The output has the same schema and key order as
+ * dumping the container's json tree, and the indented layout matches dumping
+ * it with std::setw(2). Floats are written as the shortest decimal that reads
+ * back as the same float. Large containers are formatted in chunks of
+ * particles on several threads, and the chunks are written in order, so the
+ * output is the same for any number of workers.
+ */
+class ContainerJsonWriter {
+ public:
+  // How many particles each worker formats before its json is written out
+  static constexpr size_t kChunkParticleCount = 1 << 14;
+
+  /**
+   * Creates a writer for the given layout.
+   * @param layout - whether to indent the json or leave out all whitespace
+   * @param worker_count - the most threads to format particles on at once
+   */
+  explicit ContainerJsonWriter(JsonLayout layout,
+                               size_t worker_count = GetDefaultWorkerCount());
+
+  /**
+   * Writes a container to a stream, followed by a newline.
+   * @param container - the container to write
+   * @param output - the stream to write to
+   */
+  void Write(const GasContainer& container, std::ostream& output) const;
+
+ private:
+  JsonLayout layout_;
+  size_t worker_count_;
+
+  /**
+   * Formats the particles in [begin, end) on up to worker_count_ threads, one
+   * chunk of particles each, and writes the chunks to the stream in order.
+   * @param particles - all of the container's particles
+   * @param begin - the index of the first particle to write
+   * @param end - the index after the last particle to write
+   * @param chunks - one buffer for each worker, reused between calls
+   * @param output - the stream to write to
+   */
+  void WriteParticles(const std::vector<GasParticle>& particles, size_t begin,
+                      size_t end, std::vector<std::string>& chunks,
+                      std::ostream& output) const;
+
+  /**
+   * Starts a new line at the given depth, if the json is indented.
+   * @param depth - how many objects or arrays the line is inside of
+   * @param buffer - where to append the line break and indent
+   */
+  void AppendLineBreak(size_t depth, std::string& buffer) const;
+
+  /**
+   * Appends an object key on a new line, followed by its separator.
+   * @param key - the key to append
+   * @param depth - how many objects or arrays the key is inside of
+   * @param buffer - where to append the key
+   */
+  void AppendKey(const std::string& key, size_t depth,
+                 std::string& buffer) const;
+
+  /**
+   * Appends the json object of a single particle.
+   * @param particle - the particle to append
+   * @param depth - how many objects or arrays the particle is inside of
+   * @param buffer - where to append the particle
+   */
+  void AppendParticle(const GasParticle& particle, size_t depth,
+                      std::string& buffer) const;
+
+  /**
+   * Appends a vec2 as a json array of its 2 values.
+   * @param vec - the vec2 to append
+   * @param depth - how many objects or arrays the vec2 is inside of
+   * @param buffer - where to append the array
+   */
+  void AppendVector(const glm::vec2& vec, size_t depth,
+                    std::string& buffer) const;
+
+  /**
+   * Appends the json object of a single particle type.
+   * @param specs - the specs of the particle type
+   * @param depth - how many objects or arrays the particle type is inside of
+   * @param buffer - where to append the particle type
+   */
+  void AppendSpecs(const ParticleSpecs& specs, size_t depth,
+                   std::string& buffer) const;
+
+  /**
+   * Appends a string in quotes, escaping it like the json library does.
+   * @param value - the string to append
+   * @param buffer - where to append the string
+   */
+  static void AppendString(const std::string& value, std::string& buffer);
+
+  /**
+   * Appends the shortest decimal that reads back as the given float, or null
+   * if it is not finite.
+   * @param value - the float to append
+   * @param buffer - where to append the float
+   */
+  static void AppendFloat(float value, std::string& buffer);
+};
+
+}  // namespace idealgas
+
+#endif  // IDEAL_GAS_CONTAINER_JSON_WRITER_H
@@ -0,0 +1,168 @@
+//
+// Created by Neil Kaushikkar on 5/31/21.
+//
+
+#ifndef IDEAL_GAS_CONTAINER_SAX_HANDLER_H
+#define IDEAL_GAS_CONTAINER_SAX_HANDLER_H
+
+#include "gas_container.h"
+
+#include <nlohmann/json.hpp>
+
+#include <cstdint>
+#include <istream>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace idealgas {
+
+/**
+ * Builds a GasContainer from the events of nlohmann's SAX parser, so a saved
+ * simulation is read in a single pass without building a json tree of it.
+ * Particles are created as soon as their object closes. It accepts the same
+ * schema as converting a parsed json tree to a GasContainer: keys may come in
+ * any order, unknown keys are skipped, missing vector values are 0, and color
+ * values that are missing or not numbers are 0.
+ */
+class ContainerSaxHandler : public nlohmann::json_sax<nlohmann::json> {
+ public:
+  // How many bytes of a saved simulation are scanned at a time when counting
+  // its particles
+  static constexpr size_t kCountBlockSize = 1 << 16;
+
+  /**
+   * Creates a handler with room for the particles in a saved simulation.
+   * @param particle_capacity - how many particles to reserve room for
+   */
+  explicit ContainerSaxHandler(size_t particle_capacity);
+
+  /**
+   * Counts the particles in a saved simulation without parsing it, by the
+   * type name key that every particle has once. Reads the input to its end.
+   * @param input - the saved simulation
+   * @return the number of particles, or more if a string in the input also
+   * holds the key
+   */
+  static size_t CountParticles(std::istream& input);
+
+  /**
+   * Moves the parsed particles and particle types into a container, and sets
+   * each particle's specs from its type.
+   * @return a GasContainer holding the parsed particles
+   * @throws std::invalid_argument if the particles or types were missing
+   */
+  GasContainer BuildContainer();
+
+  bool null() override;
+  bool boolean(bool value) override;
+  bool number_integer(number_integer_t value) override;
+  bool number_unsigned(number_unsigned_t value) override;
+  bool number_float(number_float_t value, const string_t& text) override;
+  bool string(string_t& value) override;
+  bool binary(binary_t& value) override;
+  bool start_object(std::size_t element_count) override;
+  bool key(string_t& value) override;
+  bool end_object() override;
+  bool start_array(std::size_t element_count) override;
+  bool end_array() override;
+
+  /**
+   * @throws std::invalid_argument with the parser's description of the error
+   */
+  bool parse_error(std::size_t position, const std::string& last_token,
+                   const nlohmann::detail::exception& error) override;
+
+ private:
+  /**
+   * The kinds of json objects and arrays the parser can be inside of.
+   */
+  enum class Scope {
+    kRoot,
+    kParticleList,
+    kParticle,
+    kVector,
+    kSpecificationMap,
+    kSpecification,
+    kColor,
+    // anything under a key that is not part of the schema
+    kSkipped
+  };
+
+  /**
+   * The places in the schema a value can be stored in.
+   */
+  enum class Field {
+    kNone,
+    kParticleList,
+    kParticle,
+    kTypeName,
+    kPosition,
+    kVelocity,
+    kVectorValue,
+    kSpecificationMap,
+    kSpecification,
+    kRadius,
+    kMass,
+    kName,
+    kColor,
+    kColorValue
+  };
+
+  // Mark which required keys the current object has held
+  static constexpr uint8_t kHasTypeName = 1;
+  static constexpr uint8_t kHasPosition = 2;
+  static constexpr uint8_t kHasVelocity = 4;
+  static constexpr uint8_t kHasRadius = 1;
+  static constexpr uint8_t kHasMass = 2;
+  static constexpr uint8_t kHasName = 4;
+  static constexpr uint8_t kHasColor = 8;
+
+  // the objects and arrays the parser is inside of, innermost last
+  std::vector<Scope> scopes_;
+  // the most recent key in the innermost object
+  std::string key_;
+
+  bool has_particle_list_;
+  bool has_specification_map_;
+  std::vector<GasParticle> particles_;
+  std::map<std::string, ParticleSpecs> specifications_;
+
+  // the particle being parsed
+  std::string type_name_;
+  glm::vec2 position_;
+  glm::vec2 velocity_;
+  uint8_t particle_keys_;
+
+  // the vector being parsed, and how many values it has held
+  glm::vec2* vector_;
+  size_t vector_value_count_;
+
+  // the particle type being parsed, and its key in the map of types
+  std::string specification_key_;
+  ParticleSpecs specs_;
+  uint8_t specification_keys_;
+
+  /**
+   * Finds where the next value belongs, from the innermost scope and key.
+   * @return the Field the next value is stored in, or kNone if it is skipped
+   */
+  Field FindCurrentField() const;
+
+  /**
+   * Stores a number in the field it belongs to.
+   * @param value - the number to store
+   * @throws std::invalid_argument if the field does not hold a number
+   */
+  bool Number(double value);
+
+  /**
+   * Handles a value of a type that no field holds, other than colors.
+   * @throws std::invalid_argument if the value is not skipped
+   */
+  bool UnexpectedValue();
+};
+
+}  // namespace idealgas
+
+#endif  // IDEAL_GAS_CONTAINER_SAX_HANDLER_H
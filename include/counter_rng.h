@@ -0,0 +1,68 @@
+//
+// Created by Neil Kaushikkar on 6/2/21.
+//
+
+#ifndef IDEAL_GAS_COUNTER_RNG_H
+#define IDEAL_GAS_COUNTER_RNG_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace idealgas {
+
+/**
+ * A counter-based random number generator built on Philox4x32-10. Every
+ * number it draws is a pure function of its seed, stream, index, and how many
+ * numbers came before it, so a generator can be created for any index on any
+ * thread and always draws the same numbers.
+ */
+class CounterRng {
+ public:
+  // How many 32-bit numbers each round of Philox produces
+  static constexpr size_t kBlockSize = 4;
+
+  typedef std::array<uint32_t, kBlockSize> Counter;
+  typedef std::array<uint32_t, 2> Key;
+
+  /**
+   * Creates a generator for a single item, such as a particle.
+   * @param seed - the seed shared by every generator of a run
+   * @param stream - which group the item belongs to, such as its species
+   * @param index - the index of the item within its group
+   */
+  CounterRng(uint64_t seed, uint32_t stream, uint64_t index);
+
+  /**
+   * Draws the next 32 random bits.
+   * @return a uniformly distributed uint32_t
+   */
+  uint32_t NextUint();
+
+  /**
+   * Draws a float uniformly from [min_value, max_value).
+   * @param min_value - the smallest value that can be drawn
+   * @param max_value - the end of the range of values
+   * @return a uniformly distributed float
+   */
+  float NextFloat(float min_value, float max_value);
+
+  /**
+   * Runs the 10 rounds of Philox4x32 on a counter.
+   * @param counter - the counter to scramble
+   * @param key - the key of the generator
+   * @return 4 random numbers determined by the counter and key
+   */
+  static Counter Philox(Counter counter, Key key);
+
+ private:
+  Counter counter_;
+  Key key_;
+  // the numbers drawn from the current counter, and how many have been used
+  Counter block_;
+  size_t block_position_;
+};
+
+}  // namespace idealgas
+
+#endif  // IDEAL_GAS_COUNTER_RNG_H
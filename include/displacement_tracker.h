@@ -0,0 +1,118 @@
+//
+// Created by Neil Kaushikkar on 5/20/21.
+//
+
+#ifndef IDEAL_GAS_DISPLACEMENT_TRACKER_H
+#define IDEAL_GAS_DISPLACEMENT_TRACKER_H
+
+#include "gas_container.h"
+
+#include <string>
+#include <vector>
+
+namespace idealgas {
+
+/**
+ * Streams the mean squared displacement MSD(t) of each particle type from the
+ * particles' unwrapped displacements, and estimates diffusion coefficients
+ * from it while the simulation runs.
+ *
+ * A new time origin is taken every origin_interval frames, and every origin is
+ * compared against the current frame only at lags that are powers of 2, up to
+ * max_lag. Origins are dropped once they are older than max_lag, so memory is
+ * bounded by (max_lag / origin_interval + 1) copies of the displacements.
+ */
+class DisplacementTracker {
+ public:
+  /**
+   * Creates an empty tracker.
+   * @param max_lag - the largest lag, in frames, to measure MSD at
+   * @param origin_interval - how many frames to wait between time origins
+   * @throws std::invalid_argument if either parameter is 0
+   */
+  DisplacementTracker(size_t max_lag, size_t origin_interval);
+
+  /**
+   * Called once per frame to record the particles' unwrapped displacements.
+   * @param container - the container to measure
+   */
+  void Record(const GasContainer& container);
+
+  /**
+   * Discards every measurement and time origin, starting over from the next
+   * recorded frame.
+   */
+  void Reset();
+
+  /**
+   * Getter for the lags that MSD is measured at.
+   * @return a vector of lags in frames, in increasing order
+   */
+  const std::vector<size_t>& GetLags() const;
+
+  /**
+   * Computes the mean squared displacement of a particle type at each lag.
+   * @param type_name - the name of the particle type
+   * @return a vector with MSD for each lag, or 0 for lags not yet measured
+   */
+  std::vector<double> GetMeanSquaredDisplacement(
+      const std::string& type_name) const;
+
+  /**
+   * Estimates the diffusion coefficient of a particle type from the slope of
+   * MSD at the 2 largest lags measured so far, using MSD = 4Dt in 2D. Small
+   * lags are ballistic rather than diffusive, so the largest lags are used.
+   * @param type_name - the name of the particle type
+   * @return the diffusion coefficient, or 0 if no lags have been measured
+   */
+  double GetDiffusionCoefficient(const std::string& type_name) const;
+
+ private:
+  /**
+   * The displacements of every particle at the start of a time window.
+   */
+  struct TimeOrigin {
+    size_t frame;
+    // the index into lags_ of the next lag to measure this origin at
+    size_t next_lag_idx;
+    bool is_active;
+    std::vector<glm::vec2> displacements;
+  };
+
+  size_t origin_interval_;
+  size_t frames_seen_;
+
+  std::vector<size_t> lags_;
+  // a fixed pool of origins, reused as old origins are dropped
+  std::vector<TimeOrigin> origins_;
+
+  std::vector<std::string> type_names_;
+  // the index into type_names_ of each particle in the container
+  std::vector<size_t> particle_types_;
+
+  // the summed squared displacements and how many were summed, indexed by
+  // particle type and then lag
+  std::vector<double> squared_displacement_sums_;
+  std::vector<size_t> squared_displacement_counts_;
+
+  /**
+   * Records the type of each particle in the container, and restarts the
+   * tracker when the particles change.
+   * @param container - the container being measured
+   */
+  void IndexParticleTypes(const GasContainer& container);
+
+  /**
+   * Adds the squared displacement of every particle since an origin to the
+   * sums for the given lag.
+   * @param particles - the particles in the container
+   * @param origin - the origin to measure from
+   * @param lag_idx - the index into lags_ of the lag being measured
+   */
+  void AccumulateLag(const std::vector<GasParticle>& particles,
+                     const TimeOrigin& origin, size_t lag_idx);
+};
+
+}  // namespace idealgas
+
+#endif  // IDEAL_GAS_DISPLACEMENT_TRACKER_H
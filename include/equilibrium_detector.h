@@ -0,0 +1,126 @@
+//
+// Created by Neil Kaushikkar on 5/23/21.
+//
+
+#ifndef IDEAL_GAS_EQUILIBRIUM_DETECTOR_H
+#define IDEAL_GAS_EQUILIBRIUM_DETECTOR_H
+
+#include "gas_container.h"
+#include "histogram.h"
+
+#include <string>
+#include <vector>
+
+namespace idealgas {
+
+/**
+ * Decides when the speeds of each particle type have relaxed to the 2D
+ * Maxwell-Boltzmann distribution for the current temperature.
+ *
+ * Speeds are binned every frame and pooled over a window of frames. At the end
+ * of each window, the KL divergence of the pooled bins from the theoretical
+ * distribution is found for every particle type, and the gas is equilibrated
+ * once the largest divergence has stayed below a threshold for enough windows
+ * in a row.
+ */
+class EquilibriumDetector {
+ public:
+  // The number of bins used for the speeds of each particle type
+  static constexpr size_t kBinCount = 20;
+  // The highest speed binned, as a multiple of the most probable speed
+  static constexpr float kSpeedRangeFactor = 4;
+
+  /**
+   * Creates a detector that has not seen any frames.
+   * @param window_frame_count - the number of frames pooled into each window
+   * @param divergence_threshold - the KL divergence each window must be below
+   * @param required_window_count - how many windows in a row must be below the
+   * threshold before the gas is considered equilibrated
+   * @throws std::invalid_argument if either count is 0
+   */
+  EquilibriumDetector(size_t window_frame_count, double divergence_threshold,
+                      size_t required_window_count);
+
+  /**
+   * Called once per frame, after the container has advanced, to bin the
+   * speeds of the container's particles.
+   * @param container - the container to measure
+   */
+  void Record(const GasContainer& container);
+
+  /**
+   * Discards the current window and every window that has been evaluated.
+   */
+  void Reset();
+
+  /**
+   * Checks whether enough windows in a row were below the threshold.
+   * @return a bool indicating whether the gas is in equilibrium
+   */
+  bool IsEquilibrated() const;
+
+  /**
+   * Getter for the divergence of the most recently completed window.
+   * @return the largest KL divergence of any particle type in the last window,
+   * or infinity if no window has been completed
+   */
+  double GetLatestDivergence() const;
+
+  /**
+   * Getter for the number of windows in a row that were below the threshold.
+   * @return the number of consecutive windows below the threshold
+   */
+  size_t GetConsecutiveWindowCount() const;
+
+ private:
+  /**
+   * The speed bins of a single particle type.
+   */
+  struct SpeciesDistribution {
+    std::string type_name;
+    float mass;
+    Histogram histogram;
+    // the bins of every frame in the current window, summed
+    std::vector<double> window_bins;
+  };
+
+  size_t window_frame_count_;
+  double divergence_threshold_;
+  size_t required_window_count_;
+
+  size_t particle_count_;
+  std::vector<SpeciesDistribution> species_;
+
+  size_t window_frames_seen_;
+  double window_temperature_sum_;
+
+  double latest_divergence_;
+  size_t consecutive_window_count_;
+
+  /**
+   * Creates the speed bins of each particle type, fitting each histogram's
+   * range to the speeds expected at the given temperature.
+   * @param container - the container being measured
+   * @param temperature - the current kinetic temperature of the container
+   */
+  void IndexSpecies(const GasContainer& container, float temperature);
+
+  /**
+   * Computes the KL divergence of a particle type's pooled bins from the 2D
+   * Maxwell-Boltzmann speed distribution, restricted to the binned range.
+   * @param species - the bins of the particle type
+   * @param temperature - the average kinetic temperature over the window
+   * @return the KL divergence of the observed bins from the expected bins
+   */
+  double ComputeDivergence(const SpeciesDistribution& species,
+                           double temperature) const;
+
+  /**
+   * Evaluates the window that was just completed and starts a new one.
+   */
+  void CompleteWindow();
+};
+
+}  // namespace idealgas
+
+#endif  // IDEAL_GAS_EQUILIBRIUM_DETECTOR_H
@@ -0,0 +1,126 @@
+//
+// Created by Neil Kaushikkar on 6/4/21.
+//
+
+#ifndef IDEAL_GAS_EQUILIBRIUM_LIBRARY_H
+#define IDEAL_GAS_EQUILIBRIUM_LIBRARY_H
+
+#include "gas_container.h"
+#include "save_worker.h"
+#include "snapshot_manager.h"
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace idealgas {
+
+/**
+ * Stores equilibrated states of generated scenarios in a directory, so later
+ * runs of the same scenario can start from equilibrium instead of relaxing
+ * from their random starting velocities. Each state is a snapshot named by
+ * the hash of its scenario. States are written on a background SaveWorker,
+ * so storing one never holds up the simulation.
+ */
+class EquilibriumLibrary {
+ public:
+  // What is appended to a scenario's hash to name its state's file
+  static const std::string kStateFileSuffix;
+  // Changes whenever what goes into a scenario's hash changes
+  static constexpr uint32_t kHashVersion = 1;
+
+  /**
+   * Creates a library for the states of a single scenario.
+   * @param directory_path - the directory the states are stored in, which is
+   * created when the first state is stored
+   * @param scenario_hash - the hash of the scenario, from HashScenario
+   */
+  EquilibriumLibrary(const std::string& directory_path,
+                     uint64_t scenario_hash);
+
+  EquilibriumLibrary(const EquilibriumLibrary&) = delete;
+  EquilibriumLibrary& operator=(const EquilibriumLibrary&) = delete;
+
+  /**
+   * Checks whether a state of the scenario has been stored.
+   * @return a bool indicating whether the state's file exists
+   */
+  bool HasState() const;
+
+  /**
+   * Loads the stored state of the scenario.
+   * @return a GasContainer holding the equilibrated particles
+   * @throws std::invalid_argument if no valid state is stored
+   */
+  GasContainer LoadState() const;
+
+  /**
+   * Starts storing an equilibrated state of the scenario, replacing any
+   * earlier one. The particles are copied, then written on the background
+   * I/O thread through a temporary file that is moved into place.
+   * @param container - the equilibrated container
+   * @param on_complete - called on the I/O thread with whether the state was
+   * stored, or empty for no call
+   */
+  void StoreState(const GasContainer& container,
+                  const SaveWorker::CompletionCallback& on_complete =
+                      SaveWorker::CompletionCallback());
+
+  /**
+   * Getter for the state of the stores started so far.
+   * @return kSaving while a state is being written, and otherwise the result
+   * of the most recent store
+   */
+  SaveStatus GetStoreStatus() const;
+
+  /**
+   * Blocks until every started store has finished.
+   */
+  void WaitForStores();
+
+  /**
+   * Finds the path of the scenario's state.
+   * @return the path the state is stored at
+   */
+  std::string FindStatePath() const;
+
+  /**
+   * Hashes the parts of a generated scenario that decide its equilibrium: the
+   * specs of each particle type that is generated, how many particles of each
+   * type there are, the bounds of the container, and the kinetic energy the
+   * particles are expected to start with. The hash doesn't depend on the
+   * order of the particle counts, on how counts of the same type are split
+   * up, on colors, or on types that no particles are generated from.
+   * @param particle_specifications - the specs of each particle type
+   * @param container_specifications - how many particles of each type to
+   * generate and their maximum starting velocity
+   * @return a 64-bit FNV-1a hash of the scenario
+   * @throws std::out_of_range if a count names a type with no specs
+   */
+  static uint64_t HashScenario(
+      const std::map<std::string, ParticleSpecs>& particle_specifications,
+      const std::vector<ContainerSpecifications>& container_specifications);
+
+  /**
+   * Draws new velocities for every particle from the Maxwell-Boltzmann
+   * distribution at the container's temperature, then scales them so the
+   * total kinetic energy stays the same. Positions are kept.
+   * @param container - the container whose velocities to redraw
+   * @param seed - the seed of the random numbers drawn
+   * @return a copy of the container with the new velocities
+   */
+  static GasContainer RandomizeVelocities(const GasContainer& container,
+                                          uint64_t seed);
+
+ private:
+  std::string directory_path_;
+  uint64_t scenario_hash_;
+  SnapshotManager snapshot_manager_;
+  // writes the states, and finishes any that are queued when destroyed
+  SaveWorker save_worker_;
+};
+
+}  // namespace idealgas
+
+#endif  // IDEAL_GAS_EQUILIBRIUM_LIBRARY_H
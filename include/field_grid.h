@@ -0,0 +1,149 @@
+//
+// Created by Neil Kaushikkar on 5/24/21.
+//
+
+#ifndef IDEAL_GAS_FIELD_GRID_H
+#define IDEAL_GAS_FIELD_GRID_H
+
+#include "gas_container.h"
+#include "parallel_for.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace idealgas {
+
+/**
+ * Deposits the particles onto a grid of cells covering the container's walls
+ * to find the coarse-grained number density, mean velocity, and temperature of
+ * each cell. Particles are split between worker threads that each deposit into
+ * their own grid, and the grids are then summed in parallel cell by cell.
+ *
+ * When time averaging, the mass, momentum, and energy of each cell are summed
+ * over every deposit until the grid is reset, so the fields describe the gas
+ * over that whole stretch of time rather than a single frame.
+ */
+class FieldGrid {
+ public:
+  // Identifies binary field dumps, followed by the format version
+  static const char kFileSignature[4];
+  static constexpr uint32_t kFileVersion = 1;
+
+  /**
+   * Creates an empty grid.
+   * @param column_count - the number of cells across the container
+   * @param row_count - the number of cells down the container
+   * @param deposit_interval - how many frames to wait between deposits
+   * @param is_time_averaged - whether to average the fields over every deposit
+   * since the last reset, or only show the latest deposit
+   * @param worker_count - the number of threads to deposit particles with
+   * @throws std::invalid_argument if any of the counts are 0
+   */
+  FieldGrid(size_t column_count, size_t row_count, size_t deposit_interval,
+            bool is_time_averaged,
+            size_t worker_count = GetDefaultWorkerCount());
+
+  /**
+   * Called once per frame. Every deposit_interval frames, deposits the
+   * container's particles onto the grid and updates the fields. Particles
+   * whose positions aren't finite are left out.
+   * @param container - the container to deposit
+   */
+  void Deposit(const GasContainer& container);
+
+  /**
+   * Discards every deposit made so far.
+   */
+  void Reset();
+
+  size_t GetColumnCount() const;
+
+  size_t GetRowCount() const;
+
+  /**
+   * Getter for the number of deposits the fields are averaged over.
+   * @return the number of deposits since the last reset, or at most 1 if the
+   * fields are not time averaged
+   */
+  size_t GetDepositCount() const;
+
+  /**
+   * Getter for the number of particles per unit area in each cell.
+   * @return a vector of densities, indexed by row * column_count + column
+   */
+  const std::vector<float>& GetDensity() const;
+
+  /**
+   * Getter for the mass-weighted mean velocity of the particles in each cell.
+   * @return a vector of velocities, indexed by row * column_count + column
+   */
+  const std::vector<glm::vec2>& GetVelocity() const;
+
+  /**
+   * Getter for the kinetic temperature of each cell, measured from particle
+   * velocities relative to the cell's mean velocity.
+   * @return a vector of temperatures, indexed by row * column_count + column
+   */
+  const std::vector<float>& GetTemperature() const;
+
+  /**
+   * Writes the fields to a binary file. The file holds the signature and
+   * version, the column and row counts, the corners of the region covered, and
+   * the deposit count, followed by the density, velocity, and temperature
+   * arrays as 32-bit floats in row-major order.
+   * @param file_path - the path of the file to write the fields to
+   * @throws std::invalid_argument if the file can't be opened
+   */
+  void WriteFields(const std::string& file_path) const;
+
+ private:
+  /**
+   * The sums over the particles deposited into a single cell.
+   */
+  struct CellMoments {
+    double particle_count;
+    double mass;
+    double momentum_x;
+    double momentum_y;
+    // the sum of m|v|^2, which is twice the kinetic energy
+    double twice_kinetic_energy;
+  };
+
+  size_t column_count_;
+  size_t row_count_;
+  size_t deposit_interval_;
+  bool is_time_averaged_;
+  size_t worker_count_;
+
+  size_t frames_seen_;
+  size_t deposit_count_;
+  // the region covered by the latest deposit
+  ci::Rectf region_;
+
+  std::vector<CellMoments> moments_;
+  // each worker's private grid, which is cleared as it is summed into moments_
+  std::vector<std::vector<CellMoments>> worker_moments_;
+
+  std::vector<float> density_;
+  std::vector<glm::vec2> velocity_;
+  std::vector<float> temperature_;
+
+  /**
+   * Finds the cell that a position falls in, clamped to the grid. A NaN
+   * coordinate is clamped to the first row or column.
+   * @param position - the position to find the cell of
+   * @return the index of the cell, which is row * column_count + column
+   */
+  size_t FindCell(const glm::vec2& position) const;
+
+  /**
+   * Computes the density, velocity, and temperature of every cell from the
+   * moments deposited so far.
+   */
+  void ComputeFields();
+};
+
+}  // namespace idealgas
+
+#endif  // IDEAL_GAS_FIELD_GRID_H
@@ -0,0 +1,52 @@
+//
+// Created by Neil Kaushikkar on 5/15/21.
+//
+
+#ifndef IDEAL_GAS_FRAME_OBSERVABLES_H
+#define IDEAL_GAS_FRAME_OBSERVABLES_H
+
+#include <glm/vec2.hpp>
+
+#include <array>
+#include <cstddef>
+
+namespace idealgas {
+
+/**
+ * Identifies each of the walls of the container.
+ */
+enum ContainerWall : size_t {
+  kUpperWall = 0,
+  kLowerWall,
+  kLeftWall,
+  kRightWall,
+  kWallCount
+};
+
+/**
+ * The thermodynamic state of a container after a single frame. These values
+ * are accumulated during the passes the container already makes over its
+ * particles each frame, so they cost almost nothing to keep up to date.
+ */
+struct FrameObservables {
+  // the number of frames the container has advanced through
+  size_t frame = 0;
+  size_t particle_count = 0;
+
+  float kinetic_energy = 0;
+  glm::vec2 momentum = glm::vec2(0, 0);
+
+  // the kinetic temperature in 2D with a Boltzmann constant of 1: KE / N
+  float temperature = 0;
+
+  // the impulse transferred to each wall this frame, indexed by ContainerWall
+  std::array<float, kWallCount> wall_impulses = {{0, 0, 0, 0}};
+  // the force per unit length on each wall this frame
+  std::array<float, kWallCount> wall_pressures = {{0, 0, 0, 0}};
+  // the force per unit length averaged over the whole perimeter this frame
+  float pressure = 0;
+};
+
+}  // namespace idealgas
+
+#endif  // IDEAL_GAS_FRAME_OBSERVABLES_H
@@ -2,7 +2,12 @@
 #define IDEAL_GAS_GAS_CONTAINER_H
 
 #include "cinder/gl/gl.h"
+#include "collision_event.h"
+#include "collision_statistics.h"
+#include "frame_observables.h"
 #include "gas_particle.h"
+#include "particle_view.h"
+#include "spatial_index.h"
 #include <string>
 #include <map>
 
@@ -43,12 +48,13 @@ class GasContainer {
 
   /**
    * Initializes a GasContainer and populates it with the particles given in the
-   * provided vector of GasParticles.
+   * provided vector of GasParticles. Both arguments are taken by value, so
+   * callers that are done with them can move them in without a copy.
    * @param particles - a vector of GasParticle to add to the container
-   * @param specifications
+   * @param specifications - the specs of each particle type, keyed by name
    */
-  GasContainer(const std::vector<GasParticle>& particles,
-               const std::map<std::string, ParticleSpecs>& specifications);
+  GasContainer(std::vector<GasParticle> particles,
+               std::map<std::string, ParticleSpecs> specifications);
 
   void Configure();
 
@@ -69,6 +75,72 @@ class GasContainer {
    */
   std::vector<GasParticle> GetAllParticles() const;
 
+  /**
+   * Read-only access to the particles in this container. Unlike
+   * GetAllParticles, this does not copy any particles, so observers may call it
+   * every frame without allocating.
+   * @return a const reference to the GasParticles in this GasContainer
+   */
+  const std::vector<GasParticle>& GetParticles() const;
+
+  /**
+   * Read-only view of all the particles of a single type in this container.
+   * @param type_name - the name of the particle type to view
+   * @return a ParticleView over the particles of that type, which is empty if
+   * there are no particles of that type
+   */
+  ParticleView GetParticlesOfType(const std::string& type_name) const;
+
+  /**
+   * Finds the names of the particle types that have particles in this
+   * container, in alphabetical order.
+   * @return a vector of particle type names
+   */
+  std::vector<std::string> GetParticleTypeNames() const;
+
+  /**
+   * Getter for the region enclosed by the walls of this container.
+   * @return a Rectf with the corners of the container's walls
+   */
+  const ci::Rectf& GetWallBound() const;
+
+  /**
+   * Getter for the specs of each particle type, keyed by particle type name.
+   * @return a const reference to the map of particle specs
+   */
+  const std::map<std::string, ParticleSpecs>& GetParticleSpecifications() const;
+
+  /**
+   * Getter for a spatial index over the particles in the current frame. The
+   * index is built on the first call after the particles move, so frames that
+   * are never queried cost nothing. Not safe to call from several threads at
+   * once until the index has been built for the frame.
+   * @return a const reference to a SpatialIndex of the current frame
+   */
+  const SpatialIndex& GetSpatialIndex() const;
+
+  /**
+   * Getter for the energy, momentum, temperature, and wall pressures measured
+   * during the most recent call to AdvanceOneFrame.
+   * @return a FrameObservables record describing the latest frame
+   */
+  const FrameObservables& GetObservables() const;
+
+  /**
+   * Getter for the collision counts and free paths of each particle type,
+   * accumulated over every frame this container has advanced through.
+   * @return the CollisionStatistics of this container
+   */
+  const CollisionStatistics& GetCollisionStatistics() const;
+
+  /**
+   * Publishes a CollisionEvent to the given stream for every particle and wall
+   * collision from now on. The container does not own the stream, which must
+   * outlive it or be detached first.
+   * @param stream - the stream to publish to, or nullptr to stop publishing
+   */
+  void SetCollisionEventStream(CollisionEventStream* stream);
+
   /**
    * Find each of the unique particle types by comparing all of the particles in
    * this container for same mass, radius, and color (NOT velocity or position).
@@ -83,12 +155,63 @@ class GasContainer {
 
   std::map<std::string, ParticleSpecs> particle_specifications_;
 
+  // the indices into all_particles_ of each particle, grouped by type name
+  std::map<std::string, std::vector<size_t>> particle_indices_by_type_;
+
+  // the index of each particle's type into the sorted particle type names
+  std::vector<size_t> particle_type_ids_;
+  // the distance each particle has travelled since it last hit a particle
+  std::vector<float> path_lengths_since_collision_;
+
+  // the observables accumulated while advancing the most recent frame
+  FrameObservables observables_;
+
+  // the collisions during the current frame, merged into the totals after it
+  CollisionStatistics frame_collision_tally_;
+  CollisionStatistics collision_statistics_;
+
+  // built lazily by GetSpatialIndex and invalidated whenever particles move
+  mutable SpatialIndex spatial_index_;
+  mutable bool is_spatial_index_current_ = false;
+
+  // where to publish collision events, which is only set when opted into
+  CollisionEventStream* collision_event_stream_ = nullptr;
+
   ci::Color wall_color_;
   ci::Rectf wall_bound_;
 
+  /**
+   * Groups the indices of the particles in this container by particle type so
+   * that each type can be scanned without searching all of the particles.
+   * Also restarts the collision statistics for the new set of types.
+   */
+  void IndexParticlesByType();
+
+  /**
+   * Counts a collision between 2 particles in the current frame's tally, and
+   * records how far each particle travelled since its last collision.
+   * @param particle_one_idx - the index of the 1st particle
+   * @param particle_two_idx - the index of the 2nd particle
+   */
+  void RecordParticleCollision(size_t particle_one_idx,
+                               size_t particle_two_idx);
+
+  /**
+   * Publishes a collision to the collision event stream, if there is one.
+   * @param kind - whether the collision was with a particle or a wall
+   * @param particle_id - the index of the (1st) particle
+   * @param other_id - the index of the 2nd particle, or the wall that was hit
+   * @param impulse - the momentum transferred to the (1st) particle
+   * @param position - where the collision happened
+   */
+  void PublishCollisionEvent(CollisionEventKind kind, size_t particle_id,
+                             size_t other_id, float impulse,
+                             const glm::vec2& position) const;
+
   /**
    * Handles the logic of all particle interactions with walls and adjusts
-   * particle velocities according to the laws of physics.
+   * particle velocities according to the laws of physics. The impulse of each
+   * bounce is added to the wall impulses of the current frame's observables.
    */
   void HandleParticleWallInteractions();
 
@@ -98,20 +221,6 @@ class GasContainer {
    */
   void HandleMultiParticleInteractions();
 
-  /**
-   * Calculates the velocity of a particle depending on which walls the particle
-   * is moving towards and is touching or overlapping.
-   * @param particle - the particle to calculate velocity for
-   * @param is_collision_at_vertical_wall - a bool indicating whether the
-   * particle has collided with a vertical wall
-   * @param is_collision_at_horizontal_wall - a bool indicating whether the
-   * particle has collided with a horizontal wall
-   * @return a vec2 indicating the new velocity if a particle hit a wall
-   */
-  static glm::vec2 CalculateParticleVelocityAfterWallCollision(
-      const GasParticle& particle, bool is_collision_at_vertical_wall,
-      bool is_collision_at_horizontal_wall);
-
   /**
    * Checks whether a particle is colliding with any walls parallel to those
    * given by the specified axis index and the specified wall bounds.
@@ -128,6 +237,14 @@ class GasContainer {
       const GasParticle& particle, size_t axis_idx,
       float min_wall_bound, float max_wall_bound);
 
+  /**
+   * Completes the current frame's observables from the totals accumulated
+   * while advancing the particles' positions.
+   * @param kinetic_energy - the total kinetic energy of all of the particles
+   * @param momentum - the total momentum of all of the particles
+   */
+  void RecordFrameObservables(double kinetic_energy, const glm::vec2& momentum);
+
   /**
    * Checks whether two particles are colliding - whether they are touching or
    * overlapping AND whether they are moving towards each other to collide.
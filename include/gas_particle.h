@@ -70,12 +70,28 @@ class GasParticle {
 
   /**
    * Increment's this particle's position after 1 unit of time using the
-   * particle's current velocity vec2.
+   * particle's current velocity vec2. Also advances the unwrapped displacement.
    */
   void UpdatePosition();
 
+  /**
+   * Bounces this particle off of a wall by reversing the component of its
+   * velocity along the given axis.
+   * @param axis_index - the axis perpendicular to the wall that was hit
+   */
+  void ReflectOffWall(size_t axis_index);
+
   void SetVelocity(const glm::vec2& new_velocity);
 
+  /**
+   * Getter for how far this particle has moved since it was created, as if the
+   * walls were mirrors the particle passed through instead of bouncing off of.
+   * Unlike the position, this keeps growing as the particle diffuses, so it
+   * can be used to measure diffusion in a container of any size.
+   * @return a vec2 with the particle's unwrapped displacement
+   */
+  const glm::vec2& GetUnwrappedDisplacement() const;
+
   const glm::vec2& GetVelocity() const;
 
   const glm::vec2& GetPosition() const;
@@ -86,7 +102,7 @@ class GasParticle {
 
   const ci::Color8u& GetColor() const;
 
-  std::string GetTypeName() const;
+  const std::string& GetTypeName() const;
 
   ParticleSpecs GetParticleTypeDetails() const;
 
@@ -96,6 +112,11 @@ class GasParticle {
   // The particle's current velocity
   glm::vec2 velocity_;
 
+  // The displacement of this particle with wall bounces unfolded
+  glm::vec2 unwrapped_displacement_ = glm::vec2(0, 0);
+  // Whether each axis has been mirrored by an odd number of wall bounces (-1)
+  glm::vec2 unwrapped_axis_signs_ = glm::vec2(1, 1);
+
   float radius_;
   float mass_;
   ci::Color8u color_;
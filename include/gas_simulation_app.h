@@ -4,7 +4,13 @@
 #include "Cinder/app/RendererGl.h"
 #include "Cinder/gl/gl.h"
 #include "gas_container.h"
+#include "replay_engine.h"
 #include "simulation_engine.h"
+#include "simulation_runner.h"
+
+#include <future>
+#include <memory>
+#include <string>
 
 namespace idealgas {
 
@@ -13,18 +19,27 @@ namespace idealgas {
  */
 class IdealGasApp : public ci::app::App {
  public:
+  // Steps the simulation on its own thread
+  typedef SimulationRunner<SimulationEngine> EngineRunner;
+
   /**
-   * Creates a simulation.
+   * Opens the window and starts loading the simulation on a worker thread, so
+   * the window comes up before the simulation is ready.
    */
   IdealGasApp();
 
   /**
-   * Draws the current state of the simulation.
+   * Draws the latest completed step of the simulation, or the current frame
+   * of the replay if one is being played, or a loading message until the
+   * simulation is ready.
    */
   void draw() override;
 
   /**
-   * Advances the simulation 1 unit of time forward.
+   * Swaps in the simulation and starts running it once it finishes loading.
+   * Then moves the replay along while one is being played, and reports when
+   * a save that was running in the background finishes. The simulation steps
+   * on its own thread, so a slow frame here doesn't slow it down.
    */
   void update() override;
 
@@ -40,11 +55,97 @@ class IdealGasApp : public ci::app::App {
 
   const int kMargin = 100;
 
+  // Shown in the middle of the window while the simulation is loading
+  static const char* kLoadingMessage;
+
   static constexpr char kSaveToJsonKey = 's';
+  static constexpr char kSaveToSnapshotKey = 'b';
+  static constexpr char kRecordTrajectoryKey = 't';
+
+  // Control how fast the simulation steps and how it is drawn
+  static constexpr char kStepFasterKey = ']';
+  static constexpr char kStepSlowerKey = '[';
+  static constexpr char kUnlimitedStepRateKey = 'u';
+  static constexpr char kInterpolationKey = 'i';
+
+  // Control the replay of the recorded trajectory
+  static constexpr char kReplayKey = 'p';
+  static constexpr char kPlayPauseKey = ' ';
+  static constexpr char kReverseKey = 'r';
+  static constexpr char kSpeedUpKey = '=';
+  static constexpr char kSlowDownKey = '-';
+  static constexpr char kStepBackKey = ',';
+  static constexpr char kStepForwardKey = '.';
+  static constexpr char kSeekToStartKey = '0';
+
+  // How finely positions are recorded and how often keyframes are written
+  static constexpr double kTrajectoryPrecision = 0.01;
+  static constexpr size_t kTrajectoryKeyframeInterval = 100;
+  // How much each speed key changes the replay speed by
+  static constexpr double kReplaySpeedFactor = 2;
+  // How many steps the simulation runs each second when it starts, which is
+  // about the rate the window is drawn at
+  static constexpr double kDefaultStepRate = 60;
+  // How much each step rate key changes the simulation's step rate by
+  static constexpr double kStepRateFactor = 2;
 
  private:
-  // Stores the logic that runs the simulation
-  SimulationEngine engine_;
+  // Stores the logic that runs the simulation, which is empty until it loads
+  std::unique_ptr<SimulationEngine> engine_;
+  // steps engine_ on its own thread, and is declared after it so it stops
+  // before the engine is destroyed
+  std::unique_ptr<EngineRunner> runner_;
+  // whether particles are drawn between the last 2 steps of the simulation
+  bool is_interpolated_;
+  // the simulation being loaded on a worker thread, which is only valid until
+  // it is swapped into engine_
+  std::future<std::unique_ptr<SimulationEngine>> engine_loader_;
+  // why the simulation failed to load, or empty if it hasn't failed
+  std::string loading_error_;
+  // plays back the recorded trajectory, which is only open while replaying
+  std::unique_ptr<ReplayEngine> replay_engine_;
+  // the save status last reported, so each finished save is reported once
+  SaveStatus reported_save_status_;
+  // the equilibrium library store status last reported, for the same reason
+  SaveStatus reported_library_store_status_;
+
+  /**
+   * Moves the simulation into engine_ if the worker thread has finished
+   * loading it. The swap happens between frames on the app's thread, so a
+   * frame never sees a partly loaded simulation.
+   */
+  void SwapInLoadedEngine();
+
+  /**
+   * Draws a message in the middle of the window.
+   * @param message - the message to draw
+   */
+  void DrawCenteredMessage(const std::string& message) const;
+
+  /**
+   * Routes a key press to the controls of the simulation's step rate.
+   * @param key - the character of the key that was pressed
+   */
+  void ChangeStepRate(char key);
+
+  /**
+   * Starts recording the simulation to the trajectory file, or stops and
+   * finishes the file if it is already being recorded.
+   */
+  void ToggleTrajectoryRecording();
+
+  /**
+   * Opens the recorded trajectory in place of the running simulation, or
+   * returns to the simulation if it is already being replayed. The
+   * simulation is paused while the trajectory is replayed.
+   */
+  void ToggleReplay();
+
+  /**
+   * Routes a key press to the replay controls.
+   * @param key - the character of the key that was pressed
+   */
+  void HandleReplayKey(char key);
 };
 
 }  // namespace idealgas
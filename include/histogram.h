@@ -26,9 +26,12 @@ class Histogram {
    * @param green - float from 0-1 indicating amount of green to color particle
    * @param blue - a float from 0-1 indicating amount of blue to color particle
    * @param min_value - a float indicating the minimum value of histogram bins
+   * @param quantity_label - a string naming the quantity shown on the x-axis
    */
   Histogram(const std::string& label, size_t bin_count, float single_bin_range,
-            float top_left_x, float top_left_y, const ci::Color8u& color, float min_value=0);
+            float top_left_x, float top_left_y, const ci::Color8u& color,
+            float min_value=0,
+            const std::string& quantity_label=kDefaultQuantityLabel);
 
   /**
    * Draws the histogram's bins, axis ticks, and axis labels.
@@ -43,18 +46,57 @@ class Histogram {
    */
   void UpdateBinDistribution(const std::vector<float>& updated_values);
 
-  std::string GetDataLabel() const;
+  /**
+   * Empties every bin so that the histogram can be refilled one value at a
+   * time with AddValue. When auto-ranging, the range is first refit to the
+   * smallest power-of-two multiple of the configured range that covers the
+   * values seen since the last reset.
+   */
+  void ResetBins();
+
+  /**
+   * Places a single value into the bin it belongs in. The 1st bin starts at the
+   * minimum value, and each bin includes its upper edge. Values outside of the
+   * range of the histogram are ignored unless the histogram is auto-ranging,
+   * in which case the range is widened to include them.
+   * @param value - a float to count in the histogram
+   */
+  void AddValue(float value);
+
+  /**
+   * Turns auto-ranging on or off. An auto-ranging histogram doubles the span of
+   * its bins whenever a value falls outside of its range, merging each pair of
+   * adjacent bins so that the values already counted never need re-scanning.
+   * @param is_auto_ranging - whether the histogram should adjust its range
+   */
+  void SetAutoRanging(bool is_auto_ranging);
+
+  float GetMinimumValue() const;
+
+  float GetSingleBinRange() const;
+
+  const std::string& GetDataLabel() const;
 
   std::vector<size_t> GetBinValues() const;
 
+  /**
+   * Read-only access to the bin counts that does not copy them.
+   * @return a const reference to the number of values in each bin
+   */
+  const std::vector<size_t>& GetBins() const;
+
+  static const std::string kDefaultQuantityLabel;
+
   static constexpr float kDefaultSingleBinRange = 0.5;
-  static constexpr float kDefaultBinCount = 14;
+  static constexpr size_t kDefaultBinCount = 14;
 
   static constexpr float kDefaultGraphHeight = 100;
   static constexpr float kDefaultGraphWidth = 200;
 
  private:
   std::string data_label_;
+  // the name of the quantity being binned, shown on the x-axis
+  std::string quantity_label_;
   ci::Color8u color_;
 
   // the number of values assigned to each bin
@@ -63,6 +105,19 @@ class Histogram {
   // the range of values that belong to the bin
   float single_bin_range_span_;
 
+  // the range the histogram was created with, which auto-ranging grows from
+  float configured_minimum_value_;
+  float configured_single_bin_range_;
+
+  bool is_auto_ranging_;
+  // the extremes of the values added since the bins were last reset
+  bool has_observed_values_;
+  float observed_minimum_value_;
+  float observed_maximum_value_;
+
+  // scratch space for merging bins, kept to avoid allocating while merging
+  std::vector<size_t> merged_bin_values_;
+
   // how wide to display the bin as
   float bin_display_width_;
   // sets how much 1 value pushes the bin height up
@@ -81,7 +136,7 @@ class Histogram {
   static const char* kGraphBoundColor;
 
   // These determine how to display the labels on the x-axis
-  static const std::string kXAxisLabelStart;
+  static const std::string kXAxisLabelDataPrefix;
   static const std::string kXAxisLabelEnd;
   static constexpr float kXAxisLabelPadding = 25;
 
@@ -100,6 +155,22 @@ class Histogram {
 
   static constexpr float kDefaultBinHeightIncrement = 4;
 
+  /**
+   * Doubles the span of the bins until the given value is within the range of
+   * the histogram. The range grows upwards from the minimum value when the
+   * value is too large, and downwards from the maximum when it is too small.
+   * @param value - a float that the range of the histogram must include
+   */
+  void ExpandRangeToInclude(float value);
+
+  /**
+   * Merges each pair of adjacent bins into one bin with twice the span.
+   * @param bin_offset - how many of the current bins fit below the new minimum
+   * value, which is 0 when growing upwards and the bin count when growing
+   * downwards
+   */
+  void MergeAdjacentBins(size_t bin_offset);
+
   /**
    * Draws the boxes that represent each of the bars of the histogram.
    */
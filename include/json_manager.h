@@ -5,8 +5,14 @@
 #ifndef IDEAL_GAS_JSON_MANAGER_H
 #define IDEAL_GAS_JSON_MANAGER_H
 
+#include "container_json_writer.h"
+#include "counter_rng.h"
 #include "gas_container.h"
-#include "cinder/Rand.h"
+#include "parallel_for.h"
+#include "particle_quantity.h"
+#include "poisson_disk_placer.h"
+#include "scenario_cache.h"
+#include "tracer_log.h"
 
 #include <nlohmann/json.hpp>
 
@@ -21,21 +27,69 @@ class JsonManager {
 
   /**
    * Generates a random simulation using the parameters specified in the
-   * random simulation generator json file.
+   * random simulation generator json file. Each particle draws from its own
+   * CounterRng, keyed by the seed, the index of its entry in the particle
+   * counts, and its index in that entry, so the particles are generated in
+   * parallel and the same seed always gives the same container. The seed is
+   * read from the file, and a new one is picked each time if it has none.
+   * Particles are placed uniformly at random, or without overlaps by a
+   * PoissonDiskPlacer if the file's placement is "poisson_disk".
    * @param json_file_path - a string indicating the path load load json from
+   * @param worker_count - the most threads to generate particles on at once
    * @return a randomly generated GasContainer
    */
   GasContainer GenerateRandomContainerFromJson(
-      const std::string& json_file_path) const;
+      const std::string& json_file_path,
+      size_t worker_count = GetDefaultWorkerCount()) const;
 
   /**
    * Generates a simulation using the saved particles states in the saved
-   * simulation generator json file.
+   * simulation generator json file. The file is streamed through a SAX parser
+   * straight into the particles, so no json tree of it is ever built.
    * @param json_file_path - a string indicating the path load load json from
    * @return a GasContainer loaded from the saved json file
+   * @throws std::invalid_argument if the file is not valid json or does not
+   * match the saved simulation schema
    */
   GasContainer LoadContainerFromJson(const std::string& json_file_path) const;
 
+  /**
+   * Loads a saved simulation the same as LoadContainerFromJson, but maps the
+   * binary cache of the file instead of parsing it when the cache is up to
+   * date. Otherwise, the file is parsed and its cache is rebuilt.
+   * @param json_file_path - a string indicating the path load load json from
+   * @return a GasContainer loaded from the saved json file
+   * @throws std::invalid_argument if the file is not valid json or does not
+   * match the saved simulation schema
+   */
+  GasContainer LoadContainerFromCachedJson(
+      const std::string& json_file_path) const;
+
+  /**
+   * Loads the bin configuration of each quantity to show in histograms.
+   * @param json_file_path - a string indicating the path load load json from
+   * @return a vector of HistogramSpecifications, one for each quantity
+   */
+  std::vector<HistogramSpecifications> LoadHistogramSpecificationsFromJson(
+      const std::string& json_file_path) const;
+
+  /**
+   * Loads the selectors picking which particles to log as tracers.
+   * @param json_file_path - a string indicating the path load load json from
+   * @return a vector of TracerSelectors, which is empty if the file does not
+   * list any tracers
+   */
+  std::vector<TracerSelector> LoadTracerSelectorsFromJson(
+      const std::string& json_file_path) const;
+
+  /**
+   * Hashes the scenario of a random simulation generator json file, which is
+   * what EquilibriumLibrary stores the scenario's equilibrated state under.
+   * @param json_file_path - a string indicating the path load load json from
+   * @return the hash of the particle types and counts in the file
+   */
+  uint64_t HashScenarioFromJson(const std::string& json_file_path) const;
+
   /**
    * Ensures that the file corresponding to the provided file path exists.
    * @param file_path - a string indicating the file path
@@ -44,29 +98,42 @@ class JsonManager {
   static void ValidateFilePath(const std::string& file_path);
 
   /**
-   * Saves the current state of the simulation in a json file.
+   * Saves the current state of the simulation in a json file. The particles
+   * are formatted straight into the file, so no json tree of them is built.
+   * @param container - the container to save
+   * @param save_file_path - a string indicating the path to save to
+   * @param layout - whether to indent the json or leave out all whitespace
+   * @throws std::invalid_argument if the file can't be opened or fully written
    */
   void WriteContainerToJson(const GasContainer& container,
-                            const std::string& save_file_path) const;
+                            const std::string& save_file_path,
+                            JsonLayout layout = JsonLayout::kIndented) const;
 
  private:
   // These keys access the subsections of the json: motion and visuals
   static const std::string kJsonSchemaParticleTypesKey;
   static const std::string kJsonSchemaParticleCountsKey;
+  static const std::string kJsonSchemaHistogramsKey;
+  static const std::string kJsonSchemaTracersKey;
+  static const std::string kJsonSchemaSeedKey;
+  static const std::string kJsonSchemaPlacementKey;
+
+  ScenarioCache scenario_cache_;
 
   /**
    * Generates a particle with random velocity, as specified by the max velocity
    * constraint. Initializes the particle according to the specified type key
    * and the corresponding details in the type details json.Places the particle
    * on a random position within the bounds of the GasContainer.
-   * @param random - a ci::Rand reference to use to generate random floats
+   * @param random - the CounterRng of the particle to generate
    * @param max_velocity - the absolute value of the maximum velocity a particle
    *                       can have when starting to move
    * @param specifications -
    * @return a randomly generated GasParticle as specified
    */
   GasParticle GenerateRandomParticle(
-      ci::Rand& random, float max_velo, const ParticleSpecs& specifications) const;
+      CounterRng& random, float max_velo,
+      const ParticleSpecs& specifications) const;
 };
 
 } // namespace idealgas
@@ -0,0 +1,58 @@
+//
+// Created by Neil Kaushikkar on 5/30/21.
+//
+
+#ifndef IDEAL_GAS_MAPPED_FILE_H
+#define IDEAL_GAS_MAPPED_FILE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace idealgas {
+
+/**
+ * A read-only view of every byte in a file. The file is mapped into memory
+ * where mmap is available, so only the pages that are read get loaded, and it
+ * is read into a buffer otherwise.
+ */
+class MappedFile {
+ public:
+  /**
+   * Maps a whole file into memory.
+   * @param file_path - the path of the file to map
+   * @throws std::invalid_argument if the file can't be opened or mapped
+   */
+  explicit MappedFile(const std::string& file_path);
+
+  MappedFile(const MappedFile&) = delete;
+  MappedFile& operator=(const MappedFile&) = delete;
+
+  ~MappedFile();
+
+  const char* GetData() const;
+
+  size_t GetSize() const;
+
+  /**
+   * Checks that a range of bytes lies within a file.
+   * @param offset - where the range starts
+   * @param length - how many bytes are in the range
+   * @param file_size - the size of the file
+   * @return a bool indicating whether the whole range is in the file
+   */
+  static bool IsRangeInFile(uint64_t offset, uint64_t length,
+                            uint64_t file_size);
+
+ private:
+  const char* data_;
+  size_t size_;
+#ifdef _WIN32
+  std::vector<char> buffer_;
+#endif
+};
+
+}  // namespace idealgas
+
+#endif  // IDEAL_GAS_MAPPED_FILE_H
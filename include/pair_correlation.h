@@ -0,0 +1,142 @@
+//
+// Created by Neil Kaushikkar on 5/18/21.
+//
+
+#ifndef IDEAL_GAS_PAIR_CORRELATION_H
+#define IDEAL_GAS_PAIR_CORRELATION_H
+
+#include "cell_list.h"
+#include "gas_container.h"
+#include "parallel_for.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace idealgas {
+
+/**
+ * Accumulates the radial distribution function g(r) of every pair of particle
+ * types, averaged over the frames it samples. Pairs are found with a cell list
+ * whose cells are at least max_radius wide, so each sample only compares
+ * particles in neighbouring cells, and the rows of cells are split between
+ * worker threads that each count into their own bins.
+ *
+ * The container walls are not periodic, so pairs near the walls have fewer
+ * neighbours than in an infinite gas and g(r) reads slightly low as r nears
+ * max_radius. Keep max_radius small compared to the container.
+ */
+class PairCorrelationAccumulator {
+ public:
+  /**
+   * Creates an empty accumulator.
+   * @param max_radius - the largest particle separation to bin
+   * @param bin_count - the number of bins between 0 and max_radius
+   * @param sample_interval - how many frames to wait between samples
+   * @param worker_count - the number of threads to count pairs with
+   * @throws std::invalid_argument if any of the parameters are 0
+   */
+  PairCorrelationAccumulator(float max_radius, size_t bin_count,
+                             size_t sample_interval,
+                             size_t worker_count = GetDefaultWorkerCount());
+
+  /**
+   * Called once per frame. Every sample_interval frames, counts the pairs of
+   * particles in the container at each separation.
+   * @param container - the container to sample
+   */
+  void Sample(const GasContainer& container);
+
+  /**
+   * Discards all of the samples taken so far.
+   */
+  void Reset();
+
+  /**
+   * Computes g(r) for a pair of particle types from the samples so far.
+   * @param type_one - the name of the 1st particle type
+   * @param type_two - the name of the 2nd particle type, which may be the same
+   * @return a vector with g(r) for each bin, which is all zeroes if no samples
+   * have been taken or the types do not exist
+   */
+  std::vector<float> GetPairCorrelation(const std::string& type_one,
+                                        const std::string& type_two) const;
+
+  /**
+   * Finds the separation at the middle of a bin.
+   * @param bin - the index of the bin
+   * @return the radius at the center of that bin
+   */
+  float GetBinRadius(size_t bin) const;
+
+  size_t GetSampleCount() const;
+
+ private:
+  float max_radius_;
+  size_t bin_count_;
+  float bin_width_;
+  size_t sample_interval_;
+  size_t worker_count_;
+
+  size_t frames_seen_;
+  size_t sample_count_;
+
+  CellList cell_list_;
+
+  // the particle types present when sampling started, and how many of each
+  std::vector<std::string> type_names_;
+  std::vector<size_t> type_counts_;
+  // the index into type_names_ of each particle in the container
+  std::vector<size_t> particle_types_;
+
+  // the pair counts of each worker for the current sample, so that workers
+  // never share bins; indexed by type pair, then bin
+  std::vector<std::vector<uint64_t>> worker_pair_counts_;
+  // the pair counts summed over all samples, indexed like the worker counts
+  std::vector<uint64_t> pair_counts_;
+
+  /**
+   * Records the type of each particle in the container. Only runs when the
+   * number of particles changes, since particle types never change.
+   * @param container - the container being sampled
+   */
+  void IndexParticleTypes(const GasContainer& container);
+
+  /**
+   * Finds where the bins of a pair of types start in the pair counts.
+   * @param type_one - the index of the 1st type
+   * @param type_two - the index of the 2nd type
+   * @return the offset of the pair's 1st bin
+   */
+  size_t FindPairOffset(size_t type_one, size_t type_two) const;
+
+  /**
+   * Counts the pairs of particles in which the 1st particle is in the given
+   * rows of cells. Each pair is counted once by only pairing a cell with
+   * itself and the neighbouring cells after it.
+   * @param particles - the particles in the container
+   * @param row_begin - the 1st row of cells to count
+   * @param row_end - the row after the last row of cells to count
+   * @param pair_counts - the bins to add the pairs to
+   */
+  void CountPairsInRows(const std::vector<GasParticle>& particles,
+                        size_t row_begin, size_t row_end,
+                        std::vector<uint64_t>& pair_counts) const;
+
+  /**
+   * Bins every pair made by a particle and the particles in a range.
+   * @param particles - the particles in the container
+   * @param particle_idx - the index of the 1st particle of each pair
+   * @param others_begin - the start of the other particles' indices
+   * @param others_end - the end of the other particles' indices
+   * @param pair_counts - the bins to add the pairs to
+   */
+  void CountPairsWithParticle(const std::vector<GasParticle>& particles,
+                              size_t particle_idx, const size_t* others_begin,
+                              const size_t* others_end,
+                              std::vector<uint64_t>& pair_counts) const;
+};
+
+}  // namespace idealgas
+
+#endif  // IDEAL_GAS_PAIR_CORRELATION_H
@@ -0,0 +1,36 @@
+//
+// Created by Neil Kaushikkar on 5/18/21.
+//
+
+#ifndef IDEAL_GAS_PARALLEL_FOR_H
+#define IDEAL_GAS_PARALLEL_FOR_H
+
+#include <cstddef>
+#include <functional>
+
+namespace idealgas {
+
+/**
+ * Finds how many worker threads to split parallel work between.
+ * @return the number of hardware threads, or 1 if that is unknown
+ */
+size_t GetDefaultWorkerCount();
+
+/**
+ * Splits the range [0, count) into contiguous chunks, one for each worker, and
+ * runs the task on every chunk at the same time. The calling thread works on
+ * the last chunk and returns once all of the chunks are done. If any chunk
+ * throws, the first exception is rethrown on the calling thread.
+ * @param count - the number of items to split between the workers
+ * @param worker_count - the maximum number of chunks to split the items into
+ * @param task - called with the start and end of a chunk and the index of the
+ * worker running it, which is less than worker_count
+ * @throws std::system_error if a worker thread can't be started, once the
+ * workers that did start have finished their chunks
+ */
+void ParallelFor(size_t count, size_t worker_count,
+                 const std::function<void(size_t, size_t, size_t)>& task);
+
+}  // namespace idealgas
+
+#endif  // IDEAL_GAS_PARALLEL_FOR_H
@@ -0,0 +1,70 @@
+//
+// Created by Neil Kaushikkar on 5/16/21.
+//
+
+#ifndef IDEAL_GAS_PARTICLE_QUANTITY_H
+#define IDEAL_GAS_PARTICLE_QUANTITY_H
+
+#include "gas_particle.h"
+
+#include <nlohmann/json.hpp>
+#include <string>
+
+namespace idealgas {
+
+/**
+ * The per-particle quantities whose distributions can be shown in histograms.
+ */
+enum class ParticleQuantity {
+  kSpeed,
+  kKineticEnergy,
+  kVelocityX,
+  kVelocityY,
+  kHeading
+};
+
+void to_json(nlohmann::json& json_value, ParticleQuantity quantity);
+
+/**
+ * Reads a quantity from its name, such as "speed" or "kinetic_energy".
+ * @throws std::invalid_argument if the value doesn't name a quantity
+ */
+void from_json(const nlohmann::json& json_value, ParticleQuantity& quantity);
+
+/**
+ * Describes how to bin a single quantity for every particle type.
+ */
+struct HistogramSpecifications {
+  ParticleQuantity quantity;
+  size_t bin_count;
+  float bin_range;
+  float min_value;
+  // whether to draw the histograms for this quantity or only compute them
+  bool display;
+  // whether to widen the bins when values fall outside of the range above
+  bool auto_range;
+};
+
+NLOHMANN_DEFINE_TYPE_NON_INTRUSIVE(HistogramSpecifications, quantity,
+                                   bin_count, bin_range, min_value, display,
+                                   auto_range)
+
+/**
+ * Measures a quantity of a particle's current state.
+ * @param particle - the particle to measure
+ * @param quantity - the quantity to measure
+ * @return a float with the value of the quantity for the particle
+ */
+float MeasureParticleQuantity(const GasParticle& particle,
+                              ParticleQuantity quantity);
+
+/**
+ * Finds the axis label describing a quantity and its units.
+ * @param quantity - the quantity to describe
+ * @return a string with the name and units of the quantity
+ */
+std::string GetParticleQuantityLabel(ParticleQuantity quantity);
+
+}  // namespace idealgas
+
+#endif  // IDEAL_GAS_PARTICLE_QUANTITY_H
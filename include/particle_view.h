@@ -0,0 +1,90 @@
+//
+// Created by Neil Kaushikkar on 5/14/21.
+//
+
+#ifndef IDEAL_GAS_PARTICLE_VIEW_H
+#define IDEAL_GAS_PARTICLE_VIEW_H
+
+#include "gas_particle.h"
+
+#include <iterator>
+#include <vector>
+
+namespace idealgas {
+
+/**
+ * A read-only, non-owning view over a subset of the particles stored in a
+ * GasContainer. The view only holds references to the container's storage, so
+ * it must not outlive the container it was created from.
+ */
+class ParticleView {
+ public:
+  /**
+   * Iterates over the particles selected by a list of particle indices.
+   */
+  class ConstIterator {
+   public:
+    typedef std::forward_iterator_tag iterator_category;
+    typedef GasParticle value_type;
+    typedef std::ptrdiff_t difference_type;
+    typedef const GasParticle* pointer;
+    typedef const GasParticle& reference;
+
+    ConstIterator(const std::vector<GasParticle>* particles,
+                  std::vector<size_t>::const_iterator index_iterator);
+
+    reference operator*() const;
+
+    pointer operator->() const;
+
+    ConstIterator& operator++();
+
+    ConstIterator operator++(int);
+
+    bool operator==(const ConstIterator& other) const;
+
+    bool operator!=(const ConstIterator& other) const;
+
+   private:
+    const std::vector<GasParticle>* particles_;
+    std::vector<size_t>::const_iterator index_iterator_;
+  };
+
+  /**
+   * Creates a view over the particles at the given indices.
+   * @param particles - the particles stored in a container
+   * @param indices - the indices of the particles to include in this view
+   */
+  ParticleView(const std::vector<GasParticle>& particles,
+               const std::vector<size_t>& indices);
+
+  ConstIterator begin() const;
+
+  ConstIterator end() const;
+
+  size_t size() const;
+
+  bool empty() const;
+
+  /**
+   * Accesses the particle at a position within this view.
+   * @param view_index - the position of the particle within this view
+   * @return a const reference to the particle
+   */
+  const GasParticle& operator[](size_t view_index) const;
+
+  /**
+   * Getter for the indices of the particles in this view, relative to the
+   * particles stored in the container.
+   * @return a vector of indices into the container's particles
+   */
+  const std::vector<size_t>& GetIndices() const;
+
+ private:
+  const std::vector<GasParticle>* particles_;
+  const std::vector<size_t>* indices_;
+};
+
+}  // namespace idealgas
+
+#endif  // IDEAL_GAS_PARTICLE_VIEW_H
@@ -0,0 +1,133 @@
+//
+// Created by Neil Kaushikkar on 6/3/21.
+//
+
+#ifndef IDEAL_GAS_POISSON_DISK_PLACER_H
+#define IDEAL_GAS_POISSON_DISK_PLACER_H
+
+#include "counter_rng.h"
+
+#include "cinder/gl/gl.h"
+#include <nlohmann/json.hpp>
+
+#include <cstdint>
+#include <vector>
+
+namespace idealgas {
+
+/**
+ * How randomly generated particles are placed in the container.
+ */
+enum class PlacementMode {
+  // anywhere in the container, even on top of each other
+  kUniform,
+  // without any overlaps, through PoissonDiskPlacer
+  kPoissonDisk
+};
+
+void to_json(nlohmann::json& json_value, PlacementMode mode);
+
+/**
+ * Reads a placement mode from its name, "uniform" or "poisson_disk".
+ * @throws std::invalid_argument if the value doesn't name a placement mode
+ */
+void from_json(const nlohmann::json& json_value, PlacementMode& mode);
+
+/**
+ * Places particles of different radii in a rectangle so that no two overlap
+ * and none crosses the edges. Particles are placed by Bridson's Poisson-disk
+ * sampling, which grows outwards from placed particles and finds neighbors in
+ * a grid, so it runs in time linear in the number of particles. When
+ * sampling can't fit every particle, they are placed on a shuffled hexagonal
+ * lattice instead.
+ */
+class PoissonDiskPlacer {
+ public:
+  // How many places are tried around a placed particle before giving up on it
+  static constexpr size_t kCandidateCount = 30;
+  // How many random places are tried to restart sampling when it gets stuck
+  static constexpr size_t kRestartAttemptCount = 1000;
+  // The CounterRng stream placement draws from, apart from the streams that
+  // generated particles draw from
+  static constexpr uint32_t kRandomStream = 0xFFFFFFFF;
+
+  /**
+   * Creates a placer for a rectangle.
+   * @param upper_left - the corner of the rectangle with the smallest values
+   * @param lower_right - the corner of the rectangle with the largest values
+   * @param seed - the seed of the random numbers used to place particles
+   */
+  PoissonDiskPlacer(const glm::vec2& upper_left, const glm::vec2& lower_right,
+                    uint64_t seed);
+
+  /**
+   * Finds a position for each particle, with the largest placed first.
+   * @param radii - the radius of each particle
+   * @return the position of each particle, in the same order as the radii
+   * @throws std::invalid_argument if the particles don't fit in the rectangle
+   */
+  std::vector<glm::vec2> Place(const std::vector<float>& radii);
+
+  /**
+   * Finds how much of the rectangle a set of particles would cover.
+   * @param radii - the radius of each particle
+   * @return the total area of the particles over the area of the rectangle
+   */
+  float FindPackingFraction(const std::vector<float>& radii) const;
+
+ private:
+  glm::vec2 upper_left_;
+  glm::vec2 lower_right_;
+  CounterRng random_;
+
+  // the grid of placed particles, with cells as wide as the largest particle
+  float cell_size_;
+  size_t column_count_;
+  size_t row_count_;
+  std::vector<std::vector<size_t>> cells_;
+
+  /**
+   * Places the particles by Poisson-disk sampling.
+   * @param radii - the radius of each particle
+   * @param order - the indices of the particles, in the order to place them
+   * @param positions - set to the position of each placed particle
+   * @return a bool indicating whether every particle was placed
+   */
+  bool PlaceBySampling(const std::vector<float>& radii,
+                       const std::vector<size_t>& order,
+                       std::vector<glm::vec2>& positions);
+
+  /**
+   * Places the particles on the sites of a hexagonal lattice spaced by the
+   * largest particle, in a random order.
+   * @param radii - the radius of each particle
+   * @param positions - set to the position of each particle
+   * @throws std::invalid_argument if the lattice has too few sites
+   */
+  void PlaceOnLattice(const std::vector<float>& radii,
+                      std::vector<glm::vec2>& positions);
+
+  /**
+   * Checks whether a particle could be placed at a position.
+   * @param position - where to place the particle
+   * @param radius - the radius of the particle
+   * @param radii - the radius of each particle
+   * @param positions - the position of each particle
+   * @return a bool indicating whether the particle is inside the rectangle and
+   * clear of every placed particle
+   */
+  bool IsPositionFree(const glm::vec2& position, float radius,
+                      const std::vector<float>& radii,
+                      const std::vector<glm::vec2>& positions) const;
+
+  /**
+   * Finds the grid cell a position is in.
+   * @param position - a position inside the rectangle
+   * @return the index of the cell in cells_
+   */
+  size_t FindCell(const glm::vec2& position) const;
+};
+
+}  // namespace idealgas
+
+#endif  // IDEAL_GAS_POISSON_DISK_PLACER_H
@@ -0,0 +1,207 @@
+//
+// Created by Neil Kaushikkar on 5/22/21.
+//
+
+#ifndef IDEAL_GAS_RECORD_STREAM_H
+#define IDEAL_GAS_RECORD_STREAM_H
+
+#include "spsc_ring_buffer.h"
+
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace idealgas {
+
+/**
+ * What to do when a record is published while the stream's buffer is full.
+ */
+enum class OverflowPolicy {
+  // throw the record away and count it as dropped
+  kDropAndCount,
+  // wait on the publishing thread until the consumer makes space
+  kBlock
+};
+
+/**
+ * Streams fixed-size records from 1 publishing thread to a sink that runs on
+ * a background consumer thread. Records pass through a lock-free ring buffer,
+ * so publishing never allocates or takes a lock.
+ */
+template <typename Record>
+class AsyncRecordStream {
+ public:
+  static_assert(std::is_trivially_copyable<Record>::value,
+                "Records are copied as raw bytes, so must be trivially "
+                "copyable.");
+
+  // Receives each batch of records drained from the buffer, in order
+  typedef std::function<void(const Record*, size_t)> Sink;
+
+  /**
+   * Starts a stream that passes records to a callback.
+   * @param capacity - the fewest records the buffer must hold
+   * @param policy - what to do with records published while the buffer is full
+   * @param sink - called on the consumer thread with each batch of records,
+   * which must not throw
+   */
+  AsyncRecordStream(size_t capacity, OverflowPolicy policy, const Sink& sink)
+      : buffer_(capacity), policy_(policy), sink_(sink), is_closing_(false),
+        is_publishing_(false), is_stopping_(false), published_count_(0),
+        dropped_count_(0) {
+    consumer_ = std::thread(&AsyncRecordStream::DrainUntilClosed, this);
+  }
+
+  /**
+   * Starts a stream that appends the raw bytes of each record to a file.
+   * @param capacity - the fewest records the buffer must hold
+   * @param policy - what to do with records published while the buffer is full
+   * @param file_path - the path of the file to write records to
+   * @throws std::invalid_argument if the file can't be opened
+   */
+  AsyncRecordStream(size_t capacity, OverflowPolicy policy,
+                    const std::string& file_path)
+      : AsyncRecordStream(capacity, policy, MakeFileSink(file_path)) {}
+
+  AsyncRecordStream(const AsyncRecordStream&) = delete;
+  AsyncRecordStream& operator=(const AsyncRecordStream&) = delete;
+
+  ~AsyncRecordStream() {
+    Close();
+  }
+
+  /**
+   * Queues a record for the consumer. Only call from a single thread.
+   * @param record - the record to publish
+   */
+  void Publish(const Record& record) {
+    published_count_.fetch_add(1, std::memory_order_relaxed);
+
+    // Either Close sees this publish and waits for it, or this sees that the
+    // stream is closing and drops the record, since nothing would drain it
+    is_publishing_.store(true);
+    if (is_closing_.load()) {
+      is_publishing_.store(false);
+      dropped_count_.fetch_add(1, std::memory_order_relaxed);
+      return;
+    }
+
+    while (!buffer_.TryPush(record)) {
+      if (policy_ == OverflowPolicy::kDropAndCount) {
+        dropped_count_.fetch_add(1, std::memory_order_relaxed);
+        break;
+      }
+
+      std::this_thread::yield();
+    }
+
+    is_publishing_.store(false, std::memory_order_release);
+  }
+
+  /**
+   * Waits for the consumer to pass every queued record to the sink, then
+   * stops the consumer. A publish already in progress on another thread is
+   * finished and delivered first, and records published after closing are
+   * dropped.
+   */
+  void Close() {
+    if (consumer_.joinable()) {
+      is_closing_.store(true);
+
+      // The consumer keeps draining, so a blocked publish can still finish
+      while (is_publishing_.load()) {
+        std::this_thread::yield();
+      }
+
+      is_stopping_.store(true, std::memory_order_release);
+      consumer_.join();
+    }
+  }
+
+  size_t GetPublishedCount() const {
+    return published_count_.load(std::memory_order_relaxed);
+  }
+
+  size_t GetDroppedCount() const {
+    return dropped_count_.load(std::memory_order_relaxed);
+  }
+
+ private:
+  // How long the consumer sleeps when there is nothing to drain
+  static constexpr std::chrono::milliseconds kIdleWait =
+      std::chrono::milliseconds(1);
+  // The most records passed to the sink at once
+  static constexpr size_t kMaxBatchSize = 1024;
+
+  SpscRingBuffer<Record> buffer_;
+  OverflowPolicy policy_;
+  Sink sink_;
+
+  // set once Close starts, after which records are dropped
+  std::atomic<bool> is_closing_;
+  // set while Publish may still push a record
+  std::atomic<bool> is_publishing_;
+  // set once nothing more will be pushed, so the consumer can stop when empty
+  std::atomic<bool> is_stopping_;
+  std::atomic<size_t> published_count_;
+  std::atomic<size_t> dropped_count_;
+  std::thread consumer_;
+
+  /**
+   * Creates a sink that writes records to a file as raw bytes.
+   * @param file_path - the path of the file to write records to
+   * @return a Sink that writes each batch to the file
+   */
+  static Sink MakeFileSink(const std::string& file_path) {
+    std::shared_ptr<std::ofstream> output_file = std::make_shared<std::ofstream>(
+        file_path, std::ios::binary | std::ios::trunc);
+    if (!output_file->is_open()) {
+      throw std::invalid_argument("The file path is not valid");
+    }
+
+    return [output_file](const Record* records, size_t count) {
+      output_file->write(reinterpret_cast<const char*>(records),
+                         count * sizeof(Record));
+      output_file->flush();
+    };
+  }
+
+  /**
+   * Runs on the consumer thread, passing batches of records to the sink until
+   * the stream is closed and the buffer is empty.
+   */
+  void DrainUntilClosed() {
+    std::vector<Record> batch(kMaxBatchSize);
+
+    while (true) {
+      // Check for stopping before draining so the last records aren't missed
+      bool is_stopping = is_stopping_.load(std::memory_order_acquire);
+      size_t count = buffer_.PopBatch(batch.data(), batch.size());
+
+      if (count > 0) {
+        sink_(batch.data(), count);
+      } else if (is_stopping) {
+        return;
+      } else {
+        std::this_thread::sleep_for(kIdleWait);
+      }
+    }
+  }
+};
+
+template <typename Record>
+constexpr std::chrono::milliseconds AsyncRecordStream<Record>::kIdleWait;
+
+template <typename Record>
+constexpr size_t AsyncRecordStream<Record>::kMaxBatchSize;
+
+}  // namespace idealgas
+
+#endif  // IDEAL_GAS_RECORD_STREAM_H
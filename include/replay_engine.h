@@ -0,0 +1,106 @@
+//
+// Created by Neil Kaushikkar on 5/30/21.
+//
+
+#ifndef IDEAL_GAS_REPLAY_ENGINE_H
+#define IDEAL_GAS_REPLAY_ENGINE_H
+
+#include "trajectory_reader.h"
+
+#include <string>
+#include <vector>
+
+namespace idealgas {
+
+/**
+ * Plays back a recorded trajectory in place of a SimulationEngine. Frames are
+ * read from the trajectory file rather than simulated, so any frame of a long
+ * run can be jumped to and played forwards or backwards at any speed.
+ */
+class ReplayEngine {
+ public:
+  // How far from the walls to draw the playback status
+  static constexpr float kStatusPadding = 20;
+
+  /**
+   * Opens a trajectory and shows its first frame, paused.
+   * @param trajectory_file_path - the path of the trajectory file to play
+   * @throws std::invalid_argument if the file is not a valid trajectory or has
+   * no frames
+   */
+  explicit ReplayEngine(const std::string& trajectory_file_path);
+
+  /**
+   * Moves the playhead by the playback speed while playing, in whichever
+   * direction is set. Playback pauses when it reaches either end.
+   */
+  void AdvanceToNextFrame();
+
+  /**
+   * Displays the container walls, the particles in the current frame, and the
+   * playback status.
+   */
+  void Render() const;
+
+  /**
+   * Jumps to a frame, clamped to the frames in the trajectory.
+   * @param frame - the index of the frame to show
+   */
+  void Seek(size_t frame);
+
+  void Play();
+
+  void Pause();
+
+  /**
+   * Switches between playing forwards and playing backwards.
+   */
+  void Reverse();
+
+  /**
+   * Sets how many frames the playhead moves each update. Speeds below 1 show
+   * each frame for several updates.
+   * @param frames_per_update - the playback speed
+   * @throws std::invalid_argument if the speed is not positive
+   */
+  void SetSpeed(double frames_per_update);
+
+  bool IsPlaying() const;
+
+  bool IsReversed() const;
+
+  double GetSpeed() const;
+
+  size_t GetCurrentFrame() const;
+
+  size_t GetFrameCount() const;
+
+  /**
+   * Getter for the positions of the particles in the current frame.
+   * @return the position of each particle, in the order they were recorded
+   */
+  const std::vector<glm::vec2>& GetPositions() const;
+
+ private:
+  TrajectoryReader reader_;
+  std::vector<glm::vec2> positions_;
+  // the radius and color of each particle, from its type
+  std::vector<float> radii_;
+  std::vector<ci::Color8u> colors_;
+
+  // the frame being played, which is fractional while playing slowly
+  double playhead_;
+  size_t current_frame_;
+  double speed_;
+  bool is_playing_;
+  bool is_reversed_;
+
+  /**
+   * Reads the frame under the playhead if it is not the one already shown.
+   */
+  void ShowPlayheadFrame();
+};
+
+}  // namespace idealgas
+
+#endif  // IDEAL_GAS_REPLAY_ENGINE_H
@@ -0,0 +1,116 @@
+//
+// Created by Neil Kaushikkar on 5/28/21.
+//
+
+#ifndef IDEAL_GAS_SAVE_WORKER_H
+#define IDEAL_GAS_SAVE_WORKER_H
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace idealgas {
+
+/**
+ * The state of the saves handed to a SaveWorker.
+ */
+enum class SaveStatus {
+  // nothing has been saved yet
+  kIdle,
+  // a save is queued or being written
+  kSaving,
+  // the most recent save was written and flushed to disk
+  kSucceeded,
+  // the most recent save could not be written
+  kFailed
+};
+
+/**
+ * Writes files on a background I/O thread, one at a time in the order they
+ * were requested. Each file is written to a temporary file, flushed to disk,
+ * and then renamed over the destination, so a crash during a save never
+ * leaves a partially written file behind.
+ */
+class SaveWorker {
+ public:
+  // Writes the data being saved to the file at the given path
+  typedef std::function<void(const std::string&)> WriteTask;
+  // Called on the I/O thread with whether the save succeeded
+  typedef std::function<void(bool)> CompletionCallback;
+
+  // Appended to the destination path to name the temporary file
+  static const std::string kTemporaryFileSuffix;
+
+  SaveWorker();
+
+  SaveWorker(const SaveWorker&) = delete;
+  SaveWorker& operator=(const SaveWorker&) = delete;
+
+  /**
+   * Finishes every queued save before stopping the I/O thread.
+   */
+  ~SaveWorker();
+
+  /**
+   * Queues a save. The write task must only use data it owns, since it runs
+   * after this returns.
+   * @param file_path - the path of the file to save to
+   * @param write_task - writes the file, throwing if it can't
+   * @param on_complete - called once the save finishes, or empty for no call
+   */
+  void Enqueue(const std::string& file_path, const WriteTask& write_task,
+               const CompletionCallback& on_complete);
+
+  /**
+   * Getter for the state of the saves.
+   * @return kSaving while any save is queued, and otherwise the result of the
+   * most recent save
+   */
+  SaveStatus GetStatus() const;
+
+  /**
+   * Blocks until every queued save has finished.
+   */
+  void WaitUntilIdle();
+
+ private:
+  /**
+   * A single queued save.
+   */
+  struct SaveJob {
+    std::string file_path;
+    WriteTask write_task;
+    CompletionCallback on_complete;
+  };
+
+  std::deque<SaveJob> jobs_;
+  // the number of jobs queued or being written
+  size_t pending_count_;
+  bool is_stopping_;
+  SaveStatus last_result_;
+
+  mutable std::mutex mutex_;
+  std::condition_variable job_available_;
+  std::condition_variable jobs_finished_;
+  std::thread io_thread_;
+
+  /**
+   * Runs on the I/O thread, writing queued saves until the worker stops.
+   */
+  void ProcessJobs();
+
+  /**
+   * Writes a single save to a temporary file, flushes it to disk, and moves
+   * it into place.
+   * @param job - the save to write
+   * @return a bool indicating whether the save succeeded
+   */
+  static bool WriteJob(const SaveJob& job);
+};
+
+}  // namespace idealgas
+
+#endif  // IDEAL_GAS_SAVE_WORKER_H
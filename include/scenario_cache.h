@@ -0,0 +1,123 @@
+//
+// Created by Neil Kaushikkar on 6/1/21.
+//
+
+#ifndef IDEAL_GAS_SCENARIO_CACHE_H
+#define IDEAL_GAS_SCENARIO_CACHE_H
+
+#include "gas_container.h"
+#include "snapshot_manager.h"
+
+#include <cstdint>
+#include <ctime>
+#include <functional>
+#include <string>
+
+namespace idealgas {
+
+/**
+ * Keeps a binary copy of each parsed scenario next to its source file, so
+ * later loads map the copy into memory instead of parsing the source again.
+ * A cache file is a snapshot followed by a CacheFooter, which records the
+ * source file it was built from. A cache is used only while its source has
+ * the same path, size, and content as when it was built, and is rebuilt
+ * otherwise.
+ */
+class ScenarioCache {
+ public:
+  // What is appended to a source file's path to name its cache file
+  static const std::string kCacheFileSuffix;
+
+  // Identifies the footer of cache files, followed by the footer version
+  static const char kFileSignature[4];
+  static constexpr uint32_t kFileVersion = 1;
+
+  // The starting value of 64-bit FNV-1a hashes
+  static constexpr uint64_t kHashOffsetBasis = 14695981039346656037ULL;
+
+  /**
+   * Parses a scenario from a source file into a container.
+   */
+  typedef std::function<GasContainer(const std::string&)> ParseFunction;
+
+  /**
+   * The fixed-size end of every cache file, which identifies its source.
+   */
+  struct CacheFooter {
+    uint64_t source_path_hash;
+    uint64_t source_size;
+    int64_t source_modification_time;
+    uint64_t source_content_hash;
+    // when the cache was written, which is compared with the source's
+    // modification time to find changes made in the same second
+    int64_t cache_time;
+    char signature[4];
+    uint32_t version;
+  };
+
+  ScenarioCache();
+
+  /**
+   * Loads a scenario from its cache if the cache is up to date. Otherwise,
+   * parses the source file and writes a new cache of it. A cache that can't
+   * be written is skipped, so the scenario still loads.
+   * @param source_file_path - the path of the scenario's source file
+   * @param parse - parses the source file when there is no usable cache
+   * @return a GasContainer holding the scenario's particles
+   * @throws std::invalid_argument if the source file can't be opened, or
+   * whatever parse throws
+   */
+  GasContainer LoadContainer(const std::string& source_file_path,
+                             const ParseFunction& parse) const;
+
+  /**
+   * Writes the cache of a source file, replacing any cache it had before.
+   * @param source_file_path - the path of the file the container came from
+   * @param container - the container parsed from the source file
+   * @throws std::invalid_argument if either file can't be opened
+   */
+  void WriteCache(const std::string& source_file_path,
+                  const GasContainer& container) const;
+
+  /**
+   * Finds the path of a source file's cache.
+   * @param source_file_path - the path of the scenario's source file
+   * @return the path the cache is stored at
+   */
+  static std::string FindCachePath(const std::string& source_file_path);
+
+  /**
+   * Hashes bytes with 64-bit FNV-1a.
+   * @param data - the bytes to hash
+   * @param length - how many bytes to hash
+   * @param hash - the hash of any bytes before these, to continue from
+   * @return the hash of all of the bytes
+   */
+  static uint64_t HashBytes(const char* data, size_t length,
+                            uint64_t hash = kHashOffsetBasis);
+
+ private:
+  SnapshotManager snapshot_manager_;
+
+  /**
+   * Loads a container from a cache file if it was built from the source file
+   * as it is now.
+   * @param source_file_path - the path of the scenario's source file
+   * @param container - set to the cached container if the cache is usable
+   * @return a bool indicating whether the cache was usable
+   */
+  bool TryLoadCache(const std::string& source_file_path,
+                    GasContainer& container) const;
+
+  /**
+   * Hashes the whole contents of a file.
+   * @param file_path - the path of the file to hash
+   * @return the FNV-1a hash of the file
+   * @throws std::invalid_argument if the file can't be opened
+   */
+  static uint64_t HashFile(const std::string& file_path);
+};
+
+}  // namespace idealgas
+
+#endif  // IDEAL_GAS_SCENARIO_CACHE_H
@@ -2,7 +2,18 @@
 // Created by Neil Kaushikkar on 3/15/21.
 //
 #include "json_manager.h"
+#include "save_worker.h"
+#include "snapshot_manager.h"
 #include "histogram.h"
+#include "pair_correlation.h"
+#include "displacement_tracker.h"
+#include "equilibrium_detector.h"
+#include "equilibrium_library.h"
+#include "field_grid.h"
+#include "simulation_frame.h"
+#include "trajectory_writer.h"
+
+#include <memory>
 
 #ifndef IDEAL_GAS_SIMULATION_ENGINE_H
 #define IDEAL_GAS_SIMULATION_ENGINE_H
@@ -17,11 +28,17 @@ class SimulationEngine {
   // Store the file paths to read/save json from/to
   static const std::string kJsonSavedFilePath;
   static const std::string kJsonRandomSimulationFilePath;
+  static const std::string kJsonHistogramSettingsFilePath;
+  static const std::string kSnapshotSavedFilePath;
+  static const std::string kTrajectoryFilePath;
+  static const std::string kEquilibriumLibraryDirectoryPath;
 
   /**
    * Creates a GasContainer for this simulation from either the saved
-   * simulation json file or from the json file indicating the parameters
-   * for a randomly generated simulation.
+   * simulation or from the json file indicating the parameters for a randomly
+   * generated simulation. The saved simulation is loaded from whichever of the
+   * binary snapshot and the json file was saved most recently, and the json
+   * file is read from its binary cache when the cache is up to date.
    * @param load_from_saved_file - indicates whether to load simulation from
    * a saved json file (true) or randomly generate simulation (false)
    */
@@ -37,11 +54,55 @@ class SimulationEngine {
    */
   GasContainer ContainerInitializer(bool load_from_saved_file) const;
 
+  /**
+   * Loads the quantities to show in histograms, falling back to only showing
+   * particle speeds if the histogram settings file does not exist.
+   * @param histogram_settings_file_path - the path of the settings file
+   * @return a vector of HistogramSpecifications, one for each quantity
+   * @throws std::invalid_argument if the file names an unknown quantity, or
+   * nlohmann::json::exception if it isn't valid json or misses a setting
+   */
+  static std::vector<HistogramSpecifications> HistogramInitializer(
+      const std::string& histogram_settings_file_path);
+
   /**
    * Called when the user prompts to save the current state of the simulation.
-   * @param save_file_path - a string indicating the path to save the file to
+   * Copies the particles and returns right away, while the copy is written to
+   * json on a background I/O thread, so the simulation keeps running.
+   * @param on_complete - called on the I/O thread with whether the save
+   * succeeded, or empty for no call
    */
-   void SaveSimulation();
+  void SaveSimulation(const SaveWorker::CompletionCallback& on_complete =
+                          SaveWorker::CompletionCallback());
+
+  /**
+   * Saves the current state of the simulation as a binary snapshot, which is
+   * much faster to save and load than json. Like SaveSimulation, the particles
+   * are copied and written on the background I/O thread.
+   * @param on_complete - called on the I/O thread with whether the save
+   * succeeded, or empty for no call
+   */
+  void SaveSnapshot(const SaveWorker::CompletionCallback& on_complete =
+                        SaveWorker::CompletionCallback());
+
+  /**
+   * Getter for the state of the saves requested so far.
+   * @return kSaving while any save is being written, and otherwise the result
+   * of the most recent save
+   */
+  SaveStatus GetSaveStatus() const;
+
+  /**
+   * Getter for the state of storing the equilibrated state in the library.
+   * @return kIdle if there is no library or nothing has been stored, kSaving
+   * while the state is being written, and otherwise the result of the store
+   */
+  SaveStatus GetLibraryStoreStatus() const;
+
+  /**
+   * Blocks until every requested save has been written.
+   */
+  void WaitForSaves();
 
   /**
    * Steps the simulation 1 unit in time. Updates the GasContainer accordingly.
@@ -53,17 +114,305 @@ class SimulationEngine {
    */
   void Render();
 
+  /**
+   * Copies what Render would draw into a frame, reusing the frame's memory.
+   * The step and capture time of the frame are left for the caller to set.
+   * @param frame - the frame to copy the particles' positions, radii, and
+   * colors, the displayed histograms, and the save status into
+   */
+  void CaptureFrame(SimulationFrame& frame) const;
+
+  /**
+   * Getter for the histogram of a quantity for one particle type.
+   * @param type_name - the name of the particle type
+   * @param quantity - the quantity binned by the histogram
+   * @return a const reference to the matching Histogram
+   * @throws std::invalid_argument if no such histogram exists
+   */
+  const Histogram& GetHistogram(const std::string& type_name,
+                                ParticleQuantity quantity) const;
+
+  /**
+   * Starts accumulating the pair correlation function g(r) of the particles.
+   * Any samples accumulated by a previous call are discarded.
+   * @param max_radius - the largest particle separation to bin
+   * @param bin_count - the number of bins between 0 and max_radius
+   * @param sample_interval - how many frames to wait between samples
+   */
+  void EnablePairCorrelation(float max_radius, size_t bin_count,
+                             size_t sample_interval);
+
+  /**
+   * Stops accumulating the pair correlation function and frees its memory.
+   */
+  void DisablePairCorrelation();
+
+  /**
+   * Getter for the pair correlation accumulator.
+   * @return a pointer to the accumulator, or nullptr if it is not enabled
+   */
+  const PairCorrelationAccumulator* GetPairCorrelation() const;
+
+  /**
+   * Starts tracking the mean squared displacement and diffusion coefficient of
+   * each particle type. Any previous measurements are discarded.
+   * @param max_lag - the largest lag, in frames, to measure displacement at
+   * @param origin_interval - how many frames to wait between time origins
+   */
+  void EnableDisplacementTracking(size_t max_lag, size_t origin_interval);
+
+  /**
+   * Stops tracking displacements and frees the tracker's memory.
+   */
+  void DisableDisplacementTracking();
+
+  /**
+   * Getter for the displacement tracker.
+   * @return a pointer to the tracker, or nullptr if it is not enabled
+   */
+  const DisplacementTracker* GetDisplacementTracker() const;
+
+  /**
+   * Starts depositing the particles onto a grid to find the density, velocity,
+   * and temperature fields of the gas. Any previous deposits are discarded.
+   * @param column_count - the number of cells across the container
+   * @param row_count - the number of cells down the container
+   * @param deposit_interval - how many frames to wait between deposits
+   * @param is_time_averaged - whether to average the fields over every deposit
+   */
+  void EnableFieldDeposition(size_t column_count, size_t row_count,
+                             size_t deposit_interval, bool is_time_averaged);
+
+  /**
+   * Stops depositing the particles and frees the grid's memory.
+   */
+  void DisableFieldDeposition();
+
+  /**
+   * Getter for the field grid.
+   * @return a pointer to the grid, or nullptr if it is not enabled
+   */
+  const FieldGrid* GetFieldGrid() const;
+
+  /**
+   * Starts checking whether the particle speeds have relaxed to the
+   * Maxwell-Boltzmann distribution. Any previous windows are discarded.
+   * @param window_frame_count - the number of frames pooled into each window
+   * @param divergence_threshold - the KL divergence each window must be below
+   * @param required_window_count - how many windows in a row must be below the
+   * threshold before the gas is considered equilibrated
+   */
+  void EnableEquilibriumDetection(size_t window_frame_count,
+                                  double divergence_threshold,
+                                  size_t required_window_count);
+
+  /**
+   * Stops checking for equilibrium and frees the detector's memory.
+   */
+  void DisableEquilibriumDetection();
+
+  /**
+   * Getter for the equilibrium detector.
+   * @return a pointer to the detector, or nullptr if it is not enabled
+   */
+  const EquilibriumDetector* GetEquilibriumDetector() const;
+
+  /**
+   * Starts using a library of equilibrated states of the random scenario. If
+   * the library has a state of the scenario, the simulation is replaced by it
+   * and RunBatch skips straight to sampling. Otherwise, the state is stored
+   * the first time the equilibrium detector finds the gas equilibrated, so
+   * later runs of the scenario can start from it. Loading a state resets the
+   * pair correlation, displacement, field, and equilibrium measurements, and
+   * moves the collision event stream over to the loaded particles.
+   * @param directory_path - the directory the library's states are stored in
+   * @param is_velocity_randomized - whether to redraw the velocities of a
+   * loaded state, so runs starting from it aren't all the same
+   * @param velocity_seed - the seed of the redrawn velocities
+   * @throws std::invalid_argument if the simulation was loaded from a save
+   * instead of generated, if tracers are logged or a trajectory is recorded,
+   * since their files can't be rewound, or if the stored state can't be
+   * loaded
+   */
+  void EnableEquilibriumLibrary(const std::string& directory_path,
+                                bool is_velocity_randomized,
+                                uint64_t velocity_seed);
+
+  /**
+   * Stops using the library of equilibrated states.
+   */
+  void DisableEquilibriumLibrary();
+
+  /**
+   * Getter for the library of equilibrated states.
+   * @return a pointer to the library, or nullptr if it is not enabled
+   */
+  const EquilibriumLibrary* GetEquilibriumLibrary() const;
+
+  /**
+   * Checks whether the simulation started from a stored equilibrated state.
+   * @return a bool indicating whether the simulation was warm started
+   */
+  bool IsWarmStarted() const;
+
+  /**
+   * Runs the simulation without rendering until the gas reaches equilibrium,
+   * then discards the g(r) and displacement measurements taken so far and
+   * keeps running for a fixed number of sampling frames. Without equilibrium
+   * detection enabled, every one of the maximum number of frames is run.
+   * A simulation warm started from the equilibrium library starts sampling
+   * right away.
+   * @param max_frame_count - the most frames to run in total
+   * @param sampling_frame_count - how many frames to run after equilibrium is
+   * reached, where 0 stops as soon as it is reached
+   * @return the number of frames that were run
+   */
+  size_t RunBatch(size_t max_frame_count, size_t sampling_frame_count);
+
+  /**
+   * Starts logging the positions and velocities of the tracer particles picked
+   * by the scenario file every frame. Replaces any previous tracer log.
+   * @param log_file_path - the path of the file to write the log to
+   * @throws std::invalid_argument if the scenario file lists no tracers, or
+   * the simulation was loaded from a save
+   */
+  void StartTracerLog(const std::string& log_file_path);
+
+  /**
+   * Stops logging tracers, waiting for every logged frame to be written.
+   */
+  void StopTracerLog();
+
+  /**
+   * Getter for the tracer logger.
+   * @return a pointer to the logger, or nullptr if tracers are not logged
+   */
+  const TracerLogger* GetTracerLogger() const;
+
+  /**
+   * Starts recording the position of every particle every frame to a
+   * compressed trajectory file. Replaces any previous recording.
+   * @param file_path - the path of the file to write the trajectory to
+   * @param precision - the distance between 2 neighbouring quantized positions
+   * @param keyframe_interval - how many frames apart keyframes are
+   */
+  void StartTrajectoryRecording(const std::string& file_path, double precision,
+                                size_t keyframe_interval);
+
+  /**
+   * Stops recording, waiting for every recorded frame to be written.
+   * @throws std::invalid_argument if the trajectory couldn't be fully written
+   */
+  void StopTrajectoryRecording();
+
+  /**
+   * Getter for the trajectory writer.
+   * @return a pointer to the writer, or nullptr if nothing is being recorded
+   */
+  const TrajectoryWriter* GetTrajectoryWriter() const;
+
+  /**
+   * Starts publishing every collision to a stream that appends the events to a
+   * binary file on a background thread. Replaces any previous event stream.
+   * @param file_path - the path of the file to write the events to
+   * @param capacity - the fewest events the stream's buffer must hold
+   * @param policy - what to do with events published while the buffer is full
+   */
+  void StartCollisionEventStream(const std::string& file_path, size_t capacity,
+                                 OverflowPolicy policy);
+
+  /**
+   * Starts publishing every collision to a stream that passes batches of events
+   * to a callback on a background thread. Replaces any previous event stream.
+   * @param sink - called on the background thread with each batch of events
+   * @param capacity - the fewest events the stream's buffer must hold
+   * @param policy - what to do with events published while the buffer is full
+   */
+  void StartCollisionEventStream(const CollisionEventStream::Sink& sink,
+                                 size_t capacity, OverflowPolicy policy);
+
+  /**
+   * Stops publishing collisions, waiting for every queued event to be written.
+   */
+  void StopCollisionEventStream();
+
+  /**
+   * Getter for the collision event stream.
+   * @return a pointer to the stream, or nullptr if there is no stream
+   */
+  const CollisionEventStream* GetCollisionEventStream() const;
+
+  /**
+   * Getter for the thermodynamic observables of the most recent frame.
+   * @return a FrameObservables record for the latest frame of the simulation
+   */
+  const FrameObservables& GetObservables() const;
+
+  /**
+   * Getter for the collision counts and mean free paths of each particle type.
+   * @return the CollisionStatistics accumulated over the whole simulation
+   */
+  const CollisionStatistics& GetCollisionStatistics() const;
+
  private:
   static constexpr float kHistogramDisplayPadding = 50;
   static constexpr float kDefaultHistogramXCoordinate = 50;
 
   JsonManager json_manager_;
+  SnapshotManager snapshot_manager_;
+  bool is_loaded_from_saved_file_;
   GasContainer container_;
+
+  // the bin configuration of each quantity shown in the histograms
+  std::vector<HistogramSpecifications> histogram_specifications_;
+  // the names of the particle types, in the order their histograms are stored
+  std::vector<std::string> particle_type_names_;
+  // one histogram for each quantity of each particle type, grouped by type
   std::vector<Histogram> histograms_;
 
+  // only allocated while g(r) is being accumulated, since sampling isn't free
+  std::unique_ptr<PairCorrelationAccumulator> pair_correlation_;
+  // only allocated while displacements are tracked, since it copies particles
+  std::unique_ptr<DisplacementTracker> displacement_tracker_;
+  // only allocated while fields are deposited, since it holds a grid per thread
+  std::unique_ptr<FieldGrid> field_grid_;
+  // picks the tracer particles, as listed in the scenario file
+  std::vector<TracerSelector> tracer_selectors_;
+  // only allocated while tracers are logged, since it owns a writer thread
+  std::unique_ptr<TracerLogger> tracer_logger_;
+  // only allocated while recording, since it owns a compression thread
+  std::unique_ptr<TrajectoryWriter> trajectory_writer_;
+  // only allocated while checking for equilibrium, since it bins every frame
+  std::unique_ptr<EquilibriumDetector> equilibrium_detector_;
+  // only allocated while equilibrated states are looked up and stored
+  std::unique_ptr<EquilibriumLibrary> equilibrium_library_;
+  // whether the simulation started from a state in the equilibrium library
+  bool is_warm_started_;
+  // counts the times the particles in container_ were replaced
+  size_t particle_set_;
+  // whether this run's equilibrated state has been handed to the library
+  bool is_library_store_attempted_;
+  // the opt-in stream of collision events, which owns a consumer thread
+  std::unique_ptr<CollisionEventStream> collision_event_stream_;
+  // created on the first save, since it owns the background I/O thread
+  std::unique_ptr<SaveWorker> save_worker_;
+
+  /**
+   * Loads the tracer selectors from the scenario file the particles were
+   * generated from, falling back to no tracers if the file does not exist.
+   * Saved simulations don't list tracers, and the scenario file's selectors
+   * would pick particles of a different scenario, so they have none.
+   * @param load_from_saved_file - whether the particles were loaded from a
+   * saved simulation rather than generated
+   * @return a vector of TracerSelectors
+   */
+  std::vector<TracerSelector> TracerSelectorInitializer(
+      bool load_from_saved_file) const;
+
   /**
-   * Updates the histograms in the frame by passing the updated velocities
-   * from the GasContainer to each particle's corresponding histogram.
+   * Updates the histograms in the frame in a single pass over the particles.
+   * Each particle is visited once, and every quantity measured from it is added
+   * to the corresponding histogram of the particle's type.
    */
   void UpdateHistograms();
 };
@@ -0,0 +1,82 @@
+//
+// Created by Neil Kaushikkar on 6/5/21.
+//
+
+#ifndef IDEAL_GAS_SIMULATION_FRAME_H
+#define IDEAL_GAS_SIMULATION_FRAME_H
+
+#include "histogram.h"
+#include "save_worker.h"
+
+#include <glm/vec2.hpp>
+
+#include <chrono>
+#include <cstddef>
+#include <vector>
+
+namespace idealgas {
+
+/**
+ * A copy of everything drawn for one completed step of a simulation, so the
+ * step can be drawn while the simulation keeps running on another thread.
+ * Radii and colors are copied with the positions, since a step may replace
+ * the particles with ones in a different order.
+ */
+struct SimulationFrame {
+  typedef std::chrono::steady_clock Clock;
+
+  // the number of steps that had been run when the frame was captured
+  size_t step = 0;
+  Clock::time_point capture_time;
+  // changes whenever the simulation replaces its particles, so frames from
+  // before and after aren't interpolated between
+  size_t particle_set = 0;
+
+  // the position, radius, and color of each particle, in the order the
+  // container stores them
+  std::vector<glm::vec2> positions;
+  std::vector<float> radii;
+  std::vector<ci::Color8u> colors;
+  // the histograms that are shown on screen
+  std::vector<Histogram> histograms;
+  SaveStatus save_status = SaveStatus::kIdle;
+  SaveStatus library_store_status = SaveStatus::kIdle;
+};
+
+/**
+ * Finds how far along a step the clock is, as a fraction of the time the
+ * previous step took.
+ * @param previous_time - when the frame before the latest one was captured
+ * @param latest_time - when the latest frame was captured
+ * @param current_time - the time to find the fraction at
+ * @return a fraction between 0 and 1, which is 1 if the frames were captured
+ * at the same time
+ */
+float FindInterpolationFraction(
+    SimulationFrame::Clock::time_point previous_time,
+    SimulationFrame::Clock::time_point latest_time,
+    SimulationFrame::Clock::time_point current_time);
+
+/**
+ * Interpolates linearly between the positions of 2 frames. If the frames have
+ * different numbers of particles, the latest positions are used.
+ * @param previous_positions - the positions at a fraction of 0
+ * @param latest_positions - the positions at a fraction of 1
+ * @param fraction - how far to go from the previous to the latest positions
+ * @param positions - set to the interpolated positions
+ */
+void InterpolatePositions(const std::vector<glm::vec2>& previous_positions,
+                          const std::vector<glm::vec2>& latest_positions,
+                          float fraction, std::vector<glm::vec2>& positions);
+
+/**
+ * Draws the container walls, the particles, and the histograms of a frame.
+ * @param frame - the frame to draw
+ * @param positions - where to draw each of the frame's particles
+ */
+void DrawSimulationFrame(const SimulationFrame& frame,
+                         const std::vector<glm::vec2>& positions);
+
+}  // namespace idealgas
+
+#endif  // IDEAL_GAS_SIMULATION_FRAME_H
@@ -0,0 +1,318 @@
+//
+// Created by Neil Kaushikkar on 6/5/21.
+//
+
+#ifndef IDEAL_GAS_SIMULATION_RUNNER_H
+#define IDEAL_GAS_SIMULATION_RUNNER_H
+
+#include "simulation_frame.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace idealgas {
+
+/**
+ * Steps a simulation on its own thread at a fixed target rate, apart from the
+ * rate the window is drawn at. After each step, what is drawn is copied into
+ * a frame, and the 2 most recent frames are handed to the render thread,
+ * which draws the latest one or interpolates between them. Anything else that
+ * touches the simulation is posted as a command, which runs on the
+ * simulation thread between steps.
+ * @tparam Simulation - what is stepped, such as a SimulationEngine, which
+ * needs an AdvanceToNextFrame() method and a const
+ * CaptureFrame(SimulationFrame&) method
+ */
+template <typename Simulation>
+class SimulationRunner {
+ public:
+  // Runs on the simulation thread with the simulation, between 2 steps
+  typedef std::function<void(Simulation&)> Command;
+  typedef SimulationFrame::Clock Clock;
+
+  // The target rate that steps the simulation as fast as it can run
+  static constexpr double kUnlimitedStepRate = 0;
+
+  /**
+   * Starts stepping the simulation on a new thread. The simulation must
+   * outlive the runner, and must only be touched through commands while it
+   * runs.
+   * @param simulation - the simulation to step
+   * @param target_step_rate - how many steps to run each second, or
+   * kUnlimitedStepRate to run them back to back
+   * @throws std::invalid_argument if the rate is negative
+   */
+  SimulationRunner(Simulation& simulation, double target_step_rate)
+      : simulation_(simulation), target_step_rate_(kUnlimitedStepRate),
+        next_step_time_(Clock::now()), is_paused_(false),
+        is_stopping_(false) {
+    SetTargetStepRate(target_step_rate);
+
+    // Both frames start as the state before the first step
+    simulation_.CaptureFrame(latest_frame_);
+    latest_frame_.capture_time = next_step_time_;
+    previous_frame_ = latest_frame_;
+    rendered_previous_frame_ = latest_frame_;
+    rendered_latest_frame_ = latest_frame_;
+
+    simulation_thread_ = std::thread(&SimulationRunner::RunSimulation, this);
+  }
+
+  SimulationRunner(const SimulationRunner&) = delete;
+  SimulationRunner& operator=(const SimulationRunner&) = delete;
+
+  /**
+   * Runs every posted command, then stops the simulation thread.
+   */
+  ~SimulationRunner() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      is_stopping_ = true;
+    }
+
+    wake_up_.notify_one();
+    simulation_thread_.join();
+  }
+
+  /**
+   * Queues a command to run on the simulation thread before the next step.
+   * Commands run in the order they were posted, even while paused.
+   * @param command - the command to run
+   * @return a future that is ready once the command has run, and that holds
+   * anything the command threw
+   */
+  std::future<void> Post(const Command& command) {
+    Simulation& simulation = simulation_;
+    std::packaged_task<void()> task([command, &simulation]() {
+      command(simulation);
+    });
+    std::future<void> result = task.get_future();
+
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      commands_.push_back(std::move(task));
+    }
+
+    wake_up_.notify_one();
+    return result;
+  }
+
+  /**
+   * Sets how many steps to run each second. A step that runs long delays the
+   * steps after it, rather than being made up by a burst of steps.
+   * @param target_step_rate - the steps to run each second, or
+   * kUnlimitedStepRate to run them back to back
+   * @throws std::invalid_argument if the rate is negative
+   */
+  void SetTargetStepRate(double target_step_rate) {
+    if (target_step_rate < 0) {
+      throw std::invalid_argument("The target step rate can't be negative.");
+    }
+
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      target_step_rate_ = target_step_rate;
+      // Don't keep waiting for a step scheduled at the old rate
+      next_step_time_ = Clock::now();
+    }
+
+    wake_up_.notify_one();
+  }
+
+  double GetTargetStepRate() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return target_step_rate_;
+  }
+
+  /**
+   * Stops stepping the simulation after the current step. Posted commands
+   * still run while paused.
+   */
+  void Pause() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    is_paused_ = true;
+  }
+
+  void Resume() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      is_paused_ = false;
+      next_step_time_ = Clock::now();
+    }
+
+    wake_up_.notify_one();
+  }
+
+  bool IsPaused() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return is_paused_;
+  }
+
+  /**
+   * Getter for the number of steps run since the runner started.
+   * @return the step of the latest completed frame
+   */
+  size_t GetStepCount() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return latest_frame_.step;
+  }
+
+  /**
+   * Getter for the state of the simulation's saves.
+   * @return the save status as of the latest completed frame
+   */
+  SaveStatus GetSaveStatus() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return latest_frame_.save_status;
+  }
+
+  /**
+   * Getter for the state of storing the simulation's equilibrated state.
+   * @return the store status as of the latest completed frame
+   */
+  SaveStatus GetLibraryStoreStatus() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return latest_frame_.library_store_status;
+  }
+
+  /**
+   * Draws the most recent completed frame. Only the render thread should
+   * call this.
+   * @param is_interpolated - whether to draw the particles between the last 2
+   * frames, by how far the clock is into the step after the latest one
+   */
+  void Render(bool is_interpolated) {
+    // Copy the frames out, so the simulation thread is only held up by a copy
+    // rather than by drawing
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (latest_frame_.step != rendered_latest_frame_.step) {
+        rendered_previous_frame_ = previous_frame_;
+        rendered_latest_frame_ = latest_frame_;
+      }
+    }
+
+    // Replaced particles don't line up with the ones they replaced
+    if (!is_interpolated || rendered_previous_frame_.particle_set
+                                != rendered_latest_frame_.particle_set) {
+      DrawSimulationFrame(rendered_latest_frame_,
+                          rendered_latest_frame_.positions);
+      return;
+    }
+
+    float fraction = FindInterpolationFraction(
+        rendered_previous_frame_.capture_time,
+        rendered_latest_frame_.capture_time, Clock::now());
+    InterpolatePositions(rendered_previous_frame_.positions,
+                         rendered_latest_frame_.positions, fraction,
+                         interpolated_positions_);
+    DrawSimulationFrame(rendered_latest_frame_, interpolated_positions_);
+  }
+
+ private:
+  Simulation& simulation_;
+
+  double target_step_rate_;
+  Clock::time_point next_step_time_;
+  bool is_paused_;
+  bool is_stopping_;
+  std::deque<std::packaged_task<void()>> commands_;
+
+  // the frame being captured, which only the simulation thread touches
+  SimulationFrame captured_frame_;
+  // the 2 most recent completed frames, swapped in as each step completes
+  SimulationFrame previous_frame_;
+  SimulationFrame latest_frame_;
+
+  // the render thread's copies of the completed frames
+  SimulationFrame rendered_previous_frame_;
+  SimulationFrame rendered_latest_frame_;
+  std::vector<glm::vec2> interpolated_positions_;
+
+  mutable std::mutex mutex_;
+  std::condition_variable wake_up_;
+  std::thread simulation_thread_;
+
+  /**
+   * Runs on the simulation thread, running commands and stepping the
+   * simulation until the runner stops.
+   */
+  void RunSimulation() {
+    std::unique_lock<std::mutex> lock(mutex_);
+
+    while (true) {
+      // Commands run between steps, so they never see a step half done
+      if (!commands_.empty()) {
+        std::packaged_task<void()> command = std::move(commands_.front());
+        commands_.pop_front();
+
+        lock.unlock();
+        command();
+        lock.lock();
+        continue;
+      }
+
+      if (is_stopping_) {
+        return;
+      }
+
+      if (is_paused_) {
+        wake_up_.wait(lock);
+        continue;
+      }
+
+      if (target_step_rate_ != kUnlimitedStepRate
+          && Clock::now() < next_step_time_) {
+        wake_up_.wait_until(lock, next_step_time_);
+        continue;
+      }
+
+      size_t step = latest_frame_.step + 1;
+      lock.unlock();
+
+      // Only this thread touches the simulation and the frame being captured
+      simulation_.AdvanceToNextFrame();
+      simulation_.CaptureFrame(captured_frame_);
+      captured_frame_.step = step;
+      captured_frame_.capture_time = Clock::now();
+
+      lock.lock();
+      std::swap(previous_frame_, latest_frame_);
+      std::swap(latest_frame_, captured_frame_);
+
+      if (target_step_rate_ != kUnlimitedStepRate) {
+        Clock::duration step_period = FindStepPeriod();
+        next_step_time_ += step_period;
+
+        // Fall behind after a slow step instead of bursting to catch up
+        if (latest_frame_.capture_time - next_step_time_ > step_period) {
+          next_step_time_ = latest_frame_.capture_time;
+        }
+      }
+    }
+  }
+
+  /**
+   * Finds how long each step should take.
+   * @return the time between the starts of 2 steps at the target rate
+   */
+  Clock::duration FindStepPeriod() const {
+    return std::chrono::duration_cast<Clock::duration>(
+        std::chrono::duration<double>(1 / target_step_rate_));
+  }
+};
+
+template <typename Simulation>
+constexpr double SimulationRunner<Simulation>::kUnlimitedStepRate;
+
+}  // namespace idealgas
+
+#endif  // IDEAL_GAS_SIMULATION_RUNNER_H
@@ -0,0 +1,113 @@
+//
+// Created by Neil Kaushikkar on 5/27/21.
+//
+
+#ifndef IDEAL_GAS_SNAPSHOT_MANAGER_H
+#define IDEAL_GAS_SNAPSHOT_MANAGER_H
+
+#include "gas_container.h"
+
+#include <cstdint>
+#include <string>
+
+namespace idealgas {
+
+/**
+ * Saves and loads containers as versioned binary snapshots, which are much
+ * smaller and faster to read than json. Snapshots are laid out so a reader
+ * can map the file into memory and use each column in place:
+ *
+ *   - a 64 byte SnapshotHeader
+ *   - the particle type table: one SnapshotSpeciesEntry per type, followed by
+ *     the type names packed together
+ *   - the positions of every particle, as pairs of 32-bit floats
+ *   - the velocities of every particle, as pairs of 32-bit floats
+ *   - the index of every particle's type in the type table, as 32-bit ints
+ *
+ * Each column starts on a kColumnAlignment byte boundary, and every value is
+ * stored in native byte order.
+ */
+class SnapshotManager {
+ public:
+  // Identifies snapshot files, followed by the format version
+  static const char kFileSignature[4];
+  static constexpr uint32_t kFileVersion = 1;
+  static constexpr size_t kColumnAlignment = 64;
+
+  /**
+   * The fixed-size start of every snapshot, which locates everything else.
+   */
+  struct SnapshotHeader {
+    char signature[4];
+    uint32_t version;
+    uint64_t particle_count;
+    uint32_t species_count;
+    // the total length of the type names packed after the species entries
+    uint32_t species_names_size;
+    uint64_t species_table_offset;
+    uint64_t positions_offset;
+    uint64_t velocities_offset;
+    uint64_t species_ids_offset;
+    uint64_t file_size;
+  };
+
+  /**
+   * The specs of a single particle type in the type table.
+   */
+  struct SnapshotSpeciesEntry {
+    float radius;
+    float mass;
+    uint8_t red;
+    uint8_t green;
+    uint8_t blue;
+    uint8_t padding;
+    // where the type's name starts, relative to the start of the packed names
+    uint32_t name_offset;
+    uint32_t name_length;
+  };
+
+  SnapshotManager();
+
+  /**
+   * Saves the particles and particle types of a container to a snapshot.
+   * @param container - the container to save
+   * @param save_file_path - a string indicating the path to save to
+   * @throws std::invalid_argument if the file can't be opened or fully written
+   */
+  void WriteContainerToSnapshot(const GasContainer& container,
+                                const std::string& save_file_path) const;
+
+  /**
+   * Loads a container from a snapshot by mapping the file into memory and
+   * creating the particles straight from its columns.
+   * @param snapshot_file_path - a string indicating the path to load from
+   * @return a GasContainer holding the saved particles
+   * @throws std::invalid_argument if the file can't be opened or is not a
+   * valid snapshot of a supported version
+   */
+  GasContainer LoadContainerFromSnapshot(
+      const std::string& snapshot_file_path) const;
+
+  /**
+   * Loads a container from a snapshot that is already in memory, such as one
+   * at the start of a larger mapped file.
+   * @param data - the bytes of the snapshot, aligned to kColumnAlignment
+   * @param file_size - how many bytes the snapshot takes up
+   * @return a GasContainer holding the saved particles
+   * @throws std::invalid_argument if the bytes are not a valid snapshot of a
+   * supported version
+   */
+  GasContainer LoadContainerFromSnapshotData(const char* data,
+                                             uint64_t file_size) const;
+
+  /**
+   * Rounds an offset up to the next column boundary.
+   * @param offset - a byte offset into the file
+   * @return the smallest multiple of kColumnAlignment not less than offset
+   */
+  static uint64_t AlignOffset(uint64_t offset);
+};
+
+}  // namespace idealgas
+
+#endif  // IDEAL_GAS_SNAPSHOT_MANAGER_H
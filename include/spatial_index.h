@@ -0,0 +1,81 @@
+//
+// Created by Neil Kaushikkar on 5/25/21.
+//
+
+#ifndef IDEAL_GAS_SPATIAL_INDEX_H
+#define IDEAL_GAS_SPATIAL_INDEX_H
+
+#include "cell_list.h"
+
+#include <cinder/Color.h>
+
+#include <vector>
+
+namespace idealgas {
+
+/**
+ * Answers range, box, and nearest neighbour queries over the particles of a
+ * single frame. Particles are grouped into a cell list sized so each cell
+ * holds about kParticlesPerCell particles, so a query only scans the cells
+ * overlapping it and costs time proportional to the particles it returns
+ * rather than to every particle.
+ *
+ * The index keeps its own copy of the particle positions, so it stays valid if
+ * the particles it was built from are moved or copied, but it describes them
+ * as they were when it was built.
+ */
+class SpatialIndex {
+ public:
+  // The average number of particles to place in each cell
+  static constexpr float kParticlesPerCell = 2;
+
+  SpatialIndex();
+
+  /**
+   * Indexes the current positions of the given particles.
+   * @param particles - the particles to index, which are referred to by index
+   * @param region - the region the particles are in
+   */
+  void Build(const std::vector<GasParticle>& particles,
+             const ci::Rectf& region);
+
+  /**
+   * Finds every particle whose center is within a distance of a point.
+   * @param center - the point to search around
+   * @param radius - the largest distance from the point to include
+   * @return a vector with the indices of the particles found, in no order
+   */
+  std::vector<size_t> FindParticlesWithinRadius(const glm::vec2& center,
+                                                float radius) const;
+
+  /**
+   * Finds every particle whose center is inside an axis-aligned box.
+   * @param lower_corner - the corner of the box closest to the origin
+   * @param upper_corner - the corner of the box furthest from the origin
+   * @return a vector with the indices of the particles found, in no order
+   */
+  std::vector<size_t> FindParticlesInBox(const glm::vec2& lower_corner,
+                                         const glm::vec2& upper_corner) const;
+
+  /**
+   * Finds the particles closest to a particle, not including itself.
+   * @param particle_idx - the index of the particle to search around
+   * @param neighbor_count - the most neighbours to find
+   * @return a vector with the indices of the neighbours, nearest first
+   * @throws std::invalid_argument if the particle index is out of range
+   */
+  std::vector<size_t> FindNearestNeighbors(size_t particle_idx,
+                                           size_t neighbor_count) const;
+
+ private:
+  CellList cell_list_;
+  // the region and particle count the cell list was sized for
+  ci::Rectf region_;
+  size_t particle_count_;
+
+  std::vector<glm::vec2> positions_;
+};
+
+}  // namespace idealgas
+
+#endif  // IDEAL_GAS_SPATIAL_INDEX_H
@@ -0,0 +1,106 @@
+//
+// Created by Neil Kaushikkar on 5/22/21.
+//
+
+#ifndef IDEAL_GAS_SPSC_RING_BUFFER_H
+#define IDEAL_GAS_SPSC_RING_BUFFER_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <vector>
+
+namespace idealgas {
+
+/**
+ * A fixed-size, lock-free queue between exactly 1 producer thread and exactly 1
+ * consumer thread. All of the memory is allocated up front, so pushing and
+ * popping never allocate.
+ */
+template <typename T>
+class SpscRingBuffer {
+ public:
+  /**
+   * Creates an empty ring buffer.
+   * @param min_capacity - the fewest items the buffer must hold, which is
+   * rounded up to a power of 2
+   */
+  explicit SpscRingBuffer(size_t min_capacity)
+      : write_index_(0), read_index_(0) {
+    size_t capacity = 1;
+    while (capacity < min_capacity) {
+      capacity *= 2;
+    }
+
+    slots_.resize(capacity);
+    index_mask_ = capacity - 1;
+  }
+
+  SpscRingBuffer(const SpscRingBuffer&) = delete;
+  SpscRingBuffer& operator=(const SpscRingBuffer&) = delete;
+
+  /**
+   * Adds an item to the back of the queue. Only call from the producer.
+   * @param item - the item to copy into the queue
+   * @return a bool indicating whether there was space for the item
+   */
+  bool TryPush(const T& item) {
+    size_t write_index = write_index_.load(std::memory_order_relaxed);
+    size_t read_index = read_index_.load(std::memory_order_acquire);
+
+    if (write_index - read_index == slots_.size()) {
+      return false;
+    }
+
+    slots_[write_index & index_mask_] = item;
+    // Publish the item only after it has been written
+    write_index_.store(write_index + 1, std::memory_order_release);
+    return true;
+  }
+
+  /**
+   * Removes items from the front of the queue. Only call from the consumer.
+   * @param output - where to copy the removed items to
+   * @param max_count - the most items to remove
+   * @return the number of items removed
+   */
+  size_t PopBatch(T* output, size_t max_count) {
+    size_t read_index = read_index_.load(std::memory_order_relaxed);
+    size_t write_index = write_index_.load(std::memory_order_acquire);
+    size_t count = std::min(write_index - read_index, max_count);
+
+    for (size_t idx = 0; idx < count; idx++) {
+      output[idx] = slots_[(read_index + idx) & index_mask_];
+    }
+
+    // Hand the slots back to the producer only after they have been read
+    read_index_.store(read_index + count, std::memory_order_release);
+    return count;
+  }
+
+  bool IsEmpty() const {
+    return write_index_.load(std::memory_order_acquire)
+           == read_index_.load(std::memory_order_acquire);
+  }
+
+  size_t GetCapacity() const {
+    return slots_.size();
+  }
+
+ private:
+  static constexpr size_t kCacheLineSize = 64;
+
+  std::vector<T> slots_;
+  size_t index_mask_;
+
+  // The indices only ever increase, so they are masked to find their slots.
+  // Each index is padded onto its own cache line so the threads don't contend.
+  std::atomic<size_t> write_index_;
+  char write_index_padding_[kCacheLineSize - sizeof(std::atomic<size_t>)];
+  std::atomic<size_t> read_index_;
+  char read_index_padding_[kCacheLineSize - sizeof(std::atomic<size_t>)];
+};
+
+}  // namespace idealgas
+
+#endif  // IDEAL_GAS_SPSC_RING_BUFFER_H
@@ -0,0 +1,114 @@
+//
+// Created by Neil Kaushikkar on 5/26/21.
+//
+
+#ifndef IDEAL_GAS_TRACER_LOG_H
+#define IDEAL_GAS_TRACER_LOG_H
+
+#include "gas_container.h"
+#include "record_stream.h"
+
+#include <nlohmann/json.hpp>
+
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <vector>
+
+namespace idealgas {
+
+/**
+ * Picks which particles to tag as tracers. A particle is selected when it is
+ * of the given type and its index is within [first_id, end_id). If a sample
+ * count is given, only that many of the matching particles are picked at
+ * random. Every key is optional in json, so {"particle_name": "carbon"} tags
+ * every carbon particle.
+ */
+struct TracerSelector {
+  // the particle type to select from, or empty to select from every type
+  std::string particle_name;
+  size_t first_id = 0;
+  // one past the last index to select from
+  size_t end_id = std::numeric_limits<size_t>::max();
+  // how many of the matching particles to pick, or 0 to pick all of them
+  size_t sample_count = 0;
+  // seeds the random sample so the same tracers are picked every run
+  uint32_t seed = 0;
+};
+
+void from_json(const nlohmann::json& json_object, TracerSelector& selector);
+
+/**
+ * Finds the particles picked by any of the selectors.
+ * @param container - the container to select particles from
+ * @param selectors - the selectors to apply
+ * @return a vector of the indices of the selected particles, in order
+ * @throws std::invalid_argument if a selector names a type with no particles
+ */
+std::vector<size_t> SelectTracers(const GasContainer& container,
+                                  const std::vector<TracerSelector>& selectors);
+
+/**
+ * The state of a single tracer in a single frame. These are written to tracer
+ * logs as raw bytes, 24 bytes per record in native byte order.
+ */
+struct TracerRecord {
+  uint32_t frame;
+  // the index of the particle in the container
+  uint32_t particle_id;
+  float x_position;
+  float y_position;
+  float x_velocity;
+  float y_velocity;
+};
+
+typedef AsyncRecordStream<TracerRecord> TracerRecordStream;
+
+/**
+ * Appends the positions and velocities of a fixed set of tracer particles to a
+ * log file every frame. The file is written on a background thread, so each
+ * frame only costs copying the tracers' state into the stream's buffer, which
+ * scales with the number of tracers rather than the number of particles.
+ */
+class TracerLogger {
+ public:
+  // How many frames of records the stream's buffer holds
+  static constexpr size_t kBufferedFrameCount = 64;
+
+  /**
+   * Opens the log file and starts the background writer.
+   * @param tracer_ids - the indices of the particles to log
+   * @param file_path - the path of the file to write the records to
+   * @throws std::invalid_argument if the file can't be opened
+   */
+  TracerLogger(const std::vector<size_t>& tracer_ids,
+               const std::string& file_path);
+
+  /**
+   * Called once per frame to log the state of every tracer.
+   * @param container - the container the tracers were selected from
+   */
+  void Record(const GasContainer& container);
+
+  /**
+   * Waits for every logged record to be written and closes the log.
+   */
+  void Close();
+
+  const std::vector<size_t>& GetTracerIds() const;
+
+  /**
+   * Getter for the number of frames logged so far.
+   * @return the number of frames logged
+   */
+  size_t GetFrameCount() const;
+
+ private:
+  std::vector<size_t> tracer_ids_;
+  size_t frame_count_;
+  TracerRecordStream stream_;
+};
+
+}  // namespace idealgas
+
+#endif  // IDEAL_GAS_TRACER_LOG_H
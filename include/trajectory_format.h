@@ -0,0 +1,107 @@
+//
+// Created by Neil Kaushikkar on 5/29/21.
+//
+
+#ifndef IDEAL_GAS_TRAJECTORY_FORMAT_H
+#define IDEAL_GAS_TRAJECTORY_FORMAT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace idealgas {
+
+/**
+ * The layout of trajectory files, which hold the quantized positions of every
+ * particle in every recorded frame:
+ *
+ *   - a TrajectoryHeader
+ *   - the particle type table, laid out like a snapshot's: one
+ *     SnapshotManager::SnapshotSpeciesEntry per type, then the type names
+ *   - the index of every particle's type in the table, as 32-bit ints
+ *   - one block per frame: a TrajectoryFrameHeader followed by its payload
+ *   - the offset of every keyframe's block from the start of the file, as
+ *     64-bit ints, followed by a TrajectoryFooter
+ *
+ * Positions are rounded to multiples of the precision and stored as integers
+ * in x, y order for each particle. A keyframe stores the integers themselves.
+ * The frame after a keyframe stores the change since that keyframe, and every
+ * later frame stores how much that change differs from the previous frame's,
+ * which is 0 for particles moving in a straight line. Each payload is packed
+ * with EncodeTrajectoryValues, so decoding any frame only needs the frames
+ * since the keyframe before it, which the keyframe index finds without reading
+ * the rest of the file. The index is written when recording stops, so files
+ * cut short by a crash have no index, but their frame blocks are still valid.
+ */
+struct TrajectoryHeader {
+  char signature[4];
+  uint32_t version;
+  // the distance between 2 neighbouring quantized positions
+  double precision;
+  // how many frames apart keyframes are
+  uint32_t keyframe_interval;
+  uint32_t species_count;
+  uint64_t particle_count;
+  // the total length of the type names packed after the species entries
+  uint32_t species_names_size;
+  uint32_t reserved;
+};
+
+/**
+ * The start of every frame block.
+ */
+struct TrajectoryFrameHeader {
+  uint64_t frame;
+  uint32_t is_keyframe;
+  // the number of bytes of packed values following this header
+  uint32_t payload_size;
+};
+
+/**
+ * The end of every finished trajectory file, which locates the keyframe index.
+ */
+struct TrajectoryFooter {
+  uint64_t keyframe_index_offset;
+  uint64_t keyframe_count;
+  uint64_t frame_count;
+  // matches the file's signature, showing that the index was written
+  char signature[4];
+  uint32_t reserved;
+};
+
+// Identifies trajectory files, followed by the format version
+extern const char kTrajectoryFileSignature[4];
+constexpr uint32_t kTrajectoryFileVersion = 1;
+
+/**
+ * Packs signed integers into a byte-oriented code built for residuals that are
+ * mostly 0 or small. Values are zigzag encoded so small negative values stay
+ * small, and then each byte starts with a 2-bit tag:
+ *
+ *   - 00rrrrrr: a run of r + 1 zeroes
+ *   - 01aabbcc: 3 values that are each less than 4 after zigzag encoding,
+ *     which covers the -1, 0, and 1 left by rounding straight-line motion
+ *   - 10vvvvvv: a single value less than 64
+ *   - 11vvvvvv: the low 6 bits of a larger value, followed by the rest of it
+ *     as a little-endian base 128 varint
+ *
+ * @param values - the values to pack
+ * @param output - where to append the packed bytes
+ */
+void EncodeTrajectoryValues(const std::vector<int32_t>& values,
+                            std::vector<uint8_t>& output);
+
+/**
+ * Unpacks values packed by EncodeTrajectoryValues.
+ * @param data - the packed bytes
+ * @param size - the number of packed bytes
+ * @param values - where to store the values, which must already hold exactly
+ * as many values as were packed
+ * @throws std::invalid_argument if the bytes don't hold that many values
+ */
+void DecodeTrajectoryValues(const uint8_t* data, size_t size,
+                            std::vector<int32_t>& values);
+
+}  // namespace idealgas
+
+#endif  // IDEAL_GAS_TRAJECTORY_FORMAT_H
@@ -0,0 +1,101 @@
+//
+// Created by Neil Kaushikkar on 5/30/21.
+//
+
+#ifndef IDEAL_GAS_TRAJECTORY_READER_H
+#define IDEAL_GAS_TRAJECTORY_READER_H
+
+#include "gas_particle.h"
+#include "mapped_file.h"
+#include "trajectory_format.h"
+
+#include <string>
+#include <vector>
+
+namespace idealgas {
+
+/**
+ * Reads any frame of a trajectory file written by a TrajectoryWriter. The file
+ * is mapped into memory, and the keyframe index finds the keyframe before a
+ * frame directly, so reading a frame only decodes the frames since that
+ * keyframe no matter how long the trajectory is.
+ */
+class TrajectoryReader {
+ public:
+  /**
+   * Maps a trajectory file and reads its particle types and keyframe index.
+   * Files without an index, such as ones cut short by a crash, are scanned
+   * once to find their keyframes, and any partly written frame is ignored.
+   * @param file_path - the path of the trajectory file
+   * @throws std::invalid_argument if the file can't be opened or is not a
+   * valid trajectory of a supported version
+   */
+  explicit TrajectoryReader(const std::string& file_path);
+
+  /**
+   * Decodes the position of every particle in a frame. Reading the frame after
+   * the last one read only decodes that frame.
+   * @param frame - the index of the frame to read
+   * @param positions - where to store the positions, in particle order
+   * @throws std::invalid_argument if the frame is not in the trajectory or its
+   * block is corrupt
+   */
+  void ReadFrame(size_t frame, std::vector<glm::vec2>& positions);
+
+  size_t GetFrameCount() const;
+
+  size_t GetParticleCount() const;
+
+  double GetPrecision() const;
+
+  size_t GetKeyframeInterval() const;
+
+  /**
+   * Getter for the particle types recorded in the trajectory.
+   * @return the specs of each particle type, in the order the table lists them
+   */
+  const std::vector<ParticleSpecs>& GetParticleSpecs() const;
+
+  /**
+   * Getter for the type of each particle.
+   * @return the index of each particle's type in GetParticleSpecs
+   */
+  const std::vector<uint32_t>& GetParticleTypeIds() const;
+
+ private:
+  MappedFile file_;
+  TrajectoryHeader header_;
+  std::vector<ParticleSpecs> particle_specs_;
+  std::vector<uint32_t> particle_type_ids_;
+
+  // where the frame blocks end, which is the start of the keyframe index
+  uint64_t frames_end_offset_;
+  std::vector<uint64_t> keyframe_offsets_;
+  size_t frame_count_;
+
+  // the state left by the last frame decoded, so the next one can follow it
+  bool has_decoded_frame_;
+  size_t decoded_frame_;
+  uint64_t next_block_offset_;
+  std::vector<int32_t> values_;
+  std::vector<int32_t> positions_;
+  std::vector<int32_t> deltas_;
+
+  /**
+   * Finds the keyframes and number of frames by walking the frame blocks, for
+   * files that have no keyframe index.
+   * @param frames_offset - where the first frame block starts
+   */
+  void ScanFrameBlocks(uint64_t frames_offset);
+
+  /**
+   * Decodes the frame block at next_block_offset_ on top of the last frame
+   * decoded, and moves on to the next block.
+   * @param frame - the index the block is expected to hold
+   */
+  void DecodeNextFrame(size_t frame);
+};
+
+}  // namespace idealgas
+
+#endif  // IDEAL_GAS_TRAJECTORY_READER_H
@@ -0,0 +1,124 @@
+//
+// Created by Neil Kaushikkar on 5/29/21.
+//
+
+#ifndef IDEAL_GAS_TRAJECTORY_WRITER_H
+#define IDEAL_GAS_TRAJECTORY_WRITER_H
+
+#include "gas_container.h"
+#include "trajectory_format.h"
+
+#include <condition_variable>
+#include <deque>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace idealgas {
+
+/**
+ * Appends the position of every particle to a trajectory file every frame.
+ * Positions are quantized and delta coded as described by TrajectoryHeader,
+ * and the compression runs on a background thread, so each frame only costs
+ * copying the positions into a recycled staging buffer.
+ */
+class TrajectoryWriter {
+ public:
+  // How many staged frames can wait for compression before Record blocks
+  static constexpr size_t kStagingBufferCount = 8;
+
+  /**
+   * Opens the trajectory file, writes the particle types of the container to
+   * it, and starts the compression thread.
+   * @param file_path - the path of the file to write the trajectory to
+   * @param container - the container whose particles will be recorded
+   * @param precision - the distance between 2 neighbouring quantized positions
+   * @param keyframe_interval - how many frames apart keyframes are
+   * @throws std::invalid_argument if the file can't be opened, the precision
+   * is not positive or is too fine for the quantized positions to fit in 32
+   * bits, or the keyframe interval is 0
+   */
+  TrajectoryWriter(const std::string& file_path, const GasContainer& container,
+                   double precision, size_t keyframe_interval);
+
+  TrajectoryWriter(const TrajectoryWriter&) = delete;
+  TrajectoryWriter& operator=(const TrajectoryWriter&) = delete;
+
+  /**
+   * Writes every recorded frame before closing the file. Failed writes are
+   * only reported by calling Close first.
+   */
+  ~TrajectoryWriter();
+
+  /**
+   * Called once per frame to record the position of every particle. Blocks
+   * only if every staging buffer is waiting to be compressed.
+   * @param container - the container the writer was created for
+   * @throws std::invalid_argument if the number of particles has changed
+   */
+  void Record(const GasContainer& container);
+
+  /**
+   * Waits for every recorded frame to be written, appends the keyframe index,
+   * and closes the file. Calling it again does nothing.
+   * @throws std::invalid_argument if any part of the file couldn't be written
+   */
+  void Close();
+
+  /**
+   * Getter for the number of frames recorded so far.
+   * @return the number of frames recorded
+   */
+  size_t GetFrameCount() const;
+
+ private:
+  /**
+   * The positions of every particle in a single frame, as x, y pairs.
+   */
+  struct StagedFrame {
+    uint64_t frame;
+    std::vector<float> positions;
+  };
+
+  std::ofstream output_file_;
+  double precision_;
+  size_t keyframe_interval_;
+  size_t particle_count_;
+  size_t frame_count_;
+
+  std::deque<StagedFrame> staged_frames_;
+  // the staging buffers not holding a frame, which are reused to save copies
+  std::vector<std::vector<float>> free_buffers_;
+  bool is_closing_;
+
+  std::mutex mutex_;
+  std::condition_variable frame_available_;
+  std::condition_variable buffer_available_;
+  std::thread compression_thread_;
+
+  // only used on the compression thread until it stops
+  uint64_t file_size_;
+  std::vector<uint64_t> keyframe_offsets_;
+  std::vector<int32_t> previous_positions_;
+  std::vector<int32_t> previous_deltas_;
+  std::vector<int32_t> residuals_;
+  std::vector<uint8_t> payload_;
+
+  /**
+   * Runs on the compression thread, writing staged frames until the writer
+   * is closed.
+   */
+  void CompressFrames();
+
+  /**
+   * Quantizes a single frame, finds its residuals, and writes its block.
+   * @param staged_frame - the frame to write
+   */
+  void WriteFrame(const StagedFrame& staged_frame);
+};
+
+}  // namespace idealgas
+
+#endif  // IDEAL_GAS_TRAJECTORY_WRITER_H
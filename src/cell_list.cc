@@ -0,0 +1,118 @@
+//
+// Created by Neil Kaushikkar on 5/18/21.
+//
+
+#include "cell_list.h"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace idealgas {
+
+using std::vector;
+using glm::vec2;
+
+CellList::CellList()
+    : lower_corner_(0, 0), column_count_(1), row_count_(1), cell_width_(1),
+      cell_height_(1), cell_starts_(2, 0) {}
+
+CellList::CellList(const vec2& lower_corner, const vec2& upper_corner,
+                   float min_cell_size)
+    : lower_corner_(lower_corner) {
+  if (min_cell_size <= 0) {
+    throw std::invalid_argument("Cell size must be greater than 0.");
+  }
+
+  vec2 region_size = upper_corner - lower_corner;
+
+  // Round the cell count down so that every cell is at least the minimum size
+  column_count_ = std::max<size_t>(
+      1, static_cast<size_t>(std::floor(region_size.x / min_cell_size)));
+  row_count_ = std::max<size_t>(
+      1, static_cast<size_t>(std::floor(region_size.y / min_cell_size)));
+
+  cell_width_ = std::max(region_size.x / column_count_, min_cell_size);
+  cell_height_ = std::max(region_size.y / row_count_, min_cell_size);
+
+  cell_starts_.assign(column_count_ * row_count_ + 1, 0);
+}
+
+void CellList::Build(const vector<GasParticle>& particles) {
+  std::fill(cell_starts_.begin(), cell_starts_.end(), 0);
+  particle_cells_.resize(particles.size());
+  particle_indices_.resize(particles.size());
+
+  // Count the particles in each cell, offset by 1 for the prefix sum below
+  for (size_t idx = 0; idx < particles.size(); idx++) {
+    const vec2& position = particles[idx].GetPosition();
+    size_t cell = FindRow(position) * column_count_ + FindColumn(position);
+
+    particle_cells_[idx] = cell;
+    cell_starts_[cell + 1]++;
+  }
+
+  for (size_t cell = 1; cell < cell_starts_.size(); cell++) {
+    cell_starts_[cell] += cell_starts_[cell - 1];
+  }
+
+  // Place each particle after the ones already placed in its cell
+  for (size_t idx = 0; idx < particles.size(); idx++) {
+    particle_indices_[cell_starts_[particle_cells_[idx]]++] = idx;
+  }
+
+  // Placing the particles moved each start to the next cell's start, so undo it
+  for (size_t cell = cell_starts_.size() - 1; cell > 0; cell--) {
+    cell_starts_[cell] = cell_starts_[cell - 1];
+  }
+  cell_starts_[0] = 0;
+}
+
+size_t CellList::GetColumnCount() const {
+  return column_count_;
+}
+
+size_t CellList::GetRowCount() const {
+  return row_count_;
+}
+
+float CellList::GetCellWidth() const {
+  return cell_width_;
+}
+
+float CellList::GetCellHeight() const {
+  return cell_height_;
+}
+
+size_t CellList::FindColumn(const vec2& position) const {
+  float column = std::floor((position.x - lower_corner_.x) / cell_width_);
+  if (!(column > 0)) {
+    return 0;
+  } else if (column >= column_count_) {
+    return column_count_ - 1;
+  }
+
+  return static_cast<size_t>(column);
+}
+
+size_t CellList::FindRow(const vec2& position) const {
+  float row = std::floor((position.y - lower_corner_.y) / cell_height_);
+  if (!(row > 0)) {
+    return 0;
+  } else if (row >= row_count_) {
+    return row_count_ - 1;
+  }
+
+  return static_cast<size_t>(row);
+}
+
+const size_t* CellList::GetCellBegin(size_t column, size_t row) const {
+  return particle_indices_.data() + cell_starts_[row * column_count_ + column];
+}
+
+const size_t* CellList::GetCellEnd(size_t column, size_t row) const {
+  return particle_indices_.data()
+         + cell_starts_[row * column_count_ + column + 1];
+}
+
+}  // namespace idealgas
@@ -0,0 +1,113 @@
+//
+// Created by Neil Kaushikkar on 5/21/21.
+//
+
+#include "collision_statistics.h"
+
+#include <algorithm>
+
+namespace idealgas {
+
+using std::vector;
+using std::string;
+
+CollisionStatistics::CollisionStatistics(const vector<string>& type_names,
+                                         const vector<size_t>& type_counts)
+    : type_names_(type_names), type_counts_(type_counts), frame_count_(0),
+      collision_counts_(type_names.size() * type_names.size(), 0),
+      free_path_sums_(type_names.size(), 0),
+      free_path_counts_(type_names.size(), 0) {}
+
+void CollisionStatistics::RecordCollision(size_t type_one, size_t type_two) {
+  if (type_one > type_two) {
+    std::swap(type_one, type_two);
+  }
+
+  collision_counts_[type_one * type_names_.size() + type_two]++;
+}
+
+void CollisionStatistics::RecordFreePath(size_t type, float path_length) {
+  free_path_sums_[type] += path_length;
+  free_path_counts_[type]++;
+}
+
+void CollisionStatistics::RecordFrame() {
+  frame_count_++;
+}
+
+void CollisionStatistics::Merge(const CollisionStatistics& other) {
+  frame_count_ += other.frame_count_;
+
+  for (size_t idx = 0; idx < collision_counts_.size(); idx++) {
+    collision_counts_[idx] += other.collision_counts_[idx];
+  }
+
+  for (size_t type = 0; type < free_path_sums_.size(); type++) {
+    free_path_sums_[type] += other.free_path_sums_[type];
+    free_path_counts_[type] += other.free_path_counts_[type];
+  }
+}
+
+void CollisionStatistics::Clear() {
+  frame_count_ = 0;
+  std::fill(collision_counts_.begin(), collision_counts_.end(), 0);
+  std::fill(free_path_sums_.begin(), free_path_sums_.end(), 0);
+  std::fill(free_path_counts_.begin(), free_path_counts_.end(), 0);
+}
+
+size_t CollisionStatistics::FindType(const string& type_name) const {
+  return std::find(type_names_.begin(), type_names_.end(), type_name)
+         - type_names_.begin();
+}
+
+size_t CollisionStatistics::GetCollisionCount(const string& type_one,
+                                              const string& type_two) const {
+  size_t first_type = FindType(type_one);
+  size_t second_type = FindType(type_two);
+  if (first_type == type_names_.size() || second_type == type_names_.size()) {
+    return 0;
+  }
+
+  if (first_type > second_type) {
+    std::swap(first_type, second_type);
+  }
+
+  return collision_counts_[first_type * type_names_.size() + second_type];
+}
+
+double CollisionStatistics::GetCollisionFrequency(
+    const string& type_name) const {
+  size_t type = FindType(type_name);
+  if (type == type_names_.size() || type_counts_[type] == 0
+      || frame_count_ == 0) {
+    return 0;
+  }
+
+  // Collisions within the type involve 2 of its particles
+  double particle_collisions = 0;
+  for (size_t other = 0; other < type_names_.size(); other++) {
+    size_t first_type = std::min(type, other);
+    size_t second_type = std::max(type, other);
+    size_t count =
+        collision_counts_[first_type * type_names_.size() + second_type];
+
+    particle_collisions += other == type ? 2.0 * count : count;
+  }
+
+  return particle_collisions / (type_counts_[type] * frame_count_);
+}
+
+double CollisionStatistics::GetMeanFreePath(const string& type_name) const {
+  size_t type = FindType(type_name);
+  if (type == type_names_.size() || free_path_counts_[type] == 0) {
+    return 0;
+  }
+
+  return free_path_sums_[type] / free_path_counts_[type];
+}
+
+size_t CollisionStatistics::GetFrameCount() const {
+  return frame_count_;
+}
+
+}  // namespace idealgas
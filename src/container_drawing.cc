@@ -0,0 +1,30 @@
+//
+// Created by Neil Kaushikkar on 6/5/21.
+//
+
+#include "container_drawing.h"
+
+#include "gas_container.h"
+
+namespace idealgas {
+
+using glm::vec2;
+using std::vector;
+
+void DrawContainerContents(const vector<vec2>& positions,
+                           const vector<float>& radii,
+                           const vector<ci::Color8u>& colors) {
+  ci::gl::color(ci::Color(GasContainer::kWallColor));
+  ci::gl::drawStrokedRect(
+      ci::Rectf(vec2(GasContainer::kContainerLeftBound,
+                     GasContainer::kContainerUpperBound),
+                vec2(GasContainer::kContainerRightBound,
+                     GasContainer::kContainerLowerBound)));
+
+  for (size_t idx = 0; idx < positions.size(); idx++) {
+    ci::gl::color(colors[idx]);
+    ci::gl::drawSolidCircle(positions[idx], radii[idx]);
+  }
+}
+
+}  // namespace idealgas
@@ -0,0 +1,241 @@
+//
+// Created by Neil Kaushikkar on 5/31/21.
+//
+
+#include "container_json_writer.h"
+
+#include <nlohmann/json.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <map>
+#include <vector>
+
+namespace idealgas {
+
+using glm::vec2;
+using std::map;
+using std::string;
+using std::vector;
+
+constexpr size_t ContainerJsonWriter::kChunkParticleCount;
+
+// The number of spaces each level of json is indented by
+static constexpr size_t kIndentWidth = 2;
+
+ContainerJsonWriter::ContainerJsonWriter(JsonLayout layout,
+                                         size_t worker_count)
+    : layout_(layout), worker_count_(std::max<size_t>(1, worker_count)) {}
+
+void ContainerJsonWriter::Write(const GasContainer& container,
+                                std::ostream& output) const {
+  const vector<GasParticle>& particles = container.GetParticles();
+  const map<string, ParticleSpecs>& specifications =
+      container.GetParticleSpecifications();
+
+  string buffer;
+
+  // Keys are written in sorted order, like the json library's objects
+  buffer += '{';
+  AppendKey("all_particles_", 1, buffer);
+  buffer += '[';
+  output.write(buffer.data(), buffer.size());
+  buffer.clear();
+
+  // Only as many chunks as there are workers are held in memory at once
+  vector<string> chunks(worker_count_);
+  size_t batch_size = worker_count_ * kChunkParticleCount;
+  for (size_t begin = 0; begin < particles.size(); begin += batch_size) {
+    WriteParticles(particles, begin,
+                   std::min(begin + batch_size, particles.size()), chunks,
+                   output);
+  }
+
+  if (!particles.empty()) {
+    AppendLineBreak(1, buffer);
+  }
+  buffer += "],";
+
+  AppendKey("particle_specifications_", 1, buffer);
+  buffer += '{';
+
+  for (auto type_specs = specifications.begin();
+       type_specs != specifications.end(); ++type_specs) {
+    if (type_specs != specifications.begin()) {
+      buffer += ',';
+    }
+
+    AppendKey(type_specs->first, 2, buffer);
+    AppendSpecs(type_specs->second, 2, buffer);
+  }
+
+  if (!specifications.empty()) {
+    AppendLineBreak(1, buffer);
+  }
+  buffer += '}';
+
+  AppendLineBreak(0, buffer);
+  buffer += "}\n";
+  output.write(buffer.data(), buffer.size());
+}
+
+void ContainerJsonWriter::WriteParticles(const vector<GasParticle>& particles,
+                                         size_t begin, size_t end,
+                                         vector<string>& chunks,
+                                         std::ostream& output) const {
+  // Small batches are not worth starting threads for
+  size_t chunk_count = std::min(
+      worker_count_, (end - begin + kChunkParticleCount - 1)
+                         / kChunkParticleCount);
+
+  // Each worker formats one contiguous chunk, so the chunks are in order
+  ParallelFor(end - begin, chunk_count,
+              [&](size_t chunk_begin, size_t chunk_end, size_t worker) {
+    string& chunk = chunks[worker];
+    chunk.clear();
+
+    for (size_t idx = begin + chunk_begin; idx < begin + chunk_end; idx++) {
+      AppendParticle(particles[idx], 2, chunk);
+      if (idx + 1 < particles.size()) {
+        chunk += ',';
+      }
+    }
+  });
+
+  for (size_t worker = 0; worker < chunk_count; worker++) {
+    output.write(chunks[worker].data(), chunks[worker].size());
+  }
+}
+
+void ContainerJsonWriter::AppendLineBreak(size_t depth,
+                                          string& buffer) const {
+  if (layout_ == JsonLayout::kIndented) {
+    buffer += '\n';
+    buffer.append(depth * kIndentWidth, ' ');
+  }
+}
+
+void ContainerJsonWriter::AppendKey(const string& key, size_t depth,
+                                    string& buffer) const {
+  AppendLineBreak(depth, buffer);
+  AppendString(key, buffer);
+  buffer += layout_ == JsonLayout::kIndented ? ": " : ":";
+}
+
+void ContainerJsonWriter::AppendParticle(const GasParticle& particle,
+                                         size_t depth, string& buffer) const {
+  AppendLineBreak(depth, buffer);
+  buffer += '{';
+
+  AppendKey("particle_type_name_", depth + 1, buffer);
+  AppendString(particle.GetTypeName(), buffer);
+  buffer += ',';
+  AppendKey("position_", depth + 1, buffer);
+  AppendVector(particle.GetPosition(), depth + 1, buffer);
+  buffer += ',';
+  AppendKey("velocity_", depth + 1, buffer);
+  AppendVector(particle.GetVelocity(), depth + 1, buffer);
+
+  AppendLineBreak(depth, buffer);
+  buffer += '}';
+}
+
+void ContainerJsonWriter::AppendVector(const vec2& vec, size_t depth,
+                                       string& buffer) const {
+  buffer += '[';
+  AppendLineBreak(depth + 1, buffer);
+  AppendFloat(vec.x, buffer);
+  buffer += ',';
+  AppendLineBreak(depth + 1, buffer);
+  AppendFloat(vec.y, buffer);
+  AppendLineBreak(depth, buffer);
+  buffer += ']';
+}
+
+void ContainerJsonWriter::AppendSpecs(const ParticleSpecs& specs, size_t depth,
+                                      string& buffer) const {
+  buffer += '{';
+
+  AppendKey("color", depth + 1, buffer);
+  buffer += '{';
+  AppendKey("blue", depth + 2, buffer);
+  buffer += std::to_string(specs.color.b);
+  buffer += ',';
+  AppendKey("green", depth + 2, buffer);
+  buffer += std::to_string(specs.color.g);
+  buffer += ',';
+  AppendKey("red", depth + 2, buffer);
+  buffer += std::to_string(specs.color.r);
+  AppendLineBreak(depth + 1, buffer);
+  buffer += "},";
+
+  AppendKey("mass", depth + 1, buffer);
+  AppendFloat(specs.mass, buffer);
+  buffer += ',';
+  AppendKey("name", depth + 1, buffer);
+  AppendString(specs.name, buffer);
+  buffer += ',';
+  AppendKey("radius", depth + 1, buffer);
+  AppendFloat(specs.radius, buffer);
+
+  AppendLineBreak(depth, buffer);
+  buffer += '}';
+}
+
+void ContainerJsonWriter::AppendString(const string& value, string& buffer) {
+  buffer += '"';
+
+  for (char character : value) {
+    switch (character) {
+      case '"':
+        buffer += "\\\"";
+        break;
+      case '\\':
+        buffer += "\\\\";
+        break;
+      case '\b':
+        buffer += "\\b";
+        break;
+      case '\f':
+        buffer += "\\f";
+        break;
+      case '\n':
+        buffer += "\\n";
+        break;
+      case '\r':
+        buffer += "\\r";
+        break;
+      case '\t':
+        buffer += "\\t";
+        break;
+      default:
+        if (static_cast<unsigned char>(character) < 0x20) {
+          char escaped[7];
+          std::snprintf(escaped, sizeof(escaped), "\\u%04x",
+                        static_cast<unsigned int>(character));
+          buffer += escaped;
+        } else {
+          buffer += character;
+        }
+    }
+  }
+
+  buffer += '"';
+}
+
+void ContainerJsonWriter::AppendFloat(float value, string& buffer) {
+  if (!std::isfinite(value)) {
+    buffer += "null";
+    return;
+  }
+
+  // The json library formats numbers with Grisu2, which finds the shortest
+  // digits for the float itself when given a float rather than a double
+  char digits[32];
+  char* digits_end =
+      nlohmann::detail::to_chars(digits, digits + sizeof(digits), value);
+  buffer.append(digits, digits_end);
+}
+
+}  // namespace idealgas
@@ -0,0 +1,304 @@
+//
+// Created by Neil Kaushikkar on 5/31/21.
+//
+
+#include "container_sax_handler.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace idealgas {
+
+using glm::vec2;
+
+constexpr size_t ContainerSaxHandler::kCountBlockSize;
+constexpr uint8_t ContainerSaxHandler::kHasTypeName;
+constexpr uint8_t ContainerSaxHandler::kHasPosition;
+constexpr uint8_t ContainerSaxHandler::kHasVelocity;
+constexpr uint8_t ContainerSaxHandler::kHasRadius;
+constexpr uint8_t ContainerSaxHandler::kHasMass;
+constexpr uint8_t ContainerSaxHandler::kHasName;
+constexpr uint8_t ContainerSaxHandler::kHasColor;
+
+ContainerSaxHandler::ContainerSaxHandler(size_t particle_capacity)
+    : has_particle_list_(false), has_specification_map_(false),
+      particle_keys_(0), vector_(nullptr), vector_value_count_(0),
+      specification_keys_(0) {
+  // Growing the vector would copy every particle, and any room reserved past
+  // the last particle is kept for as long as the container is
+  particles_.reserve(particle_capacity);
+}
+
+size_t ContainerSaxHandler::CountParticles(std::istream& input) {
+  const std::string particle_key = "\"particle_type_name_\"";
+
+  size_t particle_count = 0;
+  std::vector<char> block(kCountBlockSize);
+  std::string unscanned;
+
+  while (input.read(block.data(), block.size()) || input.gcount() > 0) {
+    unscanned.append(block.data(), static_cast<size_t>(input.gcount()));
+
+    size_t position = unscanned.find(particle_key);
+    while (position != std::string::npos) {
+      particle_count++;
+      position = unscanned.find(particle_key, position + particle_key.size());
+    }
+
+    // Keep only the end of the block, which may hold the start of a key that
+    // the next block finishes, but never a whole key
+    size_t kept_size = std::min(unscanned.size(), particle_key.size() - 1);
+    unscanned.erase(0, unscanned.size() - kept_size);
+  }
+
+  return particle_count;
+}
+
+GasContainer ContainerSaxHandler::BuildContainer() {
+  if (!has_particle_list_ || !has_specification_map_) {
+    throw std::invalid_argument(
+        "The saved simulation is missing its particles or particle types.");
+  }
+
+  GasContainer container(std::move(particles_), std::move(specifications_));
+  container.Configure();
+
+  return container;
+}
+
+bool ContainerSaxHandler::null() {
+  return UnexpectedValue();
+}
+
+bool ContainerSaxHandler::boolean(bool) {
+  return UnexpectedValue();
+}
+
+bool ContainerSaxHandler::number_integer(number_integer_t value) {
+  return Number(static_cast<double>(value));
+}
+
+bool ContainerSaxHandler::number_unsigned(number_unsigned_t value) {
+  return Number(static_cast<double>(value));
+}
+
+bool ContainerSaxHandler::number_float(number_float_t value,
+                                       const string_t&) {
+  return Number(value);
+}
+
+bool ContainerSaxHandler::string(string_t& value) {
+  switch (FindCurrentField()) {
+    case Field::kTypeName:
+      type_name_.swap(value);
+      particle_keys_ |= kHasTypeName;
+      return true;
+    case Field::kName:
+      specs_.name.swap(value);
+      specification_keys_ |= kHasName;
+      return true;
+    default:
+      return UnexpectedValue();
+  }
+}
+
+bool ContainerSaxHandler::binary(binary_t&) {
+  return UnexpectedValue();
+}
+
+bool ContainerSaxHandler::start_object(std::size_t) {
+  if (scopes_.empty()) {
+    scopes_.push_back(Scope::kRoot);
+    return true;
+  }
+
+  switch (FindCurrentField()) {
+    case Field::kParticle:
+      particle_keys_ = 0;
+      scopes_.push_back(Scope::kParticle);
+      return true;
+    case Field::kSpecificationMap:
+      has_specification_map_ = true;
+      scopes_.push_back(Scope::kSpecificationMap);
+      return true;
+    case Field::kSpecification:
+      specification_key_ = key_;
+      specs_ = ParticleSpecs();
+      specification_keys_ = 0;
+      scopes_.push_back(Scope::kSpecification);
+      return true;
+    case Field::kColor:
+      specs_.color = ci::Color8u(0, 0, 0);
+      specification_keys_ |= kHasColor;
+      scopes_.push_back(Scope::kColor);
+      return true;
+    case Field::kNone:
+    case Field::kColorValue:
+      scopes_.push_back(Scope::kSkipped);
+      return true;
+    default:
+      throw std::invalid_argument(
+          "The saved simulation has an object where a value belongs.");
+  }
+}
+
+bool ContainerSaxHandler::key(string_t& value) {
+  key_.swap(value);
+  return true;
+}
+
+bool ContainerSaxHandler::end_object() {
+  Scope scope = scopes_.back();
+  scopes_.pop_back();
+
+  if (scope == Scope::kParticle) {
+    if (particle_keys_ != (kHasTypeName | kHasPosition | kHasVelocity)) {
+      throw std::invalid_argument("A saved particle is missing a key.");
+    }
+
+    ParticleSpecs type_specs = {0, 0, ci::Color8u(), type_name_};
+    particles_.emplace_back(position_, velocity_, type_specs);
+  } else if (scope == Scope::kSpecification) {
+    if (specification_keys_
+        != (kHasRadius | kHasMass | kHasName | kHasColor)) {
+      throw std::invalid_argument("A saved particle type is missing a key.");
+    }
+
+    specifications_[specification_key_] = specs_;
+  }
+
+  return true;
+}
+
+bool ContainerSaxHandler::start_array(std::size_t) {
+  if (scopes_.empty()) {
+    throw std::invalid_argument("The saved simulation is not an object.");
+  }
+
+  Field field = FindCurrentField();
+  switch (field) {
+    case Field::kParticleList:
+      has_particle_list_ = true;
+      scopes_.push_back(Scope::kParticleList);
+      return true;
+    case Field::kPosition:
+    case Field::kVelocity:
+      vector_ = field == Field::kPosition ? &position_ : &velocity_;
+      particle_keys_ |= field == Field::kPosition ? kHasPosition : kHasVelocity;
+      *vector_ = vec2(0, 0);
+      vector_value_count_ = 0;
+      scopes_.push_back(Scope::kVector);
+      return true;
+    case Field::kNone:
+    case Field::kColorValue:
+      scopes_.push_back(Scope::kSkipped);
+      return true;
+    default:
+      throw std::invalid_argument(
+          "The saved simulation has an array where a value belongs.");
+  }
+}
+
+bool ContainerSaxHandler::end_array() {
+  scopes_.pop_back();
+  return true;
+}
+
+bool ContainerSaxHandler::parse_error(
+    std::size_t, const std::string&,
+    const nlohmann::detail::exception& error) {
+  throw std::invalid_argument(error.what());
+}
+
+ContainerSaxHandler::Field ContainerSaxHandler::FindCurrentField() const {
+  // A value outside of any object, which is never part of the schema
+  if (scopes_.empty()) {
+    return Field::kNone;
+  }
+
+  switch (scopes_.back()) {
+    case Scope::kRoot:
+      if (key_ == "all_particles_") {
+        return Field::kParticleList;
+      }
+      return key_ == "particle_specifications_" ? Field::kSpecificationMap
+                                                : Field::kNone;
+    case Scope::kParticleList:
+      return Field::kParticle;
+    case Scope::kParticle:
+      if (key_ == "particle_type_name_") {
+        return Field::kTypeName;
+      } else if (key_ == "position_") {
+        return Field::kPosition;
+      }
+      return key_ == "velocity_" ? Field::kVelocity : Field::kNone;
+    case Scope::kVector:
+      return Field::kVectorValue;
+    case Scope::kSpecificationMap:
+      return Field::kSpecification;
+    case Scope::kSpecification:
+      if (key_ == "radius") {
+        return Field::kRadius;
+      } else if (key_ == "mass") {
+        return Field::kMass;
+      } else if (key_ == "name") {
+        return Field::kName;
+      }
+      return key_ == "color" ? Field::kColor : Field::kNone;
+    case Scope::kColor:
+      return key_ == "red" || key_ == "green" || key_ == "blue"
+             ? Field::kColorValue : Field::kNone;
+    default:
+      return Field::kNone;
+  }
+}
+
+bool ContainerSaxHandler::Number(double value) {
+  switch (FindCurrentField()) {
+    case Field::kVectorValue:
+      // Any values past the 2nd are ignored
+      if (vector_value_count_ < 2) {
+        (*vector_)[vector_value_count_] = static_cast<float>(value);
+      }
+      vector_value_count_++;
+      return true;
+    case Field::kRadius:
+      specs_.radius = static_cast<float>(value);
+      specification_keys_ |= kHasRadius;
+      return true;
+    case Field::kMass:
+      specs_.mass = static_cast<float>(value);
+      specification_keys_ |= kHasMass;
+      return true;
+    case Field::kColorValue: {
+      uint8_t channel = static_cast<uint8_t>(value);
+      if (key_ == "red") {
+        specs_.color.r = channel;
+      } else if (key_ == "green") {
+        specs_.color.g = channel;
+      } else {
+        specs_.color.b = channel;
+      }
+      return true;
+    }
+    case Field::kNone:
+      return true;
+    default:
+      throw std::invalid_argument(
+          "The saved simulation has a number where it doesn't belong.");
+  }
+}
+
+bool ContainerSaxHandler::UnexpectedValue() {
+  Field field = FindCurrentField();
+
+  // Colors that aren't numbers are left as 0
+  if (field == Field::kNone || field == Field::kColorValue) {
+    return true;
+  }
+
+  throw std::invalid_argument(
+      "The saved simulation has a value of the wrong type.");
+}
+
+}  // namespace idealgas
@@ -0,0 +1,61 @@
+//
+// Created by Neil Kaushikkar on 6/2/21.
+//
+
+#include "counter_rng.h"
+
+namespace idealgas {
+
+constexpr size_t CounterRng::kBlockSize;
+
+// The multipliers and key increments of Philox4x32, from Salmon et al.
+static constexpr uint32_t kPhiloxMultiplier0 = 0xD2511F53;
+static constexpr uint32_t kPhiloxMultiplier1 = 0xCD9E8D57;
+static constexpr uint32_t kPhiloxKeyIncrement0 = 0x9E3779B9;
+static constexpr uint32_t kPhiloxKeyIncrement1 = 0xBB67AE85;
+static constexpr size_t kPhiloxRoundCount = 10;
+
+// Floats are drawn from the top 24 bits, which is all a float's mantissa holds
+static constexpr uint32_t kFloatBitCount = 24;
+static constexpr float kFloatBitScale = 1.0f / (1 << kFloatBitCount);
+
+CounterRng::CounterRng(uint64_t seed, uint32_t stream, uint64_t index)
+    : counter_({{static_cast<uint32_t>(index),
+                 static_cast<uint32_t>(index >> 32), stream, 0}}),
+      key_({{static_cast<uint32_t>(seed), static_cast<uint32_t>(seed >> 32)}}),
+      block_(), block_position_(kBlockSize) {}
+
+uint32_t CounterRng::NextUint() {
+  // Each counter gives 4 numbers, after which the next counter is used
+  if (block_position_ == kBlockSize) {
+    block_ = Philox(counter_, key_);
+    counter_[3]++;
+    block_position_ = 0;
+  }
+
+  return block_[block_position_++];
+}
+
+float CounterRng::NextFloat(float min_value, float max_value) {
+  float unit_value = (NextUint() >> (32 - kFloatBitCount)) * kFloatBitScale;
+  return min_value + unit_value * (max_value - min_value);
+}
+
+CounterRng::Counter CounterRng::Philox(Counter counter, Key key) {
+  for (size_t round = 0; round < kPhiloxRoundCount; round++) {
+    uint64_t product0 = static_cast<uint64_t>(kPhiloxMultiplier0) * counter[0];
+    uint64_t product1 = static_cast<uint64_t>(kPhiloxMultiplier1) * counter[2];
+
+    counter = {{static_cast<uint32_t>(product1 >> 32) ^ counter[1] ^ key[0],
+                static_cast<uint32_t>(product1),
+                static_cast<uint32_t>(product0 >> 32) ^ counter[3] ^ key[1],
+                static_cast<uint32_t>(product0)}};
+
+    key[0] += kPhiloxKeyIncrement0;
+    key[1] += kPhiloxKeyIncrement1;
+  }
+
+  return counter;
+}
+
+}  // namespace idealgas
@@ -0,0 +1,174 @@
+//
+// Created by Neil Kaushikkar on 5/20/21.
+//
+
+#include "displacement_tracker.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace idealgas {
+
+using std::vector;
+using std::string;
+using glm::vec2;
+
+DisplacementTracker::DisplacementTracker(size_t max_lag,
+                                         size_t origin_interval)
+    : origin_interval_(origin_interval), frames_seen_(0) {
+  if (max_lag == 0 || origin_interval == 0) {
+    throw std::invalid_argument("The maximum lag and origin interval must be "
+                                "at least 1.");
+  }
+
+  for (size_t lag = 1; lag <= max_lag; lag *= 2) {
+    lags_.push_back(lag);
+  }
+
+  // An origin lives for max_lag frames, so this many can be alive at once
+  size_t origin_count = lags_.back() / origin_interval + 1;
+  TimeOrigin unused_origin = {0, 0, false, {}};
+  origins_.assign(origin_count, unused_origin);
+}
+
+void DisplacementTracker::Record(const GasContainer& container) {
+  const vector<GasParticle>& particles = container.GetParticles();
+  IndexParticleTypes(container);
+
+  size_t frame = frames_seen_++;
+
+  for (TimeOrigin& origin : origins_) {
+    if (!origin.is_active || frame - origin.frame != lags_[origin.next_lag_idx]) {
+      continue;
+    }
+
+    AccumulateLag(particles, origin, origin.next_lag_idx);
+
+    // Free the origin for reuse once it has been measured at every lag
+    origin.next_lag_idx++;
+    origin.is_active = origin.next_lag_idx < lags_.size();
+  }
+
+  if (frame % origin_interval_ != 0) {
+    return;
+  }
+
+  for (TimeOrigin& origin : origins_) {
+    if (origin.is_active) {
+      continue;
+    }
+
+    origin.frame = frame;
+    origin.next_lag_idx = 0;
+    origin.is_active = true;
+
+    // Reuses the origin's memory once it has been sized for the particles
+    origin.displacements.resize(particles.size());
+    for (size_t idx = 0; idx < particles.size(); idx++) {
+      origin.displacements[idx] = particles[idx].GetUnwrappedDisplacement();
+    }
+
+    break;
+  }
+}
+
+void DisplacementTracker::IndexParticleTypes(const GasContainer& container) {
+  const vector<GasParticle>& particles = container.GetParticles();
+  if (particle_types_.size() == particles.size() && !type_names_.empty()) {
+    return;
+  }
+
+  type_names_ = container.GetParticleTypeNames();
+  particle_types_.assign(particles.size(), 0);
+
+  for (size_t type = 0; type < type_names_.size(); type++) {
+    for (size_t particle_idx :
+         container.GetParticlesOfType(type_names_[type]).GetIndices()) {
+      particle_types_[particle_idx] = type;
+    }
+  }
+
+  // Displacements from before the particles changed can't be compared
+  Reset();
+}
+
+void DisplacementTracker::Reset() {
+  squared_displacement_sums_.assign(type_names_.size() * lags_.size(), 0);
+  squared_displacement_counts_.assign(type_names_.size() * lags_.size(), 0);
+  for (TimeOrigin& origin : origins_) {
+    origin.is_active = false;
+  }
+  frames_seen_ = 0;
+}
+
+void DisplacementTracker::AccumulateLag(const vector<GasParticle>& particles,
+                                        const TimeOrigin& origin,
+                                        size_t lag_idx) {
+  for (size_t idx = 0; idx < particles.size(); idx++) {
+    vec2 change = particles[idx].GetUnwrappedDisplacement()
+                  - origin.displacements[idx];
+    size_t sum_idx = particle_types_[idx] * lags_.size() + lag_idx;
+
+    squared_displacement_sums_[sum_idx] += glm::dot(change, change);
+    squared_displacement_counts_[sum_idx]++;
+  }
+}
+
+const vector<size_t>& DisplacementTracker::GetLags() const {
+  return lags_;
+}
+
+vector<double> DisplacementTracker::GetMeanSquaredDisplacement(
+    const string& type_name) const {
+  vector<double> mean_squared_displacement(lags_.size(), 0);
+
+  auto type = std::find(type_names_.begin(), type_names_.end(), type_name);
+  if (type == type_names_.end()) {
+    return mean_squared_displacement;
+  }
+
+  size_t type_offset = (type - type_names_.begin()) * lags_.size();
+  for (size_t lag_idx = 0; lag_idx < lags_.size(); lag_idx++) {
+    size_t count = squared_displacement_counts_[type_offset + lag_idx];
+    if (count > 0) {
+      mean_squared_displacement[lag_idx] =
+          squared_displacement_sums_[type_offset + lag_idx] / count;
+    }
+  }
+
+  return mean_squared_displacement;
+}
+
+double DisplacementTracker::GetDiffusionCoefficient(
+    const string& type_name) const {
+  auto type = std::find(type_names_.begin(), type_names_.end(), type_name);
+  if (type == type_names_.end()) {
+    return 0;
+  }
+
+  // Lags are measured in increasing order, so find the largest measured lag
+  size_t type_offset = (type - type_names_.begin()) * lags_.size();
+  size_t measured_lags = 0;
+  while (measured_lags < lags_.size()
+         && squared_displacement_counts_[type_offset + measured_lags] > 0) {
+    measured_lags++;
+  }
+
+  vector<double> mean_squared_displacement =
+      GetMeanSquaredDisplacement(type_name);
+
+  if (measured_lags == 0) {
+    return 0;
+  } else if (measured_lags == 1) {
+    return mean_squared_displacement[0] / (4.0 * lags_[0]);
+  }
+
+  size_t last = measured_lags - 1;
+  double msd_change = mean_squared_displacement[last]
+                      - mean_squared_displacement[last - 1];
+  double lag_change = static_cast<double>(lags_[last] - lags_[last - 1]);
+
+  return msd_change / (4.0 * lag_change);
+}
+
+}  // namespace idealgas
@@ -0,0 +1,176 @@
+//
+// Created by Neil Kaushikkar on 5/23/21.
+//
+
+#include "equilibrium_detector.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace idealgas {
+
+using std::string;
+using std::vector;
+
+constexpr size_t EquilibriumDetector::kBinCount;
+constexpr float EquilibriumDetector::kSpeedRangeFactor;
+
+// Keeps empty expected bins from dividing by zero
+static constexpr double kMinimumExpectedProbability = 1e-12;
+
+EquilibriumDetector::EquilibriumDetector(size_t window_frame_count,
+                                         double divergence_threshold,
+                                         size_t required_window_count)
+    : window_frame_count_(window_frame_count),
+      divergence_threshold_(divergence_threshold),
+      required_window_count_(required_window_count), particle_count_(0),
+      species_() {
+  if (window_frame_count == 0 || required_window_count == 0) {
+    throw std::invalid_argument("The window size and the number of windows "
+                                "required must be at least 1.");
+  }
+
+  Reset();
+}
+
+void EquilibriumDetector::Record(const GasContainer& container) {
+  const vector<GasParticle>& particles = container.GetParticles();
+  float temperature = container.GetObservables().temperature;
+
+  // A gas at rest has no speed distribution to compare against
+  if (particles.empty() || temperature <= 0) {
+    return;
+  }
+
+  if (particle_count_ != particles.size()) {
+    IndexSpecies(container, temperature);
+  }
+
+  for (SpeciesDistribution& species : species_) {
+    species.histogram.ResetBins();
+    for (const GasParticle& particle :
+         container.GetParticlesOfType(species.type_name)) {
+      species.histogram.AddValue(glm::length(particle.GetVelocity()));
+    }
+
+    const vector<size_t>& bins = species.histogram.GetBins();
+    for (size_t bin = 0; bin < bins.size(); bin++) {
+      species.window_bins[bin] += bins[bin];
+    }
+  }
+
+  window_temperature_sum_ += temperature;
+  if (++window_frames_seen_ == window_frame_count_) {
+    CompleteWindow();
+  }
+}
+
+void EquilibriumDetector::Reset() {
+  for (SpeciesDistribution& species : species_) {
+    std::fill(species.window_bins.begin(), species.window_bins.end(), 0);
+  }
+
+  window_frames_seen_ = 0;
+  window_temperature_sum_ = 0;
+  latest_divergence_ = std::numeric_limits<double>::infinity();
+  consecutive_window_count_ = 0;
+}
+
+bool EquilibriumDetector::IsEquilibrated() const {
+  return consecutive_window_count_ >= required_window_count_;
+}
+
+double EquilibriumDetector::GetLatestDivergence() const {
+  return latest_divergence_;
+}
+
+size_t EquilibriumDetector::GetConsecutiveWindowCount() const {
+  return consecutive_window_count_;
+}
+
+void EquilibriumDetector::IndexSpecies(const GasContainer& container,
+                                       float temperature) {
+  species_.clear();
+  particle_count_ = container.GetParticles().size();
+
+  for (const string& type_name : container.GetParticleTypeNames()) {
+    float mass = container.GetParticlesOfType(type_name)[0].GetMass();
+
+    // The 2D speed distribution peaks at sqrt(T / m)
+    float most_probable_speed = std::sqrt(temperature / mass);
+    float bin_range = kSpeedRangeFactor * most_probable_speed / kBinCount;
+
+    SpeciesDistribution species = {
+        type_name, mass,
+        Histogram(type_name, kBinCount, bin_range, 0, 0, ci::Color8u()),
+        vector<double>(kBinCount, 0)};
+    species_.push_back(species);
+  }
+
+  // Bins from before the particles changed can't be compared
+  Reset();
+}
+
+void EquilibriumDetector::CompleteWindow() {
+  double temperature = window_temperature_sum_ / window_frames_seen_;
+
+  double divergence = 0;
+  for (const SpeciesDistribution& species : species_) {
+    divergence = std::max(divergence, ComputeDivergence(species, temperature));
+  }
+
+  latest_divergence_ = divergence;
+  if (divergence < divergence_threshold_) {
+    consecutive_window_count_++;
+  } else {
+    consecutive_window_count_ = 0;
+  }
+
+  for (SpeciesDistribution& species : species_) {
+    std::fill(species.window_bins.begin(), species.window_bins.end(), 0);
+  }
+  window_frames_seen_ = 0;
+  window_temperature_sum_ = 0;
+}
+
+double EquilibriumDetector::ComputeDivergence(
+    const SpeciesDistribution& species, double temperature) const {
+  double observed_total = 0;
+  for (double count : species.window_bins) {
+    observed_total += count;
+  }
+
+  if (observed_total == 0) {
+    return std::numeric_limits<double>::infinity();
+  }
+
+  // The 2D Maxwell-Boltzmann speed CDF is 1 - exp(-m v^2 / 2T)
+  double exponent_scale = species.mass / (2 * temperature);
+  double bin_range = species.histogram.GetSingleBinRange();
+  double max_speed = bin_range * kBinCount;
+  double expected_total =
+      1 - std::exp(-exponent_scale * max_speed * max_speed);
+
+  double divergence = 0;
+  for (size_t bin = 0; bin < kBinCount; bin++) {
+    double observed = species.window_bins[bin] / observed_total;
+    if (observed == 0) {
+      continue;
+    }
+
+    double lower_speed = bin * bin_range;
+    double upper_speed = lower_speed + bin_range;
+    double expected =
+        (std::exp(-exponent_scale * lower_speed * lower_speed)
+         - std::exp(-exponent_scale * upper_speed * upper_speed))
+        / expected_total;
+
+    expected = std::max(expected, kMinimumExpectedProbability);
+    divergence += observed * std::log(observed / expected);
+  }
+
+  return divergence;
+}
+
+}  // namespace idealgas
@@ -0,0 +1,189 @@
+//
+// Created by Neil Kaushikkar on 6/4/21.
+//
+
+#include "equilibrium_library.h"
+
+#include "counter_rng.h"
+#include "scenario_cache.h"
+
+#include <sys/stat.h>
+
+#include <cmath>
+#include <iomanip>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <utility>
+
+#ifdef _WIN32
+#include <direct.h>
+#endif
+
+namespace idealgas {
+
+using glm::vec2;
+using std::map;
+using std::string;
+using std::vector;
+
+const string EquilibriumLibrary::kStateFileSuffix = ".snapshot";
+constexpr uint32_t EquilibriumLibrary::kHashVersion;
+
+/**
+ * Folds the bytes of a value into a hash.
+ * @param value - the value to hash
+ * @param hash - the hash of everything before the value
+ * @return the hash including the value
+ */
+template <typename T>
+static uint64_t HashValue(const T& value, uint64_t hash) {
+  return ScenarioCache::HashBytes(reinterpret_cast<const char*>(&value),
+                                  sizeof(value), hash);
+}
+
+EquilibriumLibrary::EquilibriumLibrary(const string& directory_path,
+                                       uint64_t scenario_hash)
+    : directory_path_(directory_path), scenario_hash_(scenario_hash) {}
+
+bool EquilibriumLibrary::HasState() const {
+  struct stat state_status;
+  return stat(FindStatePath().c_str(), &state_status) == 0;
+}
+
+GasContainer EquilibriumLibrary::LoadState() const {
+  return snapshot_manager_.LoadContainerFromSnapshot(FindStatePath());
+}
+
+void EquilibriumLibrary::StoreState(
+    const GasContainer& container,
+    const SaveWorker::CompletionCallback& on_complete) {
+  // An existing directory is fine, and any other failure fails the write
+#ifdef _WIN32
+  _mkdir(directory_path_.c_str());
+#else
+  mkdir(directory_path_.c_str(), 0755);
+#endif
+
+  std::shared_ptr<GasContainer> stored_container =
+      std::make_shared<GasContainer>(container.GetParticles(),
+                                     container.GetParticleSpecifications());
+  SnapshotManager snapshot_manager = snapshot_manager_;
+
+  SaveWorker::WriteTask write_state =
+      [stored_container, snapshot_manager](const string& path) {
+    snapshot_manager.WriteContainerToSnapshot(*stored_container, path);
+  };
+  save_worker_.Enqueue(FindStatePath(), write_state, on_complete);
+}
+
+SaveStatus EquilibriumLibrary::GetStoreStatus() const {
+  return save_worker_.GetStatus();
+}
+
+void EquilibriumLibrary::WaitForStores() {
+  save_worker_.WaitUntilIdle();
+}
+
+string EquilibriumLibrary::FindStatePath() const {
+  std::stringstream state_path;
+  state_path << directory_path_ << '/' << std::hex << std::setfill('0')
+             << std::setw(16) << scenario_hash_ << kStateFileSuffix;
+
+  return state_path.str();
+}
+
+uint64_t EquilibriumLibrary::HashScenario(
+    const map<string, ParticleSpecs>& particle_specifications,
+    const vector<ContainerSpecifications>& container_specifications) {
+  // Sum the counts and expected energies of each type, in order of name.
+  // Velocities are uniform in [-v, v] on both axes, so each particle's
+  // expected kinetic energy is m * v^2 / 3
+  map<string, std::pair<uint64_t, double>> type_totals;
+  for (const ContainerSpecifications& specs : container_specifications) {
+    if (specs.count == 0) {
+      continue;
+    }
+
+    const ParticleSpecs& type_specs =
+        particle_specifications.at(specs.particle_name);
+    std::pair<uint64_t, double>& totals = type_totals[specs.particle_name];
+    totals.first += specs.count;
+    totals.second += specs.count * static_cast<double>(type_specs.mass)
+                     * specs.max_velocity * specs.max_velocity / 3;
+  }
+
+  float bounds[] = {GasContainer::kContainerLeftBound,
+                    GasContainer::kContainerUpperBound,
+                    GasContainer::kContainerRightBound,
+                    GasContainer::kContainerLowerBound};
+
+  uint64_t hash = HashValue(kHashVersion, ScenarioCache::kHashOffsetBasis);
+  hash = HashValue(bounds, hash);
+
+  for (const auto& totals : type_totals) {
+    const ParticleSpecs& type_specs = particle_specifications.at(totals.first);
+
+    // The length keeps names from running into the values after them
+    hash = HashValue(static_cast<uint64_t>(totals.first.size()), hash);
+    hash = ScenarioCache::HashBytes(totals.first.data(), totals.first.size(),
+                                    hash);
+    hash = HashValue(type_specs.radius, hash);
+    hash = HashValue(type_specs.mass, hash);
+    hash = HashValue(totals.second.first, hash);
+    hash = HashValue(totals.second.second, hash);
+  }
+
+  return hash;
+}
+
+GasContainer EquilibriumLibrary::RandomizeVelocities(
+    const GasContainer& container, uint64_t seed) {
+  vector<GasParticle> particles = container.GetParticles();
+  if (particles.empty()) {
+    return GasContainer(particles, container.GetParticleSpecifications());
+  }
+
+  double kinetic_energy = 0;
+  for (const GasParticle& particle : particles) {
+    const vec2& velocity = particle.GetVelocity();
+    kinetic_energy += 0.5 * particle.GetMass()
+                      * glm::dot(velocity, velocity);
+  }
+
+  // In 2D with a Boltzmann constant of 1, the temperature is KE / N, and each
+  // velocity component is normal with a variance of T / m
+  double temperature = kinetic_energy / particles.size();
+  double new_kinetic_energy = 0;
+
+  for (size_t idx = 0; idx < particles.size(); idx++) {
+    CounterRng random(seed, 0, idx);
+    double deviation = std::sqrt(temperature / particles[idx].GetMass());
+
+    // Box-Muller turns 2 uniform numbers into 2 independent normal ones
+    double uniform_radius = 1 - random.NextFloat(0, 1);
+    double angle = random.NextFloat(0, 2 * static_cast<float>(M_PI));
+    double normal_radius = std::sqrt(-2 * std::log(uniform_radius));
+    vec2 velocity(
+        static_cast<float>(deviation * normal_radius * std::cos(angle)),
+        static_cast<float>(deviation * normal_radius * std::sin(angle)));
+
+    particles[idx].SetVelocity(velocity);
+    new_kinetic_energy += 0.5 * particles[idx].GetMass()
+                          * glm::dot(velocity, velocity);
+  }
+
+  // Sampling noise would otherwise change the energy of the gas
+  if (new_kinetic_energy > 0) {
+    float scale =
+        static_cast<float>(std::sqrt(kinetic_energy / new_kinetic_energy));
+    for (GasParticle& particle : particles) {
+      particle.SetVelocity(particle.GetVelocity() * scale);
+    }
+  }
+
+  return GasContainer(std::move(particles),
+                      container.GetParticleSpecifications());
+}
+
+}  // namespace idealgas
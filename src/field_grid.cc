@@ -0,0 +1,216 @@
+//
+// Created by Neil Kaushikkar on 5/24/21.
+//
+
+#include "field_grid.h"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+
+namespace idealgas {
+
+using glm::vec2;
+using std::string;
+using std::vector;
+
+const char FieldGrid::kFileSignature[4] = {'I', 'G', 'F', 'G'};
+constexpr uint32_t FieldGrid::kFileVersion;
+
+FieldGrid::FieldGrid(size_t column_count, size_t row_count,
+                     size_t deposit_interval, bool is_time_averaged,
+                     size_t worker_count)
+    : column_count_(column_count), row_count_(row_count),
+      deposit_interval_(deposit_interval),
+      is_time_averaged_(is_time_averaged), worker_count_(worker_count),
+      frames_seen_(0), deposit_count_(0), region_() {
+  if (column_count == 0 || row_count == 0 || deposit_interval == 0
+      || worker_count == 0) {
+    throw std::invalid_argument("The grid dimensions, deposit interval, and "
+                                "worker count must be at least 1.");
+  }
+
+  size_t cell_count = column_count * row_count;
+  CellMoments empty_cell = {0, 0, 0, 0, 0};
+
+  moments_.assign(cell_count, empty_cell);
+  worker_moments_.assign(worker_count, vector<CellMoments>(cell_count,
+                                                           empty_cell));
+  density_.assign(cell_count, 0);
+  velocity_.assign(cell_count, vec2(0, 0));
+  temperature_.assign(cell_count, 0);
+}
+
+void FieldGrid::Deposit(const GasContainer& container) {
+  // Only deposit on every deposit_interval-th frame
+  if (frames_seen_++ % deposit_interval_ != 0) {
+    return;
+  }
+
+  const vector<GasParticle>& particles = container.GetParticles();
+  region_ = container.GetWallBound();
+
+  ParallelFor(particles.size(), worker_count_,
+              [&](size_t particle_begin, size_t particle_end, size_t worker) {
+    vector<CellMoments>& moments = worker_moments_[worker];
+
+    for (size_t idx = particle_begin; idx < particle_end; idx++) {
+      const GasParticle& particle = particles[idx];
+      const vec2& position = particle.GetPosition();
+
+      // A position that isn't finite isn't in any cell
+      if (!std::isfinite(position.x) || !std::isfinite(position.y)) {
+        continue;
+      }
+
+      const vec2& velocity = particle.GetVelocity();
+      float mass = particle.GetMass();
+
+      CellMoments& cell = moments[FindCell(position)];
+      cell.particle_count++;
+      cell.mass += mass;
+      cell.momentum_x += mass * velocity.x;
+      cell.momentum_y += mass * velocity.y;
+      cell.twice_kinetic_energy += mass * glm::dot(velocity, velocity);
+    }
+  });
+
+  if (!is_time_averaged_) {
+    CellMoments empty_cell = {0, 0, 0, 0, 0};
+    std::fill(moments_.begin(), moments_.end(), empty_cell);
+    deposit_count_ = 0;
+  }
+
+  // Summing and clearing the private grids leaves them ready for next deposit
+  ParallelFor(moments_.size(), worker_count_,
+              [&](size_t cell_begin, size_t cell_end, size_t) {
+    for (vector<CellMoments>& worker_moments : worker_moments_) {
+      for (size_t cell = cell_begin; cell < cell_end; cell++) {
+        CellMoments& worker_cell = worker_moments[cell];
+        CellMoments& total_cell = moments_[cell];
+
+        total_cell.particle_count += worker_cell.particle_count;
+        total_cell.mass += worker_cell.mass;
+        total_cell.momentum_x += worker_cell.momentum_x;
+        total_cell.momentum_y += worker_cell.momentum_y;
+        total_cell.twice_kinetic_energy += worker_cell.twice_kinetic_energy;
+
+        worker_cell = {0, 0, 0, 0, 0};
+      }
+    }
+  });
+
+  deposit_count_++;
+  ComputeFields();
+}
+
+void FieldGrid::Reset() {
+  CellMoments empty_cell = {0, 0, 0, 0, 0};
+  std::fill(moments_.begin(), moments_.end(), empty_cell);
+
+  frames_seen_ = 0;
+  deposit_count_ = 0;
+  ComputeFields();
+}
+
+size_t FieldGrid::GetColumnCount() const {
+  return column_count_;
+}
+
+size_t FieldGrid::GetRowCount() const {
+  return row_count_;
+}
+
+size_t FieldGrid::GetDepositCount() const {
+  return deposit_count_;
+}
+
+const vector<float>& FieldGrid::GetDensity() const {
+  return density_;
+}
+
+const vector<vec2>& FieldGrid::GetVelocity() const {
+  return velocity_;
+}
+
+const vector<float>& FieldGrid::GetTemperature() const {
+  return temperature_;
+}
+
+void FieldGrid::WriteFields(const string& file_path) const {
+  std::ofstream output_file(file_path, std::ios::binary | std::ios::trunc);
+  if (!output_file.is_open()) {
+    throw std::invalid_argument("The file path is not valid");
+  }
+
+  uint32_t dimensions[2] = {static_cast<uint32_t>(column_count_),
+                            static_cast<uint32_t>(row_count_)};
+  float corners[4] = {region_.getX1(), region_.getY1(), region_.getX2(),
+                      region_.getY2()};
+  uint64_t deposit_count = deposit_count_;
+
+  output_file.write(kFileSignature, sizeof(kFileSignature));
+  output_file.write(reinterpret_cast<const char*>(&kFileVersion),
+                    sizeof(kFileVersion));
+  output_file.write(reinterpret_cast<const char*>(dimensions),
+                    sizeof(dimensions));
+  output_file.write(reinterpret_cast<const char*>(corners), sizeof(corners));
+  output_file.write(reinterpret_cast<const char*>(&deposit_count),
+                    sizeof(deposit_count));
+
+  // glm::vec2 is 2 packed floats, so the velocities can be written directly
+  output_file.write(reinterpret_cast<const char*>(density_.data()),
+                    density_.size() * sizeof(float));
+  output_file.write(reinterpret_cast<const char*>(velocity_.data()),
+                    velocity_.size() * sizeof(vec2));
+  output_file.write(reinterpret_cast<const char*>(temperature_.data()),
+                    temperature_.size() * sizeof(float));
+}
+
+size_t FieldGrid::FindCell(const vec2& position) const {
+  float cell_width = region_.getWidth() / column_count_;
+  float cell_height = region_.getHeight() / row_count_;
+
+  float column = std::floor((position.x - region_.getX1()) / cell_width);
+  float row = std::floor((position.y - region_.getY1()) / cell_height);
+
+  // Particles touching the far walls would otherwise fall just off the grid.
+  // Clamping before the cast keeps it defined, and NaN fails both comparisons
+  // so it lands in the first cell rather than being cast.
+  column = column > 0 ? std::min(column, column_count_ - 1.0f) : 0;
+  row = row > 0 ? std::min(row, row_count_ - 1.0f) : 0;
+
+  return static_cast<size_t>(row) * column_count_ + static_cast<size_t>(column);
+}
+
+void FieldGrid::ComputeFields() {
+  float cell_area = region_.getWidth() * region_.getHeight()
+                    / (column_count_ * row_count_);
+
+  for (size_t cell = 0; cell < moments_.size(); cell++) {
+    const CellMoments& moments = moments_[cell];
+    if (moments.particle_count == 0 || deposit_count_ == 0) {
+      density_[cell] = 0;
+      velocity_[cell] = vec2(0, 0);
+      temperature_[cell] = 0;
+      continue;
+    }
+
+    density_[cell] = static_cast<float>(
+        moments.particle_count / (deposit_count_ * cell_area));
+
+    double velocity_x = moments.momentum_x / moments.mass;
+    double velocity_y = moments.momentum_y / moments.mass;
+    velocity_[cell] = vec2(velocity_x, velocity_y);
+
+    // Subtracting the bulk flow leaves the thermal energy, which is N T in 2D
+    double bulk_energy = moments.mass * (velocity_x * velocity_x
+                                         + velocity_y * velocity_y);
+    double thermal_energy =
+        std::max(0.0, moments.twice_kinetic_energy - bulk_energy) / 2;
+    temperature_[cell] =
+        static_cast<float>(thermal_energy / moments.particle_count);
+  }
+}
+
+}  // namespace idealgas
@@ -16,18 +16,48 @@ GasContainer::GasContainer()
       wall_bound_(vec2(kContainerLeftBound, kContainerUpperBound),
                   vec2(kContainerRightBound, kContainerLowerBound)) {}
 
-GasContainer::GasContainer(const vector<GasParticle>& particles,
-                           const map<string, ParticleSpecs>& specifications)
-    : all_particles_(particles),
-      particle_specifications_(specifications),
+GasContainer::GasContainer(vector<GasParticle> particles,
+                           map<string, ParticleSpecs> specifications)
+    : all_particles_(std::move(particles)),
+      particle_specifications_(std::move(specifications)),
       wall_color_(kWallColor),
       wall_bound_(vec2(kContainerLeftBound, kContainerUpperBound),
-                  vec2(kContainerRightBound, kContainerLowerBound)) {}
+                  vec2(kContainerRightBound, kContainerLowerBound)) {
+  IndexParticlesByType();
+}
 
 void GasContainer::Configure() {
   for (GasParticle& particle : all_particles_) {
     particle.Configure(particle_specifications_.at(particle.GetTypeName()));
   }
+
+  IndexParticlesByType();
+}
+
+void GasContainer::IndexParticlesByType() {
+  particle_indices_by_type_.clear();
+  is_spatial_index_current_ = false;
+
+  for (size_t idx = 0; idx < all_particles_.size(); idx++) {
+    particle_indices_by_type_[all_particles_[idx].GetTypeName()].push_back(idx);
+  }
+
+  vector<string> type_names;
+  vector<size_t> type_counts;
+  particle_type_ids_.assign(all_particles_.size(), 0);
+
+  for (const auto& type_indices : particle_indices_by_type_) {
+    for (size_t idx : type_indices.second) {
+      particle_type_ids_[idx] = type_names.size();
+    }
+
+    type_names.push_back(type_indices.first);
+    type_counts.push_back(type_indices.second.size());
+  }
+
+  path_lengths_since_collision_.assign(all_particles_.size(), 0);
+  frame_collision_tally_ = CollisionStatistics(type_names, type_counts);
+  collision_statistics_ = CollisionStatistics(type_names, type_counts);
 }
 
 void GasContainer::Display() const {
@@ -43,17 +73,135 @@ vector<GasParticle> GasContainer::GetAllParticles() const {
   return all_particles_;
 }
 
+const vector<GasParticle>& GasContainer::GetParticles() const {
+  return all_particles_;
+}
+
+ParticleView GasContainer::GetParticlesOfType(const string& type_name) const {
+  // Types without any particles share one empty index list
+  static const vector<size_t> kNoParticleIndices;
+
+  auto type_indices = particle_indices_by_type_.find(type_name);
+  if (type_indices == particle_indices_by_type_.end()) {
+    return ParticleView(all_particles_, kNoParticleIndices);
+  }
+
+  return ParticleView(all_particles_, type_indices->second);
+}
+
+vector<string> GasContainer::GetParticleTypeNames() const {
+  vector<string> type_names;
+  for (const auto& type_indices : particle_indices_by_type_) {
+    type_names.push_back(type_indices.first);
+  }
+
+  return type_names;
+}
+
+const ci::Rectf& GasContainer::GetWallBound() const {
+  return wall_bound_;
+}
+
+const map<string, ParticleSpecs>&
+GasContainer::GetParticleSpecifications() const {
+  return particle_specifications_;
+}
+
+const SpatialIndex& GasContainer::GetSpatialIndex() const {
+  if (!is_spatial_index_current_) {
+    spatial_index_.Build(all_particles_, wall_bound_);
+    is_spatial_index_current_ = true;
+  }
+
+  return spatial_index_;
+}
+
+const FrameObservables& GasContainer::GetObservables() const {
+  return observables_;
+}
+
+const CollisionStatistics& GasContainer::GetCollisionStatistics() const {
+  return collision_statistics_;
+}
+
+void GasContainer::SetCollisionEventStream(CollisionEventStream* stream) {
+  collision_event_stream_ = stream;
+}
+
 void GasContainer::AdvanceOneFrame() {
+  // Containers loaded from json without being configured are indexed here
+  if (particle_type_ids_.size() != all_particles_.size()) {
+    IndexParticlesByType();
+  }
+
+  observables_.wall_impulses.fill(0);
+  frame_collision_tally_.Clear();
+  is_spatial_index_current_ = false;
+
   HandleParticleWallInteractions();
   HandleMultiParticleInteractions();
 
-  for (GasParticle& particle : all_particles_) {
+  // Accumulate in double so large containers don't lose small contributions
+  double kinetic_energy = 0;
+  double momentum_x = 0;
+  double momentum_y = 0;
+
+  for (size_t idx = 0; idx < all_particles_.size(); idx++) {
+    GasParticle& particle = all_particles_[idx];
     particle.UpdatePosition();
+
+    const vec2& velocity = particle.GetVelocity();
+    path_lengths_since_collision_[idx] += glm::length(velocity);
+
+    float mass = particle.GetMass();
+    kinetic_energy += 0.5 * mass * glm::dot(velocity, velocity);
+    momentum_x += mass * velocity[kXAxis];
+    momentum_y += mass * velocity[kYAxis];
   }
+
+  RecordFrameObservables(kinetic_energy, vec2(momentum_x, momentum_y));
+
+  frame_collision_tally_.RecordFrame();
+  collision_statistics_.Merge(frame_collision_tally_);
+}
+
+void GasContainer::RecordFrameObservables(double kinetic_energy,
+                                          const vec2& momentum) {
+  observables_.frame++;
+  observables_.particle_count = all_particles_.size();
+  observables_.kinetic_energy = static_cast<float>(kinetic_energy);
+  observables_.momentum = momentum;
+
+  // Each particle has 2 degrees of freedom, so KE = N * T with k_B = 1
+  if (all_particles_.empty()) {
+    observables_.temperature = 0;
+  } else {
+    observables_.temperature =
+        static_cast<float>(kinetic_energy / all_particles_.size());
+  }
+
+  float horizontal_wall_length = kContainerRightBound - kContainerLeftBound;
+  float vertical_wall_length = kContainerLowerBound - kContainerUpperBound;
+  std::array<float, kWallCount> wall_lengths = {{
+      horizontal_wall_length, horizontal_wall_length,
+      vertical_wall_length, vertical_wall_length}};
+
+  // One frame is one unit of time, so the impulse on a wall is its force
+  float total_impulse = 0;
+  for (size_t wall = 0; wall < kWallCount; wall++) {
+    observables_.wall_pressures[wall] =
+        observables_.wall_impulses[wall] / wall_lengths[wall];
+    total_impulse += observables_.wall_impulses[wall];
+  }
+
+  float perimeter = 2 * (horizontal_wall_length + vertical_wall_length);
+  observables_.pressure = total_impulse / perimeter;
 }
 
 void GasContainer::HandleParticleWallInteractions() {
-  for (GasParticle& particle : all_particles_) {
+  for (size_t idx = 0; idx < all_particles_.size(); idx++) {
+    GasParticle& particle = all_particles_[idx];
+
     bool is_colliding_at_vertical_walls = IsParticleCollidingWithAnyWallsOnAxis(
         particle, kXAxis, kContainerLeftBound, kContainerRightBound);
 
@@ -61,29 +209,28 @@ void GasContainer::HandleParticleWallInteractions() {
         IsParticleCollidingWithAnyWallsOnAxis(particle, kYAxis,
           kContainerUpperBound, kContainerLowerBound);
 
-    particle.SetVelocity(CalculateParticleVelocityAfterWallCollision(particle,
-      is_colliding_at_vertical_walls, is_colliding_at_horizontal_walls));
-  }
-}
-
-vec2 GasContainer::CalculateParticleVelocityAfterWallCollision(
-    const GasParticle& particle, bool is_collision_at_vertical_wall,
-    bool is_collision_at_horizontal_wall) {
+    // A bounce reverses one velocity component, transferring twice its momentum
+    const vec2& velocity = particle.GetVelocity();
+    if (is_colliding_at_vertical_walls) {
+      size_t wall = velocity[kXAxis] < 0 ? kLeftWall : kRightWall;
+      float impulse = 2 * particle.GetMass() * std::abs(velocity[kXAxis]);
 
-  vec2 initial_velo = particle.GetVelocity();
-  vec2 new_velocity = vec2(initial_velo);
+      observables_.wall_impulses[wall] += impulse;
+      PublishCollisionEvent(CollisionEventKind::kWallCollision, idx, wall,
+                            impulse, particle.GetPosition());
+      particle.ReflectOffWall(kXAxis);
+    }
 
-  // if colliding w/ vertical, invert x-velo by multiplying x component by -1
-  if (is_collision_at_vertical_wall) {
-    new_velocity[kXAxis] = initial_velo[kXAxis] * -1;
-  }
+    if (is_colliding_at_horizontal_walls) {
+      size_t wall = velocity[kYAxis] < 0 ? kUpperWall : kLowerWall;
+      float impulse = 2 * particle.GetMass() * std::abs(velocity[kYAxis]);
 
-  // if colliding w/ horizontal, invert y-velo by multiplying y component by -1
-  if (is_collision_at_horizontal_wall) {
-    new_velocity[kYAxis] = initial_velo[kYAxis] * -1;
+      observables_.wall_impulses[wall] += impulse;
+      PublishCollisionEvent(CollisionEventKind::kWallCollision, idx, wall,
+                            impulse, particle.GetPosition());
+      particle.ReflectOffWall(kYAxis);
+    }
   }
-
-  return new_velocity;
 }
 
 bool GasContainer::IsParticleCollidingWithAnyWallsOnAxis(
@@ -126,13 +273,53 @@ void GasContainer::HandleMultiParticleInteractions() {
         vec2 particle_two_new_velocity =
             CalculateParticleVelocityAfterCollision(particle_two, particle_one);
 
+        if (collision_event_stream_ != nullptr) {
+          float impulse = particle_one.GetMass() * glm::length(
+              particle_one_new_velocity - particle_one.GetVelocity());
+          vec2 midpoint =
+              (particle_one.GetPosition() + particle_two.GetPosition()) * 0.5f;
+          PublishCollisionEvent(CollisionEventKind::kParticleCollision, i, k,
+                                impulse, midpoint);
+        }
+
         particle_one.SetVelocity(particle_one_new_velocity);
         particle_two.SetVelocity(particle_two_new_velocity);
+        RecordParticleCollision(i, k);
       }
     }
   }
 }
 
+void GasContainer::RecordParticleCollision(size_t particle_one_idx,
+                                           size_t particle_two_idx) {
+  size_t type_one = particle_type_ids_[particle_one_idx];
+  size_t type_two = particle_type_ids_[particle_two_idx];
+  frame_collision_tally_.RecordCollision(type_one, type_two);
+
+  frame_collision_tally_.RecordFreePath(
+      type_one, path_lengths_since_collision_[particle_one_idx]);
+  frame_collision_tally_.RecordFreePath(
+      type_two, path_lengths_since_collision_[particle_two_idx]);
+
+  path_lengths_since_collision_[particle_one_idx] = 0;
+  path_lengths_since_collision_[particle_two_idx] = 0;
+}
+
+void GasContainer::PublishCollisionEvent(CollisionEventKind kind,
+                                         size_t particle_id, size_t other_id,
+                                         float impulse,
+                                         const vec2& position) const {
+  if (collision_event_stream_ == nullptr) {
+    return;
+  }
+
+  // Events are stamped with the number of frames completed before this one
+  CollisionEvent event = {
+      observables_.frame, kind, static_cast<uint32_t>(particle_id),
+      static_cast<uint32_t>(other_id), impulse, position.x, position.y};
+  collision_event_stream_->Publish(event);
+}
+
 bool GasContainer::AreParticlesColliding(const GasParticle& particle_one,
                                          const GasParticle& particle_two)  {
   vec2 velocity_difference = particle_one.GetVelocity()
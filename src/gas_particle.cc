@@ -29,6 +29,14 @@ void GasParticle::Configure(const ParticleSpecs& specs) {
 
 void GasParticle::UpdatePosition() {
   position_ += velocity_;
+
+  // In the unfolded space a bounce never happened, so undo each mirroring
+  unwrapped_displacement_ += velocity_ * unwrapped_axis_signs_;
+}
+
+void GasParticle::ReflectOffWall(size_t axis_index) {
+  velocity_[axis_index] *= -1;
+  unwrapped_axis_signs_[axis_index] *= -1;
 }
 
 void GasParticle::DrawParticle() const {
@@ -44,6 +52,10 @@ const glm::vec2& GasParticle::GetVelocity() const {
   return velocity_;
 }
 
+const glm::vec2& GasParticle::GetUnwrappedDisplacement() const {
+  return unwrapped_displacement_;
+}
+
 const glm::vec2& GasParticle::GetPosition() const {
   return position_;
 }
@@ -56,7 +68,7 @@ float GasParticle::GetMass() const {
   return mass_;
 }
 
-string GasParticle::GetTypeName() const {
+const string& GasParticle::GetTypeName() const {
     return particle_type_name_;
 }
 
@@ -1,28 +1,232 @@
 #include "gas_simulation_app.h"
 
+#include <chrono>
+
 namespace idealgas {
 
 using cinder::app::KeyEvent;
+using std::string;
+
+const char* IdealGasApp::kLoadingMessage = "Loading Simulation...";
 
-IdealGasApp::IdealGasApp() : engine_(SimulationEngine(true)) {
+IdealGasApp::IdealGasApp()
+    : is_interpolated_(true), reported_save_status_(SaveStatus::kIdle),
+      reported_library_store_status_(SaveStatus::kIdle) {
   ci::app::setWindowSize(kWindowWidth, kWindowHeight);
+
+  // Parsing and generating large scenarios takes a while, so it is done off
+  // of the app's thread to let the window draw in the meantime
+  engine_loader_ = std::async(std::launch::async, []() {
+    return std::unique_ptr<SimulationEngine>(new SimulationEngine(true));
+  });
 }
 
 void IdealGasApp::draw() {
   ci::Color background_color("black");
   ci::gl::clear(background_color);
 
-  engine_.Render();
+  if (replay_engine_) {
+    replay_engine_->Render();
+  } else if (runner_) {
+    runner_->Render(is_interpolated_);
+  } else if (!loading_error_.empty()) {
+    DrawCenteredMessage(loading_error_);
+  } else {
+    DrawCenteredMessage(kLoadingMessage);
+  }
 }
 
 void IdealGasApp::update() {
-  engine_.AdvanceToNextFrame();
+  SwapInLoadedEngine();
+  if (!engine_) {
+    return;
+  }
+
+  if (replay_engine_) {
+    replay_engine_->AdvanceToNextFrame();
+  }
+
+  SaveStatus save_status = runner_->GetSaveStatus();
+  if (save_status != reported_save_status_) {
+    if (save_status == SaveStatus::kSucceeded) {
+      console() << "Simulation Saved!" << std::endl;
+    } else if (save_status == SaveStatus::kFailed) {
+      console() << "Simulation could not be saved." << std::endl;
+    }
+
+    reported_save_status_ = save_status;
+  }
+
+  SaveStatus store_status = runner_->GetLibraryStoreStatus();
+  if (store_status != reported_library_store_status_) {
+    if (store_status == SaveStatus::kSucceeded) {
+      console() << "Equilibrated State Stored!" << std::endl;
+    } else if (store_status == SaveStatus::kFailed) {
+      console() << "The equilibrated state could not be stored." << std::endl;
+    }
+
+    reported_library_store_status_ = store_status;
+  }
 }
 
 void IdealGasApp::keyDown(KeyEvent event) {
-  if (event.getChar() == kSaveToJsonKey) {
-    engine_.SaveSimulation();
-    console() << "Simulation Saved!" << std::endl;
+  // There is nothing to control until the simulation loads
+  if (!engine_) {
+    return;
+  }
+
+  char key = event.getChar();
+
+  if (key == kReplayKey) {
+    ToggleReplay();
+  } else if (replay_engine_) {
+    HandleReplayKey(key);
+  } else if (key == kSaveToJsonKey) {
+    runner_->Post([](SimulationEngine& engine) {
+      engine.SaveSimulation();
+    });
+    console() << "Saving Simulation..." << std::endl;
+  } else if (key == kSaveToSnapshotKey) {
+    runner_->Post([](SimulationEngine& engine) {
+      engine.SaveSnapshot();
+    });
+    console() << "Saving Snapshot..." << std::endl;
+  } else if (key == kRecordTrajectoryKey) {
+    ToggleTrajectoryRecording();
+  } else if (key == kInterpolationKey) {
+    is_interpolated_ = !is_interpolated_;
+  } else {
+    ChangeStepRate(key);
+  }
+}
+
+void IdealGasApp::SwapInLoadedEngine() {
+  if (!engine_loader_.valid()
+      || engine_loader_.wait_for(std::chrono::seconds(0))
+         != std::future_status::ready) {
+    return;
+  }
+
+  try {
+    engine_ = engine_loader_.get();
+    runner_.reset(new EngineRunner(*engine_, kDefaultStepRate));
+    console() << "Simulation Loaded!" << std::endl;
+  } catch (const std::exception& error) {
+    loading_error_ =
+        string("Simulation could not be loaded: ") + error.what();
+    console() << loading_error_ << std::endl;
+  }
+}
+
+void IdealGasApp::DrawCenteredMessage(const string& message) const {
+  ci::gl::drawStringCentered(
+      message, glm::vec2(kWindowWidth / 2, kWindowHeight / 2));
+}
+
+void IdealGasApp::ChangeStepRate(char key) {
+  double step_rate = runner_->GetTargetStepRate();
+
+  if (key == kUnlimitedStepRateKey
+      && step_rate == EngineRunner::kUnlimitedStepRate) {
+    step_rate = kDefaultStepRate;
+  } else if (key == kUnlimitedStepRateKey) {
+    step_rate = EngineRunner::kUnlimitedStepRate;
+  } else if (step_rate == EngineRunner::kUnlimitedStepRate) {
+    // There is no rate to scale while stepping as fast as possible
+    return;
+  } else if (key == kStepFasterKey) {
+    step_rate *= kStepRateFactor;
+  } else if (key == kStepSlowerKey) {
+    step_rate /= kStepRateFactor;
+  } else {
+    return;
+  }
+
+  runner_->SetTargetStepRate(step_rate);
+  if (step_rate == EngineRunner::kUnlimitedStepRate) {
+    console() << "Stepping as fast as possible" << std::endl;
+  } else {
+    console() << "Stepping " << step_rate << " times a second" << std::endl;
+  }
+}
+
+void IdealGasApp::ToggleTrajectoryRecording() {
+  // The engine is only touched on the simulation thread, between steps
+  bool was_recording = false;
+  std::future<void> toggled =
+      runner_->Post([&was_recording](SimulationEngine& engine) {
+    was_recording = engine.GetTrajectoryWriter() != nullptr;
+    if (was_recording) {
+      engine.StopTrajectoryRecording();
+    } else {
+      engine.StartTrajectoryRecording(SimulationEngine::kTrajectoryFilePath,
+                                      kTrajectoryPrecision,
+                                      kTrajectoryKeyframeInterval);
+    }
+  });
+
+  try {
+    toggled.get();
+    if (was_recording) {
+      console() << "Trajectory Recorded!" << std::endl;
+    } else {
+      console() << "Recording Trajectory..." << std::endl;
+    }
+  } catch (const std::invalid_argument& error) {
+    console() << "Trajectory could not be recorded: " << error.what()
+              << std::endl;
+  }
+}
+
+void IdealGasApp::ToggleReplay() {
+  if (replay_engine_) {
+    replay_engine_.reset();
+    runner_->Resume();
+    console() << "Returning to Simulation" << std::endl;
+    return;
+  }
+
+  // Finish the trajectory file so it can be replayed up to the latest frame
+  runner_->Pause();
+  std::future<void> stopped = runner_->Post([](SimulationEngine& engine) {
+    engine.StopTrajectoryRecording();
+  });
+
+  try {
+    stopped.get();
+    replay_engine_.reset(
+        new ReplayEngine(SimulationEngine::kTrajectoryFilePath));
+    console() << "Replaying Trajectory" << std::endl;
+  } catch (const std::invalid_argument& error) {
+    runner_->Resume();
+    console() << "Trajectory could not be replayed: " << error.what()
+              << std::endl;
+  }
+}
+
+void IdealGasApp::HandleReplayKey(char key) {
+  size_t current_frame = replay_engine_->GetCurrentFrame();
+
+  if (key == kPlayPauseKey) {
+    if (replay_engine_->IsPlaying()) {
+      replay_engine_->Pause();
+    } else {
+      replay_engine_->Play();
+    }
+  } else if (key == kReverseKey) {
+    replay_engine_->Reverse();
+  } else if (key == kSpeedUpKey) {
+    replay_engine_->SetSpeed(replay_engine_->GetSpeed() * kReplaySpeedFactor);
+  } else if (key == kSlowDownKey) {
+    replay_engine_->SetSpeed(replay_engine_->GetSpeed() / kReplaySpeedFactor);
+  } else if (key == kStepBackKey && current_frame > 0) {
+    replay_engine_->Pause();
+    replay_engine_->Seek(current_frame - 1);
+  } else if (key == kStepForwardKey) {
+    replay_engine_->Pause();
+    replay_engine_->Seek(current_frame + 1);
+  } else if (key == kSeekToStartKey) {
+    replay_engine_->Seek(0);
   }
 }
 
@@ -9,15 +9,22 @@ using glm::vec2;
 
 // Define the non literal static variables
 const char* Histogram::kGraphBoundColor = "white";
-const string Histogram::kXAxisLabelStart = "Speed (pixels/frame) for \"";
+const string Histogram::kDefaultQuantityLabel = "Speed (pixels/frame)";
+const string Histogram::kXAxisLabelDataPrefix = " for \"";
 const string Histogram::kXAxisLabelEnd = "\" Particles";
 const string Histogram::kYAxisLabel = "Frequency";
 
 Histogram::Histogram(const string& label, size_t num_bins, float single_bin_range,
                      float top_left_x, float top_left_y,
-                     const ci::Color8u& color, float min_value) :
-      data_label_(label), color_(color), bin_values_(), minimum_value_(min_value),
+                     const ci::Color8u& color, float min_value,
+                     const string& quantity_label) :
+      data_label_(label), quantity_label_(quantity_label), color_(color),
+      bin_values_(), minimum_value_(min_value),
       single_bin_range_span_(single_bin_range),
+      configured_minimum_value_(min_value),
+      configured_single_bin_range_(single_bin_range),
+      is_auto_ranging_(false), has_observed_values_(false),
+      observed_minimum_value_(0), observed_maximum_value_(0),
       bin_display_height_increment_(kDefaultBinHeightIncrement),
       upper_left_x_coordinate_(top_left_x),
       upper_left_y_coordinate_(top_left_y),
@@ -37,9 +44,10 @@ Histogram::Histogram(const string& label, size_t num_bins, float single_bin_rang
 
   bin_display_width_ = graph_bounding_box_width_ / num_bins;
   vector<size_t>(num_bins, 0).swap(bin_values_);
+  vector<size_t>(num_bins, 0).swap(merged_bin_values_);
 }
 
-std::string Histogram::GetDataLabel() const {
+const std::string& Histogram::GetDataLabel() const {
   return data_label_;
 }
 
@@ -47,31 +55,107 @@ std::vector<size_t> Histogram::GetBinValues() const {
   return bin_values_;
 }
 
+const std::vector<size_t>& Histogram::GetBins() const {
+  return bin_values_;
+}
+
 void Histogram::UpdateBinDistribution(const std::vector<float>& updated_values) {
-  // make a shallow copy of all values in the vector so we can sort it in place
-  vector<float> sorted_values;
-  sorted_values.assign(updated_values.begin(), updated_values.end());
+  ResetBins();
 
-  // sort values first so we only go through bins and values once sequentially
-  std::sort(sorted_values.begin(), sorted_values.end(), std::less<float>());
+  for (float value : updated_values) {
+    AddValue(value);
+  }
+}
 
-  // reset the bin counts to 0, so we can fill it up again
-  vector<size_t>(bin_values_.size(), 0).swap(bin_values_);
+void Histogram::ResetBins() {
+  std::fill(bin_values_.begin(), bin_values_.end(), 0);
 
-  size_t value_idx = 0;
+  if (is_auto_ranging_ && has_observed_values_) {
+    // Start over from the configured range so the histogram can also shrink
+    minimum_value_ = configured_minimum_value_;
+    single_bin_range_span_ = configured_single_bin_range_;
 
-  // Go through each bin in the histogram...
-  for (size_t bin_idx = 0; bin_idx < bin_values_.size(); bin_idx++) {
-    // The 0th bin ends at value <single_bin_range_span_>, so add 1 to get end
-    while (value_idx < sorted_values.size() &&
-           sorted_values[value_idx] <= (bin_idx + 1) * single_bin_range_span_) {
-      // ...and update bin as long as there is a value small enough to fit in it
-      if (sorted_values[value_idx] >= minimum_value_) {
-        bin_values_[bin_idx]++;
-      }
-      value_idx++;
+    ExpandRangeToInclude(observed_minimum_value_);
+    ExpandRangeToInclude(observed_maximum_value_);
+    has_observed_values_ = false;
+  }
+}
+
+void Histogram::SetAutoRanging(bool is_auto_ranging) {
+  is_auto_ranging_ = is_auto_ranging;
+  has_observed_values_ = false;
+}
+
+float Histogram::GetMinimumValue() const {
+  return minimum_value_;
+}
+
+float Histogram::GetSingleBinRange() const {
+  return single_bin_range_span_;
+}
+
+void Histogram::AddValue(float value) {
+  if (is_auto_ranging_ && std::isfinite(value)) {
+    if (!has_observed_values_) {
+      observed_minimum_value_ = value;
+      observed_maximum_value_ = value;
+      has_observed_values_ = true;
+    }
+
+    observed_minimum_value_ = std::min(observed_minimum_value_, value);
+    observed_maximum_value_ = std::max(observed_maximum_value_, value);
+    ExpandRangeToInclude(value);
+  }
+
+  float offset = value - minimum_value_;
+  float range_span = bin_values_.size() * single_bin_range_span_;
+  if (offset < 0 || offset > range_span) {
+    return;
+  }
+
+  // Each bin includes its upper edge, so the 0th bin ends at the bin range
+  float bin_position = std::ceil(offset / single_bin_range_span_);
+  size_t bin_idx = bin_position > 1 ? static_cast<size_t>(bin_position) - 1 : 0;
+
+  // Division may round across a bin edge, so nudge the bin to match the edges
+  while (bin_idx > 0 && offset <= bin_idx * single_bin_range_span_) {
+    bin_idx--;
+  }
+  while (bin_idx + 1 < bin_values_.size()
+         && offset > (bin_idx + 1) * single_bin_range_span_) {
+    bin_idx++;
+  }
+
+  bin_values_[bin_idx]++;
+}
+
+void Histogram::ExpandRangeToInclude(float value) {
+  size_t bin_count = bin_values_.size();
+
+  // Compare offsets the same way AddValue does so that no value is dropped
+  while (value - minimum_value_ < 0
+         || value - minimum_value_ > bin_count * single_bin_range_span_) {
+    if (value < minimum_value_) {
+      // Grow downwards, so the old bins become the upper half of the new bins
+      minimum_value_ -= bin_count * single_bin_range_span_;
+      MergeAdjacentBins(bin_count);
+    } else {
+      MergeAdjacentBins(0);
     }
+
+    single_bin_range_span_ *= 2;
+  }
+}
+
+void Histogram::MergeAdjacentBins(size_t bin_offset) {
+  std::fill(merged_bin_values_.begin(), merged_bin_values_.end(), 0);
+
+  // Old bins are aligned to the new bin edges, so each fits in exactly 1 bin
+  for (size_t bin_idx = 0; bin_idx < bin_values_.size(); bin_idx++) {
+    merged_bin_values_[(bin_offset + bin_idx) / 2] += bin_values_[bin_idx];
   }
+
+  bin_values_.swap(merged_bin_values_);
 }
 
 void Histogram::Draw() const {
@@ -129,7 +213,8 @@ void Histogram::DrawXAxisTicksAndLabels() const {
     // Only label the tick if it is a multiple of the increment specified
     if (bin_idx % kXAxisTickDisplayIncrement == 0) {
       std::stringstream formatted_tick_label;
-      formatted_tick_label << (bin_idx * single_bin_range_span_);
+      formatted_tick_label
+          << (minimum_value_ + bin_idx * single_bin_range_span_);
 
       ci::gl::drawStringCentered(formatted_tick_label.str(),
         vec2(distance_from_origin, lower_right_y_coordinate_
@@ -168,7 +253,8 @@ void Histogram::DrawYAxisTicksAndLabels() const {
 }
 
 void Histogram::DrawAxisLabels() const {
-  string x_label = kXAxisLabelStart + data_label_ + kXAxisLabelEnd;
+  string x_label =
+      quantity_label_ + kXAxisLabelDataPrefix + data_label_ + kXAxisLabelEnd;
   // Center the x coordinate by averaging the 2 bounds
   float centered_x = (upper_left_x_coordinate_ + lower_right_x_coordinate_) / 2;
 
@@ -1,5 +1,9 @@
 #include "json_manager.h"
+#include "container_sax_handler.h"
+#include "equilibrium_library.h"
+#include <algorithm>
 #include <map>
+#include <random>
 
 namespace idealgas {
 
@@ -9,6 +13,10 @@ using glm::vec2;
 
 const string JsonManager::kJsonSchemaParticleTypesKey = "particle_types";
 const string JsonManager::kJsonSchemaParticleCountsKey = "particle_counts";
+const string JsonManager::kJsonSchemaHistogramsKey = "histograms";
+const string JsonManager::kJsonSchemaTracersKey = "tracers";
+const string JsonManager::kJsonSchemaSeedKey = "seed";
+const string JsonManager::kJsonSchemaPlacementKey = "placement";
 
 JsonManager::JsonManager() = default;
 
@@ -16,19 +24,30 @@ GasContainer JsonManager::LoadContainerFromJson(
     const string& json_file_path) const {
   ValidateFilePath(json_file_path);
 
-  // Code below adapted from https://stackoverflow.com/a/2602060
-  std::ifstream loaded_file(json_file_path);
-  json json_data;
-  loaded_file >> json_data;
+  // Count the particles first, so their storage is never regrown and holds
+  // no more than the particles
+  std::ifstream loaded_file(json_file_path, std::ios::binary);
+  size_t particle_count = ContainerSaxHandler::CountParticles(loaded_file);
+  loaded_file.clear();
+  loaded_file.seekg(0);
 
-  GasContainer container = json_data.get<GasContainer>();
-  container.Configure();
+  // Parse the particles straight into the container, without a json tree
+  ContainerSaxHandler handler(particle_count);
+  json::sax_parse(loaded_file, &handler);
 
-  return container;
+  return handler.BuildContainer();
 }
 
-GasContainer JsonManager::GenerateRandomContainerFromJson(
+GasContainer JsonManager::LoadContainerFromCachedJson(
     const string& json_file_path) const {
+  return scenario_cache_.LoadContainer(
+      json_file_path, [this](const string& file_path) {
+    return LoadContainerFromJson(file_path);
+  });
+}
+
+GasContainer JsonManager::GenerateRandomContainerFromJson(
+    const string& json_file_path, size_t worker_count) const {
   ValidateFilePath(json_file_path);
 
   // Load the file as json if the path is valid
@@ -41,32 +60,130 @@ GasContainer JsonManager::GenerateRandomContainerFromJson(
   auto container_specifications = json_data[kJsonSchemaParticleCountsKey]
                                       .get<std::vector<ContainerSpecifications>>();
 
-  std::vector<GasParticle> gas_particles;
-  ci::Rand random = ci::Rand();
+  // Without a seed in the file, every run generates a different container
+  uint64_t seed;
+  if (json_data.contains(kJsonSchemaSeedKey)) {
+    seed = json_data.at(kJsonSchemaSeedKey).get<uint64_t>();
+  } else {
+    std::random_device seed_source;
+    seed = (static_cast<uint64_t>(seed_source()) << 32) | seed_source();
+  }
+
+  // Find where each requested group of particles starts in the container
+  std::vector<size_t> group_offsets;
+  std::vector<const ParticleSpecs*> group_specs;
+  size_t particle_count = 0;
 
-  // Go through each particle type requested to create and create all of them
   for (const ContainerSpecifications& specs : container_specifications) {
-    for (size_t idx = 0; idx < specs.count; idx++) {
-      GasParticle particle = GenerateRandomParticle(
-          random, specs.max_velocity,
-          particle_specifications.at(specs.particle_name));
-      gas_particles.push_back(particle);
+    group_offsets.push_back(particle_count);
+    group_specs.push_back(&particle_specifications.at(specs.particle_name));
+    particle_count += specs.count;
+  }
+
+  // Overlapping particles would spend their first frames colliding apart
+  PlacementMode placement =
+      json_data.value(kJsonSchemaPlacementKey, PlacementMode::kUniform);
+  std::vector<vec2> placed_positions;
+
+  if (placement == PlacementMode::kPoissonDisk) {
+    std::vector<float> radii;
+    radii.reserve(particle_count);
+    for (size_t group = 0; group < group_specs.size(); group++) {
+      radii.insert(radii.end(), container_specifications[group].count,
+                   group_specs[group]->radius);
     }
+
+    PoissonDiskPlacer placer(
+        vec2(GasContainer::kContainerLeftBound,
+             GasContainer::kContainerUpperBound),
+        vec2(GasContainer::kContainerRightBound,
+             GasContainer::kContainerLowerBound), seed);
+    placed_positions = placer.Place(radii);
   }
 
-  return GasContainer(gas_particles, particle_specifications);
+  // Every particle only depends on its own index, so any chunk can be
+  // generated on any thread
+  std::vector<GasParticle> gas_particles(particle_count);
+  ParallelFor(particle_count, worker_count,
+              [&](size_t particle_begin, size_t particle_end, size_t) {
+    for (size_t idx = particle_begin; idx < particle_end; idx++) {
+      size_t group = std::upper_bound(group_offsets.begin(),
+                                      group_offsets.end(), idx)
+                     - group_offsets.begin() - 1;
+
+      CounterRng random(seed, static_cast<uint32_t>(group),
+                        idx - group_offsets[group]);
+      const ParticleSpecs& specs = *group_specs[group];
+      gas_particles[idx] = GenerateRandomParticle(
+          random, container_specifications[group].max_velocity, specs);
+
+      if (!placed_positions.empty()) {
+        gas_particles[idx] = GasParticle(
+            placed_positions[idx], gas_particles[idx].GetVelocity(), specs);
+      }
+    }
+  });
+
+  return GasContainer(std::move(gas_particles),
+                      std::move(particle_specifications));
+}
+
+std::vector<HistogramSpecifications>
+JsonManager::LoadHistogramSpecificationsFromJson(
+    const string& json_file_path) const {
+  ValidateFilePath(json_file_path);
+
+  std::ifstream loaded_file(json_file_path);
+  json json_data;
+  loaded_file >> json_data;
+
+  return json_data.at(kJsonSchemaHistogramsKey)
+      .get<std::vector<HistogramSpecifications>>();
+}
+
+std::vector<TracerSelector> JsonManager::LoadTracerSelectorsFromJson(
+    const string& json_file_path) const {
+  ValidateFilePath(json_file_path);
+
+  std::ifstream loaded_file(json_file_path);
+  json json_data;
+  loaded_file >> json_data;
+
+  if (!json_data.contains(kJsonSchemaTracersKey)) {
+    return {};
+  }
+
+  return json_data.at(kJsonSchemaTracersKey)
+      .get<std::vector<TracerSelector>>();
+}
+
+uint64_t JsonManager::HashScenarioFromJson(
+    const string& json_file_path) const {
+  ValidateFilePath(json_file_path);
+
+  std::ifstream loaded_file(json_file_path);
+  json json_data;
+  loaded_file >> json_data;
+
+  return EquilibriumLibrary::HashScenario(
+      json_data[kJsonSchemaParticleTypesKey]
+          .get<std::map<std::string, ParticleSpecs>>(),
+      json_data[kJsonSchemaParticleCountsKey]
+          .get<std::vector<ContainerSpecifications>>());
 }
 
 GasParticle JsonManager::GenerateRandomParticle(
-    ci::Rand& random, float max_velo, const ParticleSpecs& specifications) const {
+    CounterRng& random, float max_velo,
+    const ParticleSpecs& specifications) const {
   // velocity is a vec2 of values between -max_velocity and max_velocity
-  vec2 velocity = vec2(random.posNegFloat(0, max_velo),
-                       random.posNegFloat(0, max_velo));
+  float x_velocity = random.NextFloat(-max_velo, max_velo);
+  float y_velocity = random.NextFloat(-max_velo, max_velo);
+  vec2 velocity = vec2(x_velocity, y_velocity);
 
   // Generate a random position within the bounds of the container
-  float x_position = random.nextFloat(GasContainer::kContainerLeftBound,
+  float x_position = random.NextFloat(GasContainer::kContainerLeftBound,
                                       GasContainer::kContainerRightBound);
-  float y_position = random.nextFloat(GasContainer::kContainerUpperBound,
+  float y_position = random.NextFloat(GasContainer::kContainerUpperBound,
                                       GasContainer::kContainerLowerBound);
   vec2 position = vec2(x_position, y_position);
 
@@ -82,12 +199,21 @@ void JsonManager::ValidateFilePath(const string& file_path) {
 }
 
 void JsonManager::WriteContainerToJson(const GasContainer& container,
-                                       const string& save_file_path) const {
-  json serialized_container = container;
-
+                                       const string& save_file_path,
+                                       JsonLayout layout) const {
   // write the json to the saved file
   std::ofstream output_file(save_file_path);
-  output_file << std::setw(2) << serialized_container << std::endl;
+  if (!output_file.is_open()) {
+    throw std::invalid_argument("The file path is not valid");
+  }
+
+  ContainerJsonWriter(layout).Write(container, output_file);
+
+  // A short write, like on a full disk, must not pass as a complete save
+  output_file.close();
+  if (!output_file) {
+    throw std::invalid_argument("The saved file could not be written");
+  }
 }
 
 } // namespace idealgas
@@ -0,0 +1,84 @@
+//
+// Created by Neil Kaushikkar on 5/30/21.
+//
+
+#include "mapped_file.h"
+
+#include <stdexcept>
+
+#ifdef _WIN32
+#include <fstream>
+#include <iterator>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace idealgas {
+
+using std::string;
+
+MappedFile::MappedFile(const string& file_path) : data_(nullptr), size_(0) {
+#ifdef _WIN32
+  std::ifstream input_file(file_path, std::ios::binary);
+  if (!input_file.is_open()) {
+    throw std::invalid_argument("The file path is not valid");
+  }
+
+  buffer_.assign(std::istreambuf_iterator<char>(input_file),
+                 std::istreambuf_iterator<char>());
+  data_ = buffer_.data();
+  size_ = buffer_.size();
+#else
+  int file_descriptor = open(file_path.c_str(), O_RDONLY);
+  if (file_descriptor < 0) {
+    throw std::invalid_argument("The file path is not valid");
+  }
+
+  struct stat file_status;
+  if (fstat(file_descriptor, &file_status) != 0) {
+    close(file_descriptor);
+    throw std::invalid_argument("The file could not be read");
+  }
+
+  size_ = static_cast<size_t>(file_status.st_size);
+  if (size_ > 0) {
+    void* mapping = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE,
+                         file_descriptor, 0);
+    if (mapping == MAP_FAILED) {
+      close(file_descriptor);
+      throw std::invalid_argument("The file could not be mapped");
+    }
+
+    data_ = static_cast<const char*>(mapping);
+  }
+
+  // The mapping stays valid after the descriptor is closed
+  close(file_descriptor);
+#endif
+}
+
+MappedFile::~MappedFile() {
+#ifndef _WIN32
+  if (data_ != nullptr) {
+    munmap(const_cast<char*>(data_), size_);
+  }
+#endif
+}
+
+const char* MappedFile::GetData() const {
+  return data_;
+}
+
+size_t MappedFile::GetSize() const {
+  return size_;
+}
+
+bool MappedFile::IsRangeInFile(uint64_t offset, uint64_t length,
+                               uint64_t file_size) {
+  return offset <= file_size && length <= file_size - offset;
+}
+
+}  // namespace idealgas
@@ -0,0 +1,232 @@
+//
+// Created by Neil Kaushikkar on 5/18/21.
+//
+
+#include "pair_correlation.h"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace idealgas {
+
+using std::vector;
+using std::string;
+using glm::vec2;
+
+PairCorrelationAccumulator::PairCorrelationAccumulator(
+    float max_radius, size_t bin_count, size_t sample_interval,
+    size_t worker_count)
+    : max_radius_(max_radius), bin_count_(bin_count),
+      bin_width_(max_radius / bin_count), sample_interval_(sample_interval),
+      worker_count_(worker_count), frames_seen_(0), sample_count_(0) {
+  if (max_radius <= 0) {
+    throw std::invalid_argument("The maximum radius must be greater than 0.");
+  } else if (bin_count == 0) {
+    throw std::invalid_argument("The number of bins must be at least 1.");
+  } else if (sample_interval == 0 || worker_count == 0) {
+    throw std::invalid_argument("The sample interval and worker count must "
+                                "be at least 1.");
+  }
+
+  vec2 lower_corner(GasContainer::kContainerLeftBound,
+                    GasContainer::kContainerUpperBound);
+  vec2 upper_corner(GasContainer::kContainerRightBound,
+                    GasContainer::kContainerLowerBound);
+  cell_list_ = CellList(lower_corner, upper_corner, max_radius);
+}
+
+void PairCorrelationAccumulator::Sample(const GasContainer& container) {
+  // Only sample on every sample_interval-th frame
+  if (frames_seen_++ % sample_interval_ != 0) {
+    return;
+  }
+
+  const vector<GasParticle>& particles = container.GetParticles();
+  IndexParticleTypes(container);
+  cell_list_.Build(particles);
+
+  ParallelFor(cell_list_.GetRowCount(), worker_count_,
+              [&](size_t row_begin, size_t row_end, size_t worker) {
+    vector<uint64_t>& counts = worker_pair_counts_[worker];
+    std::fill(counts.begin(), counts.end(), 0);
+    CountPairsInRows(particles, row_begin, row_end, counts);
+  });
+
+  // Workers that got no rows still hold zeroed counts, so summing them is safe
+  for (const vector<uint64_t>& counts : worker_pair_counts_) {
+    for (size_t idx = 0; idx < pair_counts_.size(); idx++) {
+      pair_counts_[idx] += counts[idx];
+    }
+  }
+
+  sample_count_++;
+}
+
+void PairCorrelationAccumulator::Reset() {
+  frames_seen_ = 0;
+  sample_count_ = 0;
+  std::fill(pair_counts_.begin(), pair_counts_.end(), 0);
+}
+
+void PairCorrelationAccumulator::IndexParticleTypes(
+    const GasContainer& container) {
+  const vector<GasParticle>& particles = container.GetParticles();
+  if (particle_types_.size() == particles.size() && !type_names_.empty()) {
+    return;
+  }
+
+  type_names_ = container.GetParticleTypeNames();
+  type_counts_.assign(type_names_.size(), 0);
+  particle_types_.assign(particles.size(), 0);
+
+  for (size_t type = 0; type < type_names_.size(); type++) {
+    ParticleView type_particles = container.GetParticlesOfType(type_names_[type]);
+    type_counts_[type] = type_particles.size();
+
+    for (size_t particle_idx : type_particles.GetIndices()) {
+      particle_types_[particle_idx] = type;
+    }
+  }
+
+  // Only pairs with the 1st type at most the 2nd type are stored
+  size_t pair_count = type_names_.size() * (type_names_.size() + 1) / 2;
+  pair_counts_.assign(pair_count * bin_count_, 0);
+  worker_pair_counts_.assign(worker_count_,
+                             vector<uint64_t>(pair_counts_.size(), 0));
+  sample_count_ = 0;
+}
+
+size_t PairCorrelationAccumulator::FindPairOffset(size_t type_one,
+                                                  size_t type_two) const {
+  if (type_one > type_two) {
+    std::swap(type_one, type_two);
+  }
+
+  // Index into the upper triangle of the type by type matrix, row by row
+  size_t type_count = type_names_.size();
+  size_t row_start = type_one * (2 * type_count - type_one + 1) / 2;
+
+  return (row_start + type_two - type_one) * bin_count_;
+}
+
+void PairCorrelationAccumulator::CountPairsInRows(
+    const vector<GasParticle>& particles, size_t row_begin, size_t row_end,
+    vector<uint64_t>& pair_counts) const {
+  size_t column_count = cell_list_.GetColumnCount();
+  size_t row_count = cell_list_.GetRowCount();
+
+  for (size_t row = row_begin; row < row_end; row++) {
+    for (size_t column = 0; column < column_count; column++) {
+      const size_t* cell_begin = cell_list_.GetCellBegin(column, row);
+      const size_t* cell_end = cell_list_.GetCellEnd(column, row);
+
+      for (const size_t* particle = cell_begin; particle != cell_end;
+           particle++) {
+        // Pair with the particles after this one in the same cell...
+        CountPairsWithParticle(particles, *particle, particle + 1, cell_end,
+                               pair_counts);
+
+        // ...and with the cells to the right and in the row below
+        if (column + 1 < column_count) {
+          CountPairsWithParticle(particles, *particle,
+                                 cell_list_.GetCellBegin(column + 1, row),
+                                 cell_list_.GetCellEnd(column + 1, row),
+                                 pair_counts);
+        }
+
+        if (row + 1 == row_count) {
+          continue;
+        }
+
+        size_t first_column = column > 0 ? column - 1 : 0;
+        size_t last_column = std::min(column + 1, column_count - 1);
+        for (size_t other = first_column; other <= last_column; other++) {
+          CountPairsWithParticle(particles, *particle,
+                                 cell_list_.GetCellBegin(other, row + 1),
+                                 cell_list_.GetCellEnd(other, row + 1),
+                                 pair_counts);
+        }
+      }
+    }
+  }
+}
+
+void PairCorrelationAccumulator::CountPairsWithParticle(
+    const vector<GasParticle>& particles, size_t particle_idx,
+    const size_t* others_begin, const size_t* others_end,
+    vector<uint64_t>& pair_counts) const {
+  const vec2& position = particles[particle_idx].GetPosition();
+  size_t type = particle_types_[particle_idx];
+  float squared_max_radius = max_radius_ * max_radius_;
+
+  for (const size_t* other = others_begin; other != others_end; other++) {
+    vec2 separation = particles[*other].GetPosition() - position;
+    float squared_distance = glm::dot(separation, separation);
+
+    // Compare squared distances so that far pairs never need a square root
+    if (squared_distance >= squared_max_radius) {
+      continue;
+    }
+
+    size_t bin = std::min(
+        static_cast<size_t>(std::sqrt(squared_distance) / bin_width_),
+        bin_count_ - 1);
+    pair_counts[FindPairOffset(type, particle_types_[*other]) + bin]++;
+  }
+}
+
+vector<float> PairCorrelationAccumulator::GetPairCorrelation(
+    const string& type_one, const string& type_two) const {
+  vector<float> pair_correlation(bin_count_, 0);
+
+  auto first_type = std::find(type_names_.begin(), type_names_.end(),
+                              type_one);
+  auto second_type = std::find(type_names_.begin(), type_names_.end(),
+                               type_two);
+  if (sample_count_ == 0 || first_type == type_names_.end()
+      || second_type == type_names_.end()) {
+    return pair_correlation;
+  }
+
+  size_t first_idx = first_type - type_names_.begin();
+  size_t second_idx = second_type - type_names_.begin();
+
+  // Count the distinct pairs, which must not pair a particle with itself
+  double first_count = type_counts_[first_idx];
+  double pair_total = first_idx == second_idx
+                      ? first_count * (first_count - 1) / 2
+                      : first_count * type_counts_[second_idx];
+  if (pair_total <= 0) {
+    return pair_correlation;
+  }
+
+  double container_area =
+      (GasContainer::kContainerRightBound - GasContainer::kContainerLeftBound)
+      * (GasContainer::kContainerLowerBound - GasContainer::kContainerUpperBound);
+  size_t offset = FindPairOffset(first_idx, second_idx);
+
+  for (size_t bin = 0; bin < bin_count_; bin++) {
+    double inner_radius = bin * bin_width_;
+    double outer_radius = inner_radius + bin_width_;
+    double shell_area = M_PI * (outer_radius * outer_radius
+                                - inner_radius * inner_radius);
+
+    // An ideal gas spreads its pairs evenly over the whole container
+    double ideal_pair_count = pair_total * shell_area / container_area;
+    pair_correlation[bin] = static_cast<float>(
+        pair_counts_[offset + bin] / (sample_count_ * ideal_pair_count));
+  }
+
+  return pair_correlation;
+}
+
+float PairCorrelationAccumulator::GetBinRadius(size_t bin) const {
+  return (bin + 0.5f) * bin_width_;
+}
+
+size_t PairCorrelationAccumulator::GetSampleCount() const {
+  return sample_count_;
+}
+
+}  // namespace idealgas
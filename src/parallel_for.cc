@@ -0,0 +1,79 @@
+//
+// Created by Neil Kaushikkar on 5/18/21.
+//
+
+#include "parallel_for.h"
+
+#include <algorithm>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace idealgas {
+
+using std::vector;
+
+size_t GetDefaultWorkerCount() {
+  size_t hardware_threads = std::thread::hardware_concurrency();
+  return hardware_threads > 0 ? hardware_threads : 1;
+}
+
+void ParallelFor(size_t count, size_t worker_count,
+                 const std::function<void(size_t, size_t, size_t)>& task) {
+  // Never make more chunks than there are items to work on
+  size_t chunk_count = std::max<size_t>(1, std::min(count, worker_count));
+  size_t chunk_size = count / chunk_count;
+  size_t remainder = count % chunk_count;
+
+  std::exception_ptr first_exception;
+  std::mutex exception_mutex;
+
+  auto run_chunk = [&](size_t chunk_begin, size_t chunk_end, size_t worker) {
+    try {
+      task(chunk_begin, chunk_end, worker);
+    } catch (...) {
+      std::lock_guard<std::mutex> lock(exception_mutex);
+      if (!first_exception) {
+        first_exception = std::current_exception();
+      }
+    }
+  };
+
+  vector<std::thread> workers;
+  workers.reserve(chunk_count - 1);
+
+  size_t chunk_begin = 0;
+  try {
+    for (size_t worker = 0; worker < chunk_count; worker++) {
+      // The first chunks each take 1 of the leftover items
+      size_t chunk_end =
+          chunk_begin + chunk_size + (worker < remainder ? 1 : 0);
+
+      if (worker + 1 == chunk_count) {
+        run_chunk(chunk_begin, chunk_end, worker);
+      } else {
+        workers.emplace_back(run_chunk, chunk_begin, chunk_end, worker);
+      }
+
+      chunk_begin = chunk_end;
+    }
+  } catch (...) {
+    // A thread that can't be started leaves the earlier ones running, and
+    // destroying them before they are joined would terminate the program
+    for (std::thread& worker : workers) {
+      worker.join();
+    }
+    throw;
+  }
+
+  for (std::thread& worker : workers) {
+    worker.join();
+  }
+
+  if (first_exception) {
+    std::rethrow_exception(first_exception);
+  }
+}
+
+}  // namespace idealgas
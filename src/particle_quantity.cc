@@ -0,0 +1,83 @@
+//
+// Created by Neil Kaushikkar on 5/16/21.
+//
+
+#include "particle_quantity.h"
+
+#include <cmath>
+#include <stdexcept>
+#include <utility>
+
+namespace idealgas {
+
+using nlohmann::json;
+using std::string;
+using glm::vec2;
+
+// The name of each quantity in json
+static const std::pair<ParticleQuantity, const char*> kQuantityNames[] = {
+    {ParticleQuantity::kSpeed, "speed"},
+    {ParticleQuantity::kKineticEnergy, "kinetic_energy"},
+    {ParticleQuantity::kVelocityX, "velocity_x"},
+    {ParticleQuantity::kVelocityY, "velocity_y"},
+    {ParticleQuantity::kHeading, "heading"}};
+
+void to_json(json& json_value, ParticleQuantity quantity) {
+  for (const std::pair<ParticleQuantity, const char*>& name : kQuantityNames) {
+    if (name.first == quantity) {
+      json_value = name.second;
+      return;
+    }
+  }
+}
+
+void from_json(const json& json_value, ParticleQuantity& quantity) {
+  for (const std::pair<ParticleQuantity, const char*>& name : kQuantityNames) {
+    if (json_value == name.second) {
+      quantity = name.first;
+      return;
+    }
+  }
+
+  throw std::invalid_argument(json_value.dump()
+                              + " is not a particle quantity.");
+}
+
+float MeasureParticleQuantity(const GasParticle& particle,
+                              ParticleQuantity quantity) {
+  const vec2& velocity = particle.GetVelocity();
+
+  switch (quantity) {
+    case ParticleQuantity::kSpeed:
+      return glm::length(velocity);
+    case ParticleQuantity::kKineticEnergy:
+      return 0.5f * particle.GetMass() * glm::dot(velocity, velocity);
+    case ParticleQuantity::kVelocityX:
+      return velocity.x;
+    case ParticleQuantity::kVelocityY:
+      return velocity.y;
+    case ParticleQuantity::kHeading:
+      return std::atan2(velocity.y, velocity.x);
+  }
+
+  throw std::invalid_argument("Unknown particle quantity.");
+}
+
+string GetParticleQuantityLabel(ParticleQuantity quantity) {
+  switch (quantity) {
+    case ParticleQuantity::kSpeed:
+      return "Speed (pixels/frame)";
+    case ParticleQuantity::kKineticEnergy:
+      return "Kinetic Energy";
+    case ParticleQuantity::kVelocityX:
+      return "X Velocity (pixels/frame)";
+    case ParticleQuantity::kVelocityY:
+      return "Y Velocity (pixels/frame)";
+    case ParticleQuantity::kHeading:
+      return "Heading (radians)";
+  }
+
+  throw std::invalid_argument("Unknown particle quantity.");
+}
+
+}  // namespace idealgas
@@ -0,0 +1,73 @@
+//
+// Created by Neil Kaushikkar on 5/14/21.
+//
+
+#include "particle_view.h"
+
+namespace idealgas {
+
+using std::vector;
+
+ParticleView::ConstIterator::ConstIterator(
+    const vector<GasParticle>* particles,
+    vector<size_t>::const_iterator index_iterator)
+    : particles_(particles), index_iterator_(index_iterator) {}
+
+const GasParticle& ParticleView::ConstIterator::operator*() const {
+  return (*particles_)[*index_iterator_];
+}
+
+const GasParticle* ParticleView::ConstIterator::operator->() const {
+  return &(*particles_)[*index_iterator_];
+}
+
+ParticleView::ConstIterator& ParticleView::ConstIterator::operator++() {
+  ++index_iterator_;
+  return *this;
+}
+
+ParticleView::ConstIterator ParticleView::ConstIterator::operator++(int) {
+  ConstIterator previous = *this;
+  ++index_iterator_;
+  return previous;
+}
+
+bool ParticleView::ConstIterator::operator==(
+    const ConstIterator& other) const {
+  return index_iterator_ == other.index_iterator_;
+}
+
+bool ParticleView::ConstIterator::operator!=(
+    const ConstIterator& other) const {
+  return index_iterator_ != other.index_iterator_;
+}
+
+ParticleView::ParticleView(const vector<GasParticle>& particles,
+                           const vector<size_t>& indices)
+    : particles_(&particles), indices_(&indices) {}
+
+ParticleView::ConstIterator ParticleView::begin() const {
+  return ConstIterator(particles_, indices_->begin());
+}
+
+ParticleView::ConstIterator ParticleView::end() const {
+  return ConstIterator(particles_, indices_->end());
+}
+
+size_t ParticleView::size() const {
+  return indices_->size();
+}
+
+bool ParticleView::empty() const {
+  return indices_->empty();
+}
+
+const GasParticle& ParticleView::operator[](size_t view_index) const {
+  return (*particles_)[(*indices_)[view_index]];
+}
+
+const vector<size_t>& ParticleView::GetIndices() const {
+  return *indices_;
+}
+
+}  // namespace idealgas
@@ -0,0 +1,251 @@
+//
+// Created by Neil Kaushikkar on 6/3/21.
+//
+
+#include "poisson_disk_placer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <utility>
+
+namespace idealgas {
+
+using glm::vec2;
+using nlohmann::json;
+using std::vector;
+
+constexpr size_t PoissonDiskPlacer::kCandidateCount;
+constexpr size_t PoissonDiskPlacer::kRestartAttemptCount;
+constexpr uint32_t PoissonDiskPlacer::kRandomStream;
+
+// The smallest spacing of the grid and lattice, for particles with no radius
+static constexpr float kMinSpacing = 1;
+
+// Lattice sites are spread a little wider than the largest particle, so
+// rounding can't leave neighbors overlapping
+static constexpr float kLatticeSpacingFactor = 1.001f;
+
+// The name of each placement mode in json
+static const std::pair<PlacementMode, const char*> kPlacementModeNames[] = {
+    {PlacementMode::kUniform, "uniform"},
+    {PlacementMode::kPoissonDisk, "poisson_disk"}};
+
+void to_json(json& json_value, PlacementMode mode) {
+  for (const std::pair<PlacementMode, const char*>& name :
+       kPlacementModeNames) {
+    if (name.first == mode) {
+      json_value = name.second;
+      return;
+    }
+  }
+}
+
+void from_json(const json& json_value, PlacementMode& mode) {
+  for (const std::pair<PlacementMode, const char*>& name :
+       kPlacementModeNames) {
+    if (json_value == name.second) {
+      mode = name.first;
+      return;
+    }
+  }
+
+  throw std::invalid_argument(json_value.dump()
+                              + " is not a placement mode.");
+}
+
+PoissonDiskPlacer::PoissonDiskPlacer(const vec2& upper_left,
+                                     const vec2& lower_right, uint64_t seed)
+    : upper_left_(upper_left), lower_right_(lower_right),
+      random_(seed, kRandomStream, 0), cell_size_(kMinSpacing),
+      column_count_(0), row_count_(0) {}
+
+vector<vec2> PoissonDiskPlacer::Place(const vector<float>& radii) {
+  vector<vec2> positions(radii.size());
+  if (radii.empty()) {
+    return positions;
+  }
+
+  // Any 2 particles that overlap are in the same or neighboring cells
+  float max_radius = *std::max_element(radii.begin(), radii.end());
+  cell_size_ = std::max(2 * max_radius, kMinSpacing);
+  column_count_ = std::max<size_t>(
+      1, static_cast<size_t>(
+             std::ceil((lower_right_.x - upper_left_.x) / cell_size_)));
+  row_count_ = std::max<size_t>(
+      1, static_cast<size_t>(
+             std::ceil((lower_right_.y - upper_left_.y) / cell_size_)));
+  cells_.assign(column_count_ * row_count_, vector<size_t>());
+
+  // Large particles are placed first, while there is the most room
+  vector<size_t> order(radii.size());
+  for (size_t idx = 0; idx < order.size(); idx++) {
+    order[idx] = idx;
+  }
+  std::stable_sort(order.begin(), order.end(),
+                   [&radii](size_t first, size_t second) {
+    return radii[first] > radii[second];
+  });
+
+  // Sampling often fits mixed sizes far more densely than a lattice spaced by
+  // the largest particle, so the lattice is only a last resort
+  if (!PlaceBySampling(radii, order, positions)) {
+    PlaceOnLattice(radii, positions);
+  }
+
+  return positions;
+}
+
+float PoissonDiskPlacer::FindPackingFraction(
+    const vector<float>& radii) const {
+  float particle_area = 0;
+  for (float radius : radii) {
+    particle_area += static_cast<float>(M_PI) * radius * radius;
+  }
+
+  return particle_area / ((lower_right_.x - upper_left_.x)
+                          * (lower_right_.y - upper_left_.y));
+}
+
+bool PoissonDiskPlacer::PlaceBySampling(const vector<float>& radii,
+                                        const vector<size_t>& order,
+                                        vector<vec2>& positions) {
+  // the placed particles that new particles may still fit around
+  vector<size_t> active_particles;
+
+  for (size_t particle : order) {
+    float radius = radii[particle];
+    bool is_placed = false;
+
+    while (!is_placed && !active_particles.empty()) {
+      size_t active_idx = random_.NextUint() % active_particles.size();
+      size_t center = active_particles[active_idx];
+      float min_distance = radii[center] + radius;
+
+      // Candidates are spread evenly over the area of the ring between 1 and
+      // 2 minimum distances away
+      for (size_t attempt = 0; attempt < kCandidateCount && !is_placed;
+           attempt++) {
+        float angle = random_.NextFloat(0, 2 * static_cast<float>(M_PI));
+        float distance = min_distance * std::sqrt(random_.NextFloat(1, 4));
+        vec2 candidate = positions[center]
+            + distance * vec2(std::cos(angle), std::sin(angle));
+
+        if (IsPositionFree(candidate, radius, radii, positions)) {
+          positions[particle] = candidate;
+          is_placed = true;
+        }
+      }
+
+      // Nothing more fits around this particle, so stop trying it
+      if (!is_placed) {
+        active_particles[active_idx] = active_particles.back();
+        active_particles.pop_back();
+      }
+    }
+
+    // Start again from a random spot when no placed particle has room left
+    for (size_t attempt = 0; attempt < kRestartAttemptCount && !is_placed;
+         attempt++) {
+      vec2 candidate(
+          random_.NextFloat(upper_left_.x + radius, lower_right_.x - radius),
+          random_.NextFloat(upper_left_.y + radius, lower_right_.y - radius));
+
+      if (IsPositionFree(candidate, radius, radii, positions)) {
+        positions[particle] = candidate;
+        is_placed = true;
+      }
+    }
+
+    if (!is_placed) {
+      return false;
+    }
+
+    cells_[FindCell(positions[particle])].push_back(particle);
+    active_particles.push_back(particle);
+  }
+
+  return true;
+}
+
+void PoissonDiskPlacer::PlaceOnLattice(const vector<float>& radii,
+                                       vector<vec2>& positions) {
+  float max_radius = *std::max_element(radii.begin(), radii.end());
+  float spacing =
+      std::max(2 * max_radius, kMinSpacing) * kLatticeSpacingFactor;
+  float row_height = spacing * std::sqrt(3.0f) / 2;
+
+  // Every other row is shifted by half a spacing to pack the rows closer
+  vector<vec2> sites;
+  for (size_t row = 0;
+       upper_left_.y + max_radius + row * row_height
+       <= lower_right_.y - max_radius; row++) {
+    float y = upper_left_.y + max_radius + row * row_height;
+    float row_start = upper_left_.x + max_radius + (row % 2) * spacing / 2;
+
+    for (size_t column = 0;
+         row_start + column * spacing <= lower_right_.x - max_radius;
+         column++) {
+      sites.emplace_back(row_start + column * spacing, y);
+    }
+  }
+
+  if (sites.size() < radii.size()) {
+    throw std::invalid_argument("The particles don't fit in the container.");
+  }
+
+  // Shuffle only as many sites as there are particles
+  for (size_t idx = 0; idx < positions.size(); idx++) {
+    size_t site_idx = idx + random_.NextUint() % (sites.size() - idx);
+    std::swap(sites[idx], sites[site_idx]);
+    positions[idx] = sites[idx];
+  }
+}
+
+bool PoissonDiskPlacer::IsPositionFree(const vec2& position, float radius,
+                                       const vector<float>& radii,
+                                       const vector<vec2>& positions) const {
+  bool is_inside = position.x - radius >= upper_left_.x
+                   && position.x + radius <= lower_right_.x
+                   && position.y - radius >= upper_left_.y
+                   && position.y + radius <= lower_right_.y;
+  if (!is_inside) {
+    return false;
+  }
+
+  size_t cell = FindCell(position);
+  size_t column = cell % column_count_;
+  size_t row = cell / column_count_;
+
+  for (size_t neighbor_row = row > 0 ? row - 1 : 0;
+       neighbor_row <= std::min(row + 1, row_count_ - 1); neighbor_row++) {
+    for (size_t neighbor_column = column > 0 ? column - 1 : 0;
+         neighbor_column <= std::min(column + 1, column_count_ - 1);
+         neighbor_column++) {
+      for (size_t other : cells_[neighbor_row * column_count_
+                                 + neighbor_column]) {
+        float min_distance = radius + radii[other];
+        vec2 offset = positions[other] - position;
+
+        if (glm::dot(offset, offset) < min_distance * min_distance) {
+          return false;
+        }
+      }
+    }
+  }
+
+  return true;
+}
+
+size_t PoissonDiskPlacer::FindCell(const vec2& position) const {
+  size_t column = std::min(
+      column_count_ - 1,
+      static_cast<size_t>((position.x - upper_left_.x) / cell_size_));
+  size_t row = std::min(
+      row_count_ - 1,
+      static_cast<size_t>((position.y - upper_left_.y) / cell_size_));
+
+  return row * column_count_ + column;
+}
+
+}  // namespace idealgas
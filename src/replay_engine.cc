@@ -0,0 +1,128 @@
+//
+// Created by Neil Kaushikkar on 5/30/21.
+//
+
+#include "replay_engine.h"
+
+#include "container_drawing.h"
+#include "gas_container.h"
+
+#include <algorithm>
+#include <sstream>
+#include <stdexcept>
+
+namespace idealgas {
+
+using glm::vec2;
+using std::string;
+using std::vector;
+
+constexpr float ReplayEngine::kStatusPadding;
+
+ReplayEngine::ReplayEngine(const string& trajectory_file_path)
+    : reader_(trajectory_file_path), playhead_(0), current_frame_(0),
+      speed_(1), is_playing_(false), is_reversed_(false) {
+  if (reader_.GetFrameCount() == 0) {
+    throw std::invalid_argument("The trajectory has no frames.");
+  }
+
+  // Particles keep their types for the whole trajectory
+  const vector<ParticleSpecs>& particle_specs = reader_.GetParticleSpecs();
+  for (uint32_t type_id : reader_.GetParticleTypeIds()) {
+    radii_.push_back(particle_specs[type_id].radius);
+    colors_.push_back(particle_specs[type_id].color);
+  }
+
+  reader_.ReadFrame(current_frame_, positions_);
+}
+
+void ReplayEngine::AdvanceToNextFrame() {
+  if (!is_playing_) {
+    return;
+  }
+
+  double last_frame = static_cast<double>(reader_.GetFrameCount() - 1);
+  playhead_ += is_reversed_ ? -speed_ : speed_;
+
+  if (playhead_ <= 0 || playhead_ >= last_frame) {
+    playhead_ = std::min(std::max(playhead_, 0.0), last_frame);
+    is_playing_ = false;
+  }
+
+  ShowPlayheadFrame();
+}
+
+void ReplayEngine::Render() const {
+  DrawContainerContents(positions_, radii_, colors_);
+
+  std::stringstream status;
+  status << "Frame " << current_frame_ << " of " << reader_.GetFrameCount()
+         << " at " << (is_reversed_ ? -speed_ : speed_) << "x"
+         << (is_playing_ ? "" : " (paused)");
+
+  ci::gl::drawStringCentered(
+      status.str(),
+      vec2((GasContainer::kContainerLeftBound
+            + GasContainer::kContainerRightBound) / 2,
+           GasContainer::kContainerLowerBound + kStatusPadding));
+}
+
+void ReplayEngine::Seek(size_t frame) {
+  playhead_ = static_cast<double>(
+      std::min(frame, reader_.GetFrameCount() - 1));
+  ShowPlayheadFrame();
+}
+
+void ReplayEngine::Play() {
+  is_playing_ = true;
+}
+
+void ReplayEngine::Pause() {
+  is_playing_ = false;
+}
+
+void ReplayEngine::Reverse() {
+  is_reversed_ = !is_reversed_;
+}
+
+void ReplayEngine::SetSpeed(double frames_per_update) {
+  if (frames_per_update <= 0) {
+    throw std::invalid_argument("The playback speed must be positive.");
+  }
+
+  speed_ = frames_per_update;
+}
+
+bool ReplayEngine::IsPlaying() const {
+  return is_playing_;
+}
+
+bool ReplayEngine::IsReversed() const {
+  return is_reversed_;
+}
+
+double ReplayEngine::GetSpeed() const {
+  return speed_;
+}
+
+size_t ReplayEngine::GetCurrentFrame() const {
+  return current_frame_;
+}
+
+size_t ReplayEngine::GetFrameCount() const {
+  return reader_.GetFrameCount();
+}
+
+const vector<vec2>& ReplayEngine::GetPositions() const {
+  return positions_;
+}
+
+void ReplayEngine::ShowPlayheadFrame() {
+  size_t frame = static_cast<size_t>(playhead_);
+  if (frame != current_frame_) {
+    reader_.ReadFrame(frame, positions_);
+    current_frame_ = frame;
+  }
+}
+
+}  // namespace idealgas
@@ -0,0 +1,144 @@
+//
+// Created by Neil Kaushikkar on 5/28/21.
+//
+
+#include "save_worker.h"
+
+#include <cstdio>
+#include <stdexcept>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace idealgas {
+
+using std::string;
+
+const string SaveWorker::kTemporaryFileSuffix = ".saving";
+
+#ifndef _WIN32
+/**
+ * Flushes a file or directory to disk.
+ * @param path - the path of the file or directory
+ * @throws std::invalid_argument if it can't be opened or flushed
+ */
+static void FlushToDisk(const string& path) {
+  int file_descriptor = open(path.c_str(), O_RDONLY);
+  if (file_descriptor < 0) {
+    throw std::invalid_argument("The saved file could not be opened.");
+  }
+
+  bool is_flushed = fsync(file_descriptor) == 0;
+  close(file_descriptor);
+
+  if (!is_flushed) {
+    throw std::invalid_argument("The saved file could not be flushed.");
+  }
+}
+#endif
+
+SaveWorker::SaveWorker()
+    : pending_count_(0), is_stopping_(false), last_result_(SaveStatus::kIdle) {
+  io_thread_ = std::thread(&SaveWorker::ProcessJobs, this);
+}
+
+SaveWorker::~SaveWorker() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    is_stopping_ = true;
+  }
+
+  job_available_.notify_one();
+  io_thread_.join();
+}
+
+void SaveWorker::Enqueue(const string& file_path, const WriteTask& write_task,
+                         const CompletionCallback& on_complete) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    SaveJob job = {file_path, write_task, on_complete};
+    jobs_.push_back(job);
+    pending_count_++;
+  }
+
+  job_available_.notify_one();
+}
+
+SaveStatus SaveWorker::GetStatus() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return pending_count_ > 0 ? SaveStatus::kSaving : last_result_;
+}
+
+void SaveWorker::WaitUntilIdle() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  jobs_finished_.wait(lock, [this] { return pending_count_ == 0; });
+}
+
+void SaveWorker::ProcessJobs() {
+  while (true) {
+    SaveJob job;
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      job_available_.wait(lock, [this] {
+        return is_stopping_ || !jobs_.empty();
+      });
+
+      // Saves queued before stopping are still written
+      if (jobs_.empty()) {
+        return;
+      }
+
+      job = jobs_.front();
+      jobs_.pop_front();
+    }
+
+    bool is_saved = WriteJob(job);
+    if (job.on_complete) {
+      job.on_complete(is_saved);
+    }
+
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      last_result_ = is_saved ? SaveStatus::kSucceeded : SaveStatus::kFailed;
+      pending_count_--;
+    }
+
+    jobs_finished_.notify_all();
+  }
+}
+
+bool SaveWorker::WriteJob(const SaveJob& job) {
+  string temporary_path = job.file_path + kTemporaryFileSuffix;
+
+  try {
+    job.write_task(temporary_path);
+
+#ifndef _WIN32
+    // Make sure the data is on disk before it replaces the previous save
+    FlushToDisk(temporary_path);
+#else
+    // Windows can't rename over an existing file
+    std::remove(job.file_path.c_str());
+#endif
+
+    if (std::rename(temporary_path.c_str(), job.file_path.c_str()) != 0) {
+      throw std::invalid_argument("The saved file could not be moved.");
+    }
+
+#ifndef _WIN32
+    // The rename itself is only durable once its directory is flushed
+    size_t separator = job.file_path.find_last_of('/');
+    FlushToDisk(separator == string::npos
+                    ? string(".") : job.file_path.substr(0, separator + 1));
+#endif
+  } catch (std::exception& e) {
+    std::remove(temporary_path.c_str());
+    return false;
+  }
+
+  return true;
+}
+
+}  // namespace idealgas
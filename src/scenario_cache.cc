@@ -0,0 +1,179 @@
+//
+// Created by Neil Kaushikkar on 6/1/21.
+//
+
+#include "scenario_cache.h"
+
+#include "mapped_file.h"
+
+#include <sys/stat.h>
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <stdexcept>
+
+namespace idealgas {
+
+using std::string;
+
+const string ScenarioCache::kCacheFileSuffix = ".cache";
+const char ScenarioCache::kFileSignature[4] = {'I', 'G', 'S', 'C'};
+constexpr uint32_t ScenarioCache::kFileVersion;
+constexpr uint64_t ScenarioCache::kHashOffsetBasis;
+
+// Each byte is folded into FNV-1a hashes with this multiplier
+static constexpr uint64_t kHashPrime = 1099511628211ULL;
+
+static_assert(sizeof(ScenarioCache::CacheFooter) == 48,
+              "The cache footer must stay 48 bytes to keep its layout.");
+
+ScenarioCache::ScenarioCache() = default;
+
+GasContainer ScenarioCache::LoadContainer(const string& source_file_path,
+                                          const ParseFunction& parse) const {
+  GasContainer container;
+  if (TryLoadCache(source_file_path, container)) {
+    return container;
+  }
+
+  container = parse(source_file_path);
+
+  // The cache only speeds up later loads, so failing to write it is harmless
+  try {
+    WriteCache(source_file_path, container);
+  } catch (std::invalid_argument& e) {
+  }
+
+  return container;
+}
+
+void ScenarioCache::WriteCache(const string& source_file_path,
+                               const GasContainer& container) const {
+  // Taken before the source is read, so later changes are after this time
+  int64_t cache_time = static_cast<int64_t>(std::time(nullptr));
+
+  struct stat source_status;
+  if (stat(source_file_path.c_str(), &source_status) != 0) {
+    throw std::invalid_argument("The file path is not valid");
+  }
+
+  CacheFooter footer;
+  footer.source_path_hash =
+      HashBytes(source_file_path.data(), source_file_path.size());
+  footer.source_size = static_cast<uint64_t>(source_status.st_size);
+  footer.source_modification_time =
+      static_cast<int64_t>(source_status.st_mtime);
+  footer.source_content_hash = HashFile(source_file_path);
+  footer.cache_time = cache_time;
+  std::memcpy(footer.signature, kFileSignature, sizeof(kFileSignature));
+  footer.version = kFileVersion;
+
+  // Write to a temporary file first, so a cache is never left half written
+  string cache_path = FindCachePath(source_file_path);
+  string temporary_path = cache_path + ".tmp";
+  snapshot_manager_.WriteContainerToSnapshot(container, temporary_path);
+
+  std::ofstream cache_file(temporary_path, std::ios::binary | std::ios::app);
+  cache_file.write(reinterpret_cast<const char*>(&footer), sizeof(footer));
+  cache_file.close();
+
+  std::remove(cache_path.c_str());
+  if (!cache_file || std::rename(temporary_path.c_str(),
+                                 cache_path.c_str()) != 0) {
+    std::remove(temporary_path.c_str());
+    throw std::invalid_argument("The cache file could not be written");
+  }
+}
+
+string ScenarioCache::FindCachePath(const string& source_file_path) {
+  return source_file_path + kCacheFileSuffix;
+}
+
+uint64_t ScenarioCache::HashBytes(const char* data, size_t length,
+                                  uint64_t hash) {
+  for (size_t idx = 0; idx < length; idx++) {
+    hash ^= static_cast<unsigned char>(data[idx]);
+    hash *= kHashPrime;
+  }
+
+  return hash;
+}
+
+bool ScenarioCache::TryLoadCache(const string& source_file_path,
+                                 GasContainer& container) const {
+  // Taken before the source is read, like the time a cache is written
+  int64_t load_time = static_cast<int64_t>(std::time(nullptr));
+
+  struct stat source_status;
+  if (stat(source_file_path.c_str(), &source_status) != 0) {
+    return false;
+  }
+
+  std::unique_ptr<MappedFile> cache;
+  try {
+    cache.reset(new MappedFile(FindCachePath(source_file_path)));
+  } catch (std::invalid_argument& e) {
+    return false;
+  }
+
+  uint64_t cache_size = cache->GetSize();
+  if (cache_size < sizeof(CacheFooter)) {
+    return false;
+  }
+
+  uint64_t snapshot_size = cache_size - sizeof(CacheFooter);
+  CacheFooter footer;
+  std::memcpy(&footer, cache->GetData() + snapshot_size, sizeof(footer));
+
+  bool is_same_source =
+      std::memcmp(footer.signature, kFileSignature,
+                  sizeof(kFileSignature)) == 0
+      && footer.version == kFileVersion
+      && footer.source_path_hash
+         == HashBytes(source_file_path.data(), source_file_path.size())
+      && footer.source_size == static_cast<uint64_t>(source_status.st_size);
+  if (!is_same_source) {
+    return false;
+  }
+
+  // The source can change in the second the cache was written without its
+  // modification time changing, so only earlier times prove it is unchanged
+  int64_t modification_time = static_cast<int64_t>(source_status.st_mtime);
+  bool is_unmodified = footer.source_modification_time == modification_time
+                       && modification_time < footer.cache_time;
+
+  if (!is_unmodified
+      && HashFile(source_file_path) != footer.source_content_hash) {
+    return false;
+  }
+
+  try {
+    container = snapshot_manager_.LoadContainerFromSnapshotData(
+        cache->GetData(), snapshot_size);
+  } catch (std::invalid_argument& e) {
+    return false;
+  }
+
+  // Record the new time of a source that was touched but not changed, so its
+  // contents don't need to be hashed again on every load
+  if (footer.source_modification_time != modification_time) {
+    footer.source_modification_time = modification_time;
+    footer.cache_time = load_time;
+
+    std::fstream cache_file(FindCachePath(source_file_path),
+                            std::ios::binary | std::ios::in | std::ios::out);
+    cache_file.seekp(snapshot_size);
+    cache_file.write(reinterpret_cast<const char*>(&footer), sizeof(footer));
+  }
+
+  return true;
+}
+
+uint64_t ScenarioCache::HashFile(const string& file_path) {
+  MappedFile file(file_path);
+  return HashBytes(file.GetData(), file.GetSize());
+}
+
+}  // namespace idealgas
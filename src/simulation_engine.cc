@@ -1,11 +1,12 @@
 #include "simulation_engine.h"
 
+#include <sys/stat.h>
+
 namespace idealgas {
 
 using glm::vec2;
 using std::string;
 using std::vector;
-using std::map;
 
 const string SimulationEngine::kJsonSavedFilePath =
     "data/saved_simulation.json";
@@ -13,61 +14,526 @@ const string SimulationEngine::kJsonSavedFilePath =
 const string SimulationEngine::kJsonRandomSimulationFilePath =
     "data/random_simulation_generator.json";
 
+const string SimulationEngine::kJsonHistogramSettingsFilePath =
+    "data/histogram_settings.json";
+
+const string SimulationEngine::kSnapshotSavedFilePath =
+    "data/saved_simulation.snapshot";
+
+const string SimulationEngine::kTrajectoryFilePath =
+    "data/recorded_simulation.trajectory";
+
+const string SimulationEngine::kEquilibriumLibraryDirectoryPath =
+    "data/equilibrium_library";
+
+/**
+ * Finds when a file was last modified.
+ * @param file_path - the path of the file
+ * @return the modification time, or 0 if the file does not exist
+ */
+static time_t FindModificationTime(const string& file_path) {
+  struct stat file_status;
+  if (stat(file_path.c_str(), &file_status) != 0) {
+    return 0;
+  }
+
+  return file_status.st_mtime;
+}
+
 SimulationEngine::SimulationEngine(bool load_from_saved_file) :
-      json_manager_(), container_(ContainerInitializer(load_from_saved_file)),
-      histograms_({}) {
+      json_manager_(), snapshot_manager_(),
+      is_loaded_from_saved_file_(load_from_saved_file),
+      container_(ContainerInitializer(load_from_saved_file)),
+      histogram_specifications_(
+          HistogramInitializer(kJsonHistogramSettingsFilePath)),
+      particle_type_names_(), histograms_({}),
+      tracer_selectors_(TracerSelectorInitializer(load_from_saved_file)),
+      is_warm_started_(false), particle_set_(0),
+      is_library_store_attempted_(false) {
   vector<ParticleSpecs> particle_types = container_.FindUniqueParticleTypes();
+  histograms_.reserve(particle_types.size() * histogram_specifications_.size());
 
-  float x_coordinate = kDefaultHistogramXCoordinate;
   float y_coordinate = kHistogramDisplayPadding;
-  float bin_range = Histogram::kDefaultSingleBinRange;
-  size_t bin_count = Histogram::kDefaultBinCount;
 
   for (const ParticleSpecs& specs : particle_types) {
-    histograms_.emplace_back(specs.name, bin_count, bin_range,
-                             x_coordinate, y_coordinate, specs.color);
+    particle_type_names_.push_back(specs.name);
+    float x_coordinate = kDefaultHistogramXCoordinate;
+
+    for (const HistogramSpecifications& settings : histogram_specifications_) {
+      histograms_.emplace_back(specs.name, settings.bin_count,
+                               settings.bin_range, x_coordinate, y_coordinate,
+                               specs.color, settings.min_value,
+                               GetParticleQuantityLabel(settings.quantity));
+      histograms_.back().SetAutoRanging(settings.auto_range);
+
+      // Only displayed quantities take up a column on the screen
+      if (settings.display) {
+        x_coordinate += Histogram::kDefaultGraphWidth
+                        + kHistogramDisplayPadding;
+      }
+    }
+
     y_coordinate += Histogram::kDefaultGraphHeight + kHistogramDisplayPadding;
   }
 }
 
+vector<HistogramSpecifications> SimulationEngine::HistogramInitializer(
+    const string& histogram_settings_file_path) {
+  // Only a missing file falls back, so mistakes in the settings are reported
+  try {
+    JsonManager::ValidateFilePath(histogram_settings_file_path);
+  } catch (std::invalid_argument& e) {
+    HistogramSpecifications speed_settings = {
+        ParticleQuantity::kSpeed, Histogram::kDefaultBinCount,
+        Histogram::kDefaultSingleBinRange, 0, true, false};
+    return {speed_settings};
+  }
+
+  return JsonManager().LoadHistogramSpecificationsFromJson(
+      histogram_settings_file_path);
+}
+
+vector<TracerSelector> SimulationEngine::TracerSelectorInitializer(
+    bool load_from_saved_file) const {
+  if (load_from_saved_file) {
+    return {};
+  }
+
+  try {
+    return json_manager_.LoadTracerSelectorsFromJson(
+        kJsonRandomSimulationFilePath);
+  } catch (std::invalid_argument& e) {
+    return {};
+  }
+}
+
 GasContainer SimulationEngine::ContainerInitializer(
     bool load_from_saved_file) const {
   if (load_from_saved_file) {
-    return json_manager_.LoadContainerFromJson(kJsonSavedFilePath);
+    time_t snapshot_time = FindModificationTime(kSnapshotSavedFilePath);
+    if (snapshot_time != 0
+        && snapshot_time >= FindModificationTime(kJsonSavedFilePath)) {
+      return snapshot_manager_.LoadContainerFromSnapshot(
+          kSnapshotSavedFilePath);
+    }
+
+    return json_manager_.LoadContainerFromCachedJson(kJsonSavedFilePath);
   } else {
     return json_manager_.GenerateRandomContainerFromJson(
         kJsonRandomSimulationFilePath);
   }
 }
 
-void SimulationEngine::SaveSimulation() {
-  json_manager_.WriteContainerToJson(container_, kJsonSavedFilePath);
+void SimulationEngine::SaveSimulation(
+    const SaveWorker::CompletionCallback& on_complete) {
+  if (!save_worker_) {
+    save_worker_.reset(new SaveWorker());
+  }
+
+  // Copying the particles between frames is the only work done on this thread
+  std::shared_ptr<GasContainer> saved_container =
+      std::make_shared<GasContainer>(container_.GetParticles(),
+                                     container_.GetParticleSpecifications());
+  JsonManager json_manager = json_manager_;
+
+  SaveWorker::WriteTask write_json =
+      [saved_container, json_manager](const string& path) {
+    json_manager.WriteContainerToJson(*saved_container, path);
+  };
+  save_worker_->Enqueue(kJsonSavedFilePath, write_json, on_complete);
+}
+
+void SimulationEngine::SaveSnapshot(
+    const SaveWorker::CompletionCallback& on_complete) {
+  if (!save_worker_) {
+    save_worker_.reset(new SaveWorker());
+  }
+
+  std::shared_ptr<GasContainer> saved_container =
+      std::make_shared<GasContainer>(container_.GetParticles(),
+                                     container_.GetParticleSpecifications());
+  SnapshotManager snapshot_manager = snapshot_manager_;
+
+  SaveWorker::WriteTask write_snapshot =
+      [saved_container, snapshot_manager](const string& path) {
+    snapshot_manager.WriteContainerToSnapshot(*saved_container, path);
+  };
+  save_worker_->Enqueue(kSnapshotSavedFilePath, write_snapshot, on_complete);
+}
+
+SaveStatus SimulationEngine::GetSaveStatus() const {
+  return save_worker_ ? save_worker_->GetStatus() : SaveStatus::kIdle;
+}
+
+SaveStatus SimulationEngine::GetLibraryStoreStatus() const {
+  return equilibrium_library_ ? equilibrium_library_->GetStoreStatus()
+                              : SaveStatus::kIdle;
+}
+
+void SimulationEngine::WaitForSaves() {
+  if (save_worker_) {
+    save_worker_->WaitUntilIdle();
+  }
 }
 
 void SimulationEngine::AdvanceToNextFrame() {
   container_.AdvanceOneFrame();
   UpdateHistograms();
+
+  if (pair_correlation_) {
+    pair_correlation_->Sample(container_);
+  }
+
+  if (displacement_tracker_) {
+    displacement_tracker_->Record(container_);
+  }
+
+  if (field_grid_) {
+    field_grid_->Deposit(container_);
+  }
+
+  if (tracer_logger_) {
+    tracer_logger_->Record(container_);
+  }
+
+  if (trajectory_writer_) {
+    trajectory_writer_->Record(container_);
+  }
+
+  if (equilibrium_detector_) {
+    equilibrium_detector_->Record(container_);
+
+    // A warm started run only reaches the state that is already stored, and
+    // a failed store is not retried every frame
+    if (equilibrium_library_ && !is_warm_started_
+        && !is_library_store_attempted_
+        && equilibrium_detector_->IsEquilibrated()) {
+      is_library_store_attempted_ = true;
+      equilibrium_library_->StoreState(container_);
+    }
+  }
 }
 
-void SimulationEngine::UpdateHistograms() {
-  map<string, vector<float>> particle_speeds;
+size_t SimulationEngine::RunBatch(size_t max_frame_count,
+                                  size_t sampling_frame_count) {
+  size_t frame_count = 0;
+  while (frame_count < max_frame_count && !is_warm_started_
+         && !(equilibrium_detector_
+              && equilibrium_detector_->IsEquilibrated())) {
+    AdvanceToNextFrame();
+    frame_count++;
+  }
+
+  if (frame_count == max_frame_count) {
+    return frame_count;
+  }
+
+  // Measurements taken while the gas was still relaxing would bias the results
+  if (pair_correlation_) {
+    pair_correlation_->Reset();
+  }
+
+  if (displacement_tracker_) {
+    displacement_tracker_->Reset();
+  }
 
-  for (const GasParticle& particle : container_.GetAllParticles()) {
-    float speed = glm::length(particle.GetVelocity());
-    particle_speeds[particle.GetTypeName()].push_back(speed);
+  size_t last_frame_count =
+      std::min(max_frame_count, frame_count + sampling_frame_count);
+  while (frame_count < last_frame_count) {
+    AdvanceToNextFrame();
+    frame_count++;
   }
 
+  return frame_count;
+}
+
+void SimulationEngine::EnablePairCorrelation(float max_radius,
+                                             size_t bin_count,
+                                             size_t sample_interval) {
+  pair_correlation_.reset(new PairCorrelationAccumulator(
+      max_radius, bin_count, sample_interval));
+}
+
+void SimulationEngine::DisablePairCorrelation() {
+  pair_correlation_.reset();
+}
+
+const PairCorrelationAccumulator* SimulationEngine::GetPairCorrelation() const {
+  return pair_correlation_.get();
+}
+
+void SimulationEngine::EnableDisplacementTracking(size_t max_lag,
+                                                  size_t origin_interval) {
+  displacement_tracker_.reset(
+      new DisplacementTracker(max_lag, origin_interval));
+}
+
+void SimulationEngine::DisableDisplacementTracking() {
+  displacement_tracker_.reset();
+}
+
+const DisplacementTracker* SimulationEngine::GetDisplacementTracker() const {
+  return displacement_tracker_.get();
+}
+
+void SimulationEngine::EnableFieldDeposition(size_t column_count,
+                                             size_t row_count,
+                                             size_t deposit_interval,
+                                             bool is_time_averaged) {
+  field_grid_.reset(new FieldGrid(column_count, row_count, deposit_interval,
+                                  is_time_averaged));
+}
+
+void SimulationEngine::DisableFieldDeposition() {
+  field_grid_.reset();
+}
+
+const FieldGrid* SimulationEngine::GetFieldGrid() const {
+  return field_grid_.get();
+}
+
+void SimulationEngine::StartTracerLog(const string& log_file_path) {
+  vector<size_t> tracer_ids = SelectTracers(container_, tracer_selectors_);
+  if (tracer_ids.empty()) {
+    throw std::invalid_argument(
+        "The scenario of the simulation does not tag any tracers.");
+  }
+
+  tracer_logger_.reset(new TracerLogger(tracer_ids, log_file_path));
+}
+
+void SimulationEngine::StopTracerLog() {
+  tracer_logger_.reset();
+}
+
+const TracerLogger* SimulationEngine::GetTracerLogger() const {
+  return tracer_logger_.get();
+}
+
+void SimulationEngine::EnableEquilibriumDetection(
+    size_t window_frame_count, double divergence_threshold,
+    size_t required_window_count) {
+  equilibrium_detector_.reset(new EquilibriumDetector(
+      window_frame_count, divergence_threshold, required_window_count));
+}
+
+void SimulationEngine::DisableEquilibriumDetection() {
+  equilibrium_detector_.reset();
+}
+
+const EquilibriumDetector* SimulationEngine::GetEquilibriumDetector() const {
+  return equilibrium_detector_.get();
+}
+
+void SimulationEngine::EnableEquilibriumLibrary(const string& directory_path,
+                                                bool is_velocity_randomized,
+                                                uint64_t velocity_seed) {
+  // A saved simulation may have drifted anywhere from its scenario
+  if (is_loaded_from_saved_file_) {
+    throw std::invalid_argument(
+        "Only generated simulations have equilibrated states.");
+  }
+
+  // Their files already hold frames of the particles being replaced
+  if (tracer_logger_ || trajectory_writer_) {
+    throw std::invalid_argument(
+        "Stop logging tracers and recording before warm starting.");
+  }
+
+  equilibrium_library_.reset(new EquilibriumLibrary(
+      directory_path,
+      json_manager_.HashScenarioFromJson(kJsonRandomSimulationFilePath)));
+  is_library_store_attempted_ = false;
+
+  if (!equilibrium_library_->HasState()) {
+    return;
+  }
+
+  GasContainer loaded_container = equilibrium_library_->LoadState();
+  if (is_velocity_randomized) {
+    loaded_container = EquilibriumLibrary::RandomizeVelocities(
+        loaded_container, velocity_seed);
+  }
+
+  container_ = std::move(loaded_container);
+  particle_set_++;
+  container_.SetCollisionEventStream(collision_event_stream_.get());
+
+  // Measurements of the replaced particles don't describe the loaded ones
+  if (pair_correlation_) {
+    pair_correlation_->Reset();
+  }
+
+  if (displacement_tracker_) {
+    displacement_tracker_->Reset();
+  }
+
+  if (field_grid_) {
+    field_grid_->Reset();
+  }
+
+  if (equilibrium_detector_) {
+    equilibrium_detector_->Reset();
+  }
+
+  is_warm_started_ = true;
+}
+
+void SimulationEngine::DisableEquilibriumLibrary() {
+  equilibrium_library_.reset();
+}
+
+const EquilibriumLibrary* SimulationEngine::GetEquilibriumLibrary() const {
+  return equilibrium_library_.get();
+}
+
+bool SimulationEngine::IsWarmStarted() const {
+  return is_warm_started_;
+}
+
+void SimulationEngine::StartTrajectoryRecording(const string& file_path,
+                                                double precision,
+                                                size_t keyframe_interval) {
+  // Close the previous file first in case both have the same path
+  trajectory_writer_.reset();
+  trajectory_writer_.reset(new TrajectoryWriter(file_path, container_,
+                                                precision, keyframe_interval));
+}
+
+void SimulationEngine::StopTrajectoryRecording() {
+  // The writer is released even if closing it fails
+  std::unique_ptr<TrajectoryWriter> trajectory_writer =
+      std::move(trajectory_writer_);
+  if (trajectory_writer) {
+    trajectory_writer->Close();
+  }
+}
+
+const TrajectoryWriter* SimulationEngine::GetTrajectoryWriter() const {
+  return trajectory_writer_.get();
+}
+
+void SimulationEngine::StartCollisionEventStream(const string& file_path,
+                                                 size_t capacity,
+                                                 OverflowPolicy policy) {
+  StopCollisionEventStream();
+  collision_event_stream_.reset(
+      new CollisionEventStream(capacity, policy, file_path));
+  container_.SetCollisionEventStream(collision_event_stream_.get());
+}
+
+void SimulationEngine::StartCollisionEventStream(
+    const CollisionEventStream::Sink& sink, size_t capacity,
+    OverflowPolicy policy) {
+  StopCollisionEventStream();
+  collision_event_stream_.reset(
+      new CollisionEventStream(capacity, policy, sink));
+  container_.SetCollisionEventStream(collision_event_stream_.get());
+}
+
+void SimulationEngine::StopCollisionEventStream() {
+  // Detach first so the container never publishes to a destroyed stream
+  container_.SetCollisionEventStream(nullptr);
+  collision_event_stream_.reset();
+}
+
+const CollisionEventStream* SimulationEngine::GetCollisionEventStream() const {
+  return collision_event_stream_.get();
+}
+
+void SimulationEngine::UpdateHistograms() {
+  size_t quantity_count = histogram_specifications_.size();
+
   // Can't declare hist a const reference since we need to update internal state
   for (Histogram& hist : histograms_) {
-    hist.UpdateBinDistribution(particle_speeds.at(hist.GetDataLabel()));
+    hist.ResetBins();
   }
+
+  for (size_t type_idx = 0; type_idx < particle_type_names_.size(); type_idx++) {
+    // The histograms of a single type are stored next to each other
+    auto type_histograms = histograms_.begin() + type_idx * quantity_count;
+
+    // Scan the particles in place so that no particles or values are copied
+    for (const GasParticle& particle :
+         container_.GetParticlesOfType(particle_type_names_[type_idx])) {
+      for (size_t idx = 0; idx < quantity_count; idx++) {
+        type_histograms[idx].AddValue(MeasureParticleQuantity(
+            particle, histogram_specifications_[idx].quantity));
+      }
+    }
+  }
+}
+
+const Histogram& SimulationEngine::GetHistogram(
+    const string& type_name, ParticleQuantity quantity) const {
+  size_t quantity_count = histogram_specifications_.size();
+
+  for (size_t type_idx = 0; type_idx < particle_type_names_.size(); type_idx++) {
+    if (particle_type_names_[type_idx] != type_name) {
+      continue;
+    }
+
+    for (size_t idx = 0; idx < quantity_count; idx++) {
+      if (histogram_specifications_[idx].quantity == quantity) {
+        return histograms_[type_idx * quantity_count + idx];
+      }
+    }
+  }
+
+  throw std::invalid_argument("There is no histogram for that quantity.");
+}
+
+const FrameObservables& SimulationEngine::GetObservables() const {
+  return container_.GetObservables();
+}
+
+const CollisionStatistics& SimulationEngine::GetCollisionStatistics() const {
+  return container_.GetCollisionStatistics();
 }
 
 void SimulationEngine::Render() {
   container_.Display();
-  for (const Histogram& hist : histograms_) {
-    hist.Draw();
+
+  size_t quantity_count = histogram_specifications_.size();
+  for (size_t idx = 0; idx < histograms_.size(); idx++) {
+    if (histogram_specifications_[idx % quantity_count].display) {
+      histograms_[idx].Draw();
+    }
+  }
+}
+
+void SimulationEngine::CaptureFrame(SimulationFrame& frame) const {
+  const vector<GasParticle>& particles = container_.GetParticles();
+  frame.positions.resize(particles.size());
+  frame.radii.resize(particles.size());
+  frame.colors.resize(particles.size());
+  for (size_t idx = 0; idx < particles.size(); idx++) {
+    frame.positions[idx] = particles[idx].GetPosition();
+    frame.radii[idx] = particles[idx].GetRadius();
+    frame.colors[idx] = particles[idx].GetColor();
   }
+
+  // Assign over the histograms already in the frame to reuse their bins
+  size_t quantity_count = histogram_specifications_.size();
+  size_t displayed_count = 0;
+  for (size_t idx = 0; idx < histograms_.size(); idx++) {
+    if (!histogram_specifications_[idx % quantity_count].display) {
+      continue;
+    }
+
+    if (displayed_count < frame.histograms.size()) {
+      frame.histograms[displayed_count] = histograms_[idx];
+    } else {
+      frame.histograms.push_back(histograms_[idx]);
+    }
+    displayed_count++;
+  }
+  frame.histograms.erase(frame.histograms.begin() + displayed_count,
+                         frame.histograms.end());
+
+  frame.particle_set = particle_set_;
+  frame.save_status = GetSaveStatus();
+  frame.library_store_status = GetLibraryStoreStatus();
 }
 
 }  // namespace idealgas
@@ -0,0 +1,55 @@
+//
+// Created by Neil Kaushikkar on 6/5/21.
+//
+
+#include "simulation_frame.h"
+
+#include "container_drawing.h"
+
+#include <algorithm>
+
+namespace idealgas {
+
+using glm::vec2;
+using std::vector;
+
+float FindInterpolationFraction(
+    SimulationFrame::Clock::time_point previous_time,
+    SimulationFrame::Clock::time_point latest_time,
+    SimulationFrame::Clock::time_point current_time) {
+  if (latest_time <= previous_time) {
+    return 1;
+  }
+
+  std::chrono::duration<float> step_time = latest_time - previous_time;
+  std::chrono::duration<float> elapsed_time = current_time - latest_time;
+
+  return std::min(1.0f, std::max(0.0f, elapsed_time / step_time));
+}
+
+void InterpolatePositions(const vector<vec2>& previous_positions,
+                          const vector<vec2>& latest_positions,
+                          float fraction, vector<vec2>& positions) {
+  // The particles were replaced between the frames, so nothing lines up
+  if (previous_positions.size() != latest_positions.size()) {
+    positions = latest_positions;
+    return;
+  }
+
+  positions.resize(latest_positions.size());
+  for (size_t idx = 0; idx < latest_positions.size(); idx++) {
+    positions[idx] = previous_positions[idx]
+        + fraction * (latest_positions[idx] - previous_positions[idx]);
+  }
+}
+
+void DrawSimulationFrame(const SimulationFrame& frame,
+                         const vector<vec2>& positions) {
+  DrawContainerContents(positions, frame.radii, frame.colors);
+
+  for (const Histogram& histogram : frame.histograms) {
+    histogram.Draw();
+  }
+}
+
+}  // namespace idealgas
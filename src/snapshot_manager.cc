@@ -0,0 +1,223 @@
+//
+// Created by Neil Kaushikkar on 5/27/21.
+//
+
+#include "snapshot_manager.h"
+
+#include "mapped_file.h"
+
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <vector>
+
+namespace idealgas {
+
+using glm::vec2;
+using std::map;
+using std::string;
+using std::vector;
+
+const char SnapshotManager::kFileSignature[4] = {'I', 'G', 'S', 'S'};
+constexpr uint32_t SnapshotManager::kFileVersion;
+constexpr size_t SnapshotManager::kColumnAlignment;
+
+static_assert(sizeof(SnapshotManager::SnapshotHeader) == 64,
+              "The snapshot header must stay 64 bytes to keep its layout.");
+static_assert(sizeof(SnapshotManager::SnapshotSpeciesEntry) == 20,
+              "Species entries must not gain padding between fields.");
+
+SnapshotManager::SnapshotManager() = default;
+
+uint64_t SnapshotManager::AlignOffset(uint64_t offset) {
+  return (offset + kColumnAlignment - 1) / kColumnAlignment * kColumnAlignment;
+}
+
+void SnapshotManager::WriteContainerToSnapshot(
+    const GasContainer& container, const string& save_file_path) const {
+  const map<string, ParticleSpecs>& specifications =
+      container.GetParticleSpecifications();
+  const vector<GasParticle>& particles = container.GetParticles();
+
+  // Types are numbered in the order the table lists them
+  map<string, uint32_t> species_ids;
+  vector<SnapshotSpeciesEntry> species_entries;
+  string species_names;
+
+  for (const auto& type_specs : specifications) {
+    const ParticleSpecs& specs = type_specs.second;
+    species_ids[type_specs.first] =
+        static_cast<uint32_t>(species_entries.size());
+
+    SnapshotSpeciesEntry entry = {
+        specs.radius, specs.mass, specs.color.r, specs.color.g, specs.color.b,
+        0, static_cast<uint32_t>(species_names.size()),
+        static_cast<uint32_t>(type_specs.first.size())};
+    species_entries.push_back(entry);
+    species_names += type_specs.first;
+  }
+
+  SnapshotHeader header;
+  std::memcpy(header.signature, kFileSignature, sizeof(kFileSignature));
+  header.version = kFileVersion;
+  header.particle_count = particles.size();
+  header.species_count = static_cast<uint32_t>(species_entries.size());
+  header.species_names_size = static_cast<uint32_t>(species_names.size());
+  header.species_table_offset = sizeof(SnapshotHeader);
+  header.positions_offset = AlignOffset(
+      header.species_table_offset
+      + species_entries.size() * sizeof(SnapshotSpeciesEntry)
+      + species_names.size());
+  header.velocities_offset = AlignOffset(
+      header.positions_offset + particles.size() * sizeof(vec2));
+  header.species_ids_offset = AlignOffset(
+      header.velocities_offset + particles.size() * sizeof(vec2));
+  header.file_size =
+      header.species_ids_offset + particles.size() * sizeof(uint32_t);
+
+  // Gather each column from the particles before writing it in one piece
+  vector<vec2> positions(particles.size());
+  vector<vec2> velocities(particles.size());
+  vector<uint32_t> particle_species_ids(particles.size());
+
+  for (size_t idx = 0; idx < particles.size(); idx++) {
+    auto species_id = species_ids.find(particles[idx].GetTypeName());
+    if (species_id == species_ids.end()) {
+      throw std::invalid_argument("A particle's type has no specifications.");
+    }
+
+    positions[idx] = particles[idx].GetPosition();
+    velocities[idx] = particles[idx].GetVelocity();
+    particle_species_ids[idx] = species_id->second;
+  }
+
+  std::ofstream output_file(save_file_path, std::ios::binary | std::ios::trunc);
+  if (!output_file.is_open()) {
+    throw std::invalid_argument("The file path is not valid");
+  }
+
+  uint64_t written_size = 0;
+  auto write_bytes = [&](const void* bytes, uint64_t length) {
+    output_file.write(static_cast<const char*>(bytes), length);
+    written_size += length;
+  };
+  auto pad_to = [&](uint64_t offset) {
+    static const char kPadding[kColumnAlignment] = {};
+    write_bytes(kPadding, offset - written_size);
+  };
+
+  write_bytes(&header, sizeof(header));
+  write_bytes(species_entries.data(),
+              species_entries.size() * sizeof(SnapshotSpeciesEntry));
+  write_bytes(species_names.data(), species_names.size());
+
+  pad_to(header.positions_offset);
+  write_bytes(positions.data(), positions.size() * sizeof(vec2));
+  pad_to(header.velocities_offset);
+  write_bytes(velocities.data(), velocities.size() * sizeof(vec2));
+  pad_to(header.species_ids_offset);
+  write_bytes(particle_species_ids.data(),
+              particle_species_ids.size() * sizeof(uint32_t));
+
+  // A short write, like on a full disk, must not pass as a complete snapshot
+  output_file.close();
+  if (!output_file) {
+    throw std::invalid_argument("The snapshot could not be written");
+  }
+}
+
+GasContainer SnapshotManager::LoadContainerFromSnapshot(
+    const string& snapshot_file_path) const {
+  MappedFile snapshot(snapshot_file_path);
+  return LoadContainerFromSnapshotData(snapshot.GetData(), snapshot.GetSize());
+}
+
+GasContainer SnapshotManager::LoadContainerFromSnapshotData(
+    const char* data, uint64_t file_size) const {
+  SnapshotHeader header;
+  if (file_size < sizeof(header)) {
+    throw std::invalid_argument("The file is too small to be a snapshot.");
+  }
+  std::memcpy(&header, data, sizeof(header));
+
+  if (std::memcmp(header.signature, kFileSignature,
+                  sizeof(kFileSignature)) != 0) {
+    throw std::invalid_argument("The file is not a snapshot.");
+  }
+
+  if (header.version != kFileVersion) {
+    throw std::invalid_argument("The snapshot version is not supported.");
+  }
+
+  // Divide rather than multiply so huge counts can't overflow the checks
+  uint64_t particle_count = header.particle_count;
+  bool is_layout_valid = header.file_size == file_size
+      && particle_count <= file_size / sizeof(vec2)
+      && MappedFile::IsRangeInFile(
+             header.species_table_offset,
+             header.species_count * sizeof(SnapshotSpeciesEntry)
+             + header.species_names_size, file_size)
+      && MappedFile::IsRangeInFile(header.positions_offset,
+                                   particle_count * sizeof(vec2), file_size)
+      && MappedFile::IsRangeInFile(header.velocities_offset,
+                                   particle_count * sizeof(vec2), file_size)
+      && MappedFile::IsRangeInFile(header.species_ids_offset,
+                                   particle_count * sizeof(uint32_t),
+                                   file_size)
+      && header.positions_offset % kColumnAlignment == 0
+      && header.velocities_offset % kColumnAlignment == 0
+      && header.species_ids_offset % kColumnAlignment == 0;
+
+  if (!is_layout_valid) {
+    throw std::invalid_argument("The snapshot is truncated or corrupt.");
+  }
+
+  const char* species_table = data + header.species_table_offset;
+  const char* species_names = species_table
+      + header.species_count * sizeof(SnapshotSpeciesEntry);
+
+  map<string, ParticleSpecs> specifications;
+  vector<ParticleSpecs> specs_by_id;
+
+  for (size_t id = 0; id < header.species_count; id++) {
+    SnapshotSpeciesEntry entry;
+    std::memcpy(&entry, species_table + id * sizeof(entry), sizeof(entry));
+
+    if (!MappedFile::IsRangeInFile(entry.name_offset, entry.name_length,
+                                   header.species_names_size)) {
+      throw std::invalid_argument("The snapshot is truncated or corrupt.");
+    }
+
+    ParticleSpecs specs = {
+        entry.radius, entry.mass,
+        ci::Color8u(entry.red, entry.green, entry.blue),
+        string(species_names + entry.name_offset, entry.name_length)};
+    specs_by_id.push_back(specs);
+    specifications[specs.name] = specs;
+  }
+
+  // The columns are aligned in the snapshot, and so is the snapshot itself
+  const float* positions =
+      reinterpret_cast<const float*>(data + header.positions_offset);
+  const float* velocities =
+      reinterpret_cast<const float*>(data + header.velocities_offset);
+  const uint32_t* species_ids =
+      reinterpret_cast<const uint32_t*>(data + header.species_ids_offset);
+
+  vector<GasParticle> particles;
+  particles.reserve(particle_count);
+
+  for (size_t idx = 0; idx < particle_count; idx++) {
+    if (species_ids[idx] >= specs_by_id.size()) {
+      throw std::invalid_argument("The snapshot is truncated or corrupt.");
+    }
+
+    particles.emplace_back(vec2(positions[2 * idx], positions[2 * idx + 1]),
+                           vec2(velocities[2 * idx], velocities[2 * idx + 1]),
+                           specs_by_id[species_ids[idx]]);
+  }
+
+  return GasContainer(std::move(particles), std::move(specifications));
+}
+
+}  // namespace idealgas
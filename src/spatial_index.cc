@@ -0,0 +1,175 @@
+//
+// Created by Neil Kaushikkar on 5/25/21.
+//
+
+#include "spatial_index.h"
+
+#include <algorithm>
+#include <cmath>
+#include <queue>
+#include <stdexcept>
+#include <utility>
+
+namespace idealgas {
+
+using glm::vec2;
+using std::vector;
+
+constexpr float SpatialIndex::kParticlesPerCell;
+
+SpatialIndex::SpatialIndex() : cell_list_(), region_(), particle_count_(0) {}
+
+void SpatialIndex::Build(const vector<GasParticle>& particles,
+                         const ci::Rectf& region) {
+  bool is_region_changed = region.getX1() != region_.getX1()
+                           || region.getY1() != region_.getY1()
+                           || region.getX2() != region_.getX2()
+                           || region.getY2() != region_.getY2();
+
+  // The cell size only depends on the density, so it rarely needs to change
+  if (is_region_changed || particles.size() != particle_count_
+      || positions_.empty()) {
+    float area = region.getWidth() * region.getHeight();
+    float cell_size = std::max(region.getWidth(), region.getHeight());
+    if (!particles.empty()) {
+      cell_size = std::min(
+          cell_size, std::sqrt(kParticlesPerCell * area / particles.size()));
+    }
+
+    cell_list_ = CellList(region.getUpperLeft(), region.getLowerRight(),
+                          cell_size);
+    region_ = region;
+    particle_count_ = particles.size();
+  }
+
+  positions_.resize(particles.size());
+  for (size_t idx = 0; idx < particles.size(); idx++) {
+    positions_[idx] = particles[idx].GetPosition();
+  }
+
+  cell_list_.Build(particles);
+}
+
+vector<size_t> SpatialIndex::FindParticlesWithinRadius(const vec2& center,
+                                                       float radius) const {
+  vector<size_t> found;
+  vec2 lower_corner = center - vec2(radius, radius);
+  vec2 upper_corner = center + vec2(radius, radius);
+
+  for (size_t row = cell_list_.FindRow(lower_corner);
+       row <= cell_list_.FindRow(upper_corner); row++) {
+    for (size_t column = cell_list_.FindColumn(lower_corner);
+         column <= cell_list_.FindColumn(upper_corner); column++) {
+      for (const size_t* particle = cell_list_.GetCellBegin(column, row);
+           particle != cell_list_.GetCellEnd(column, row); particle++) {
+        vec2 offset = positions_[*particle] - center;
+        if (glm::dot(offset, offset) <= radius * radius) {
+          found.push_back(*particle);
+        }
+      }
+    }
+  }
+
+  return found;
+}
+
+vector<size_t> SpatialIndex::FindParticlesInBox(
+    const vec2& lower_corner, const vec2& upper_corner) const {
+  vector<size_t> found;
+
+  for (size_t row = cell_list_.FindRow(lower_corner);
+       row <= cell_list_.FindRow(upper_corner); row++) {
+    for (size_t column = cell_list_.FindColumn(lower_corner);
+         column <= cell_list_.FindColumn(upper_corner); column++) {
+      for (const size_t* particle = cell_list_.GetCellBegin(column, row);
+           particle != cell_list_.GetCellEnd(column, row); particle++) {
+        const vec2& position = positions_[*particle];
+        if (position.x >= lower_corner.x && position.x <= upper_corner.x
+            && position.y >= lower_corner.y && position.y <= upper_corner.y) {
+          found.push_back(*particle);
+        }
+      }
+    }
+  }
+
+  return found;
+}
+
+vector<size_t> SpatialIndex::FindNearestNeighbors(size_t particle_idx,
+                                                  size_t neighbor_count) const {
+  if (particle_idx >= positions_.size()) {
+    throw std::invalid_argument("The particle index is out of range.");
+  }
+
+  const vec2& center = positions_[particle_idx];
+  long center_column = static_cast<long>(cell_list_.FindColumn(center));
+  long center_row = static_cast<long>(cell_list_.FindRow(center));
+  long column_count = static_cast<long>(cell_list_.GetColumnCount());
+  long row_count = static_cast<long>(cell_list_.GetRowCount());
+
+  // The farthest neighbour found so far is always on top
+  std::priority_queue<std::pair<float, size_t>> nearest;
+
+  auto visit_cell = [&](long column, long row) {
+    if (column < 0 || column >= column_count || row < 0 || row >= row_count) {
+      return;
+    }
+
+    for (const size_t* particle = cell_list_.GetCellBegin(column, row);
+         particle != cell_list_.GetCellEnd(column, row); particle++) {
+      if (*particle == particle_idx) {
+        continue;
+      }
+
+      vec2 offset = positions_[*particle] - center;
+      float distance_squared = glm::dot(offset, offset);
+
+      if (nearest.size() < neighbor_count) {
+        nearest.emplace(distance_squared, *particle);
+      } else if (distance_squared < nearest.top().first) {
+        nearest.pop();
+        nearest.emplace(distance_squared, *particle);
+      }
+    }
+  };
+
+  long max_ring = std::max(std::max(center_column, column_count - 1
+                                                   - center_column),
+                           std::max(center_row, row_count - 1 - center_row));
+  float min_cell_size = std::min(cell_list_.GetCellWidth(),
+                                 cell_list_.GetCellHeight());
+
+  // Search rings of cells outward until no unvisited cell can hold a closer one
+  for (long ring = 0; ring <= max_ring && neighbor_count > 0; ring++) {
+    for (long row = center_row - ring; row <= center_row + ring; row++) {
+      bool is_ring_edge = row == center_row - ring || row == center_row + ring;
+
+      if (is_ring_edge) {
+        for (long column = center_column - ring;
+             column <= center_column + ring; column++) {
+          visit_cell(column, row);
+        }
+      } else {
+        visit_cell(center_column - ring, row);
+        visit_cell(center_column + ring, row);
+      }
+    }
+
+    // Cells in the next ring are at least ring cell widths away
+    float reach = ring * min_cell_size;
+    if (nearest.size() == neighbor_count
+        && nearest.top().first <= reach * reach) {
+      break;
+    }
+  }
+
+  vector<size_t> neighbors(nearest.size());
+  for (size_t idx = neighbors.size(); idx > 0; idx--) {
+    neighbors[idx - 1] = nearest.top().second;
+    nearest.pop();
+  }
+
+  return neighbors;
+}
+
+}  // namespace idealgas
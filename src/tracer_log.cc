@@ -0,0 +1,124 @@
+//
+// Created by Neil Kaushikkar on 5/26/21.
+//
+
+#include "tracer_log.h"
+
+#include <algorithm>
+#include <random>
+
+namespace idealgas {
+
+using nlohmann::json;
+using std::string;
+using std::vector;
+
+constexpr size_t TracerLogger::kBufferedFrameCount;
+
+void from_json(const json& json_object, TracerSelector& selector) {
+  TracerSelector defaults;
+
+  selector.particle_name =
+      json_object.value("particle_name", defaults.particle_name);
+  selector.first_id = json_object.value("first_id", defaults.first_id);
+  selector.end_id = json_object.value("end_id", defaults.end_id);
+  selector.sample_count =
+      json_object.value("sample_count", defaults.sample_count);
+  selector.seed = json_object.value("seed", defaults.seed);
+}
+
+vector<size_t> SelectTracers(const GasContainer& container,
+                             const vector<TracerSelector>& selectors) {
+  size_t particle_count = container.GetParticles().size();
+  vector<bool> is_selected(particle_count, false);
+  vector<size_t> candidates;
+
+  for (const TracerSelector& selector : selectors) {
+    candidates.clear();
+    size_t end_id = std::min(selector.end_id, particle_count);
+
+    if (selector.particle_name.empty()) {
+      for (size_t idx = selector.first_id; idx < end_id; idx++) {
+        candidates.push_back(idx);
+      }
+    } else {
+      ParticleView particles =
+          container.GetParticlesOfType(selector.particle_name);
+      if (particles.empty()) {
+        throw std::invalid_argument("There are no particles of the type "
+                                    + selector.particle_name + ".");
+      }
+
+      for (size_t idx : particles.GetIndices()) {
+        if (idx >= selector.first_id && idx < end_id) {
+          candidates.push_back(idx);
+        }
+      }
+    }
+
+    // A partial Fisher-Yates shuffle moves the sample to the front
+    size_t sample_count = candidates.size();
+    if (selector.sample_count > 0) {
+      sample_count = std::min(selector.sample_count, candidates.size());
+      std::mt19937 random(selector.seed);
+
+      for (size_t idx = 0; idx < sample_count; idx++) {
+        std::uniform_int_distribution<size_t> pick(idx, candidates.size() - 1);
+        std::swap(candidates[idx], candidates[pick(random)]);
+      }
+    }
+
+    for (size_t idx = 0; idx < sample_count; idx++) {
+      is_selected[candidates[idx]] = true;
+    }
+  }
+
+  vector<size_t> tracer_ids;
+  for (size_t idx = 0; idx < particle_count; idx++) {
+    if (is_selected[idx]) {
+      tracer_ids.push_back(idx);
+    }
+  }
+
+  return tracer_ids;
+}
+
+TracerLogger::TracerLogger(const vector<size_t>& tracer_ids,
+                           const string& file_path)
+    : tracer_ids_(tracer_ids), frame_count_(0),
+      stream_(std::max<size_t>(1, tracer_ids.size()) * kBufferedFrameCount,
+              OverflowPolicy::kBlock, file_path) {}
+
+void TracerLogger::Record(const GasContainer& container) {
+  const vector<GasParticle>& particles = container.GetParticles();
+  uint32_t frame = static_cast<uint32_t>(frame_count_++);
+
+  for (size_t particle_id : tracer_ids_) {
+    // Tracers don't exist in containers with fewer particles than they did
+    if (particle_id >= particles.size()) {
+      continue;
+    }
+
+    const GasParticle& particle = particles[particle_id];
+    const glm::vec2& position = particle.GetPosition();
+    const glm::vec2& velocity = particle.GetVelocity();
+
+    TracerRecord record = {frame, static_cast<uint32_t>(particle_id),
+                           position.x, position.y, velocity.x, velocity.y};
+    stream_.Publish(record);
+  }
+}
+
+void TracerLogger::Close() {
+  stream_.Close();
+}
+
+const vector<size_t>& TracerLogger::GetTracerIds() const {
+  return tracer_ids_;
+}
+
+size_t TracerLogger::GetFrameCount() const {
+  return frame_count_;
+}
+
+}  // namespace idealgas
@@ -0,0 +1,145 @@
+//
+// Created by Neil Kaushikkar on 5/29/21.
+//
+
+#include "trajectory_format.h"
+
+#include <stdexcept>
+
+namespace idealgas {
+
+using std::vector;
+
+const char kTrajectoryFileSignature[4] = {'I', 'G', 'T', 'R'};
+
+static_assert(sizeof(TrajectoryHeader) == 40,
+              "The trajectory header must not gain padding between fields.");
+static_assert(sizeof(TrajectoryFrameHeader) == 16,
+              "Frame headers must not gain padding between fields.");
+static_assert(sizeof(TrajectoryFooter) == 32,
+              "The trajectory footer must not gain padding between fields.");
+
+// The tags in the top 2 bits of each packed byte
+static constexpr uint8_t kZeroRunTag = 0x00;
+static constexpr uint8_t kSmallTripleTag = 0x40;
+static constexpr uint8_t kShortValueTag = 0x80;
+static constexpr uint8_t kLongValueTag = 0xC0;
+
+static constexpr size_t kMaxZeroRun = 64;
+static constexpr size_t kSmallTripleCount = 3;
+static constexpr uint32_t kSmallValueLimit = 4;
+static constexpr uint32_t kShortValueLimit = 64;
+
+/**
+ * Maps signed integers to unsigned ones so that values near 0 stay small:
+ * 0, -1, 1, -2, 2 become 0, 1, 2, 3, 4.
+ */
+static uint32_t ZigzagEncode(int32_t value) {
+  return (static_cast<uint32_t>(value) << 1)
+         ^ static_cast<uint32_t>(value >> 31);
+}
+
+static int32_t ZigzagDecode(uint32_t value) {
+  return static_cast<int32_t>((value >> 1) ^ (~(value & 1) + 1));
+}
+
+void EncodeTrajectoryValues(const vector<int32_t>& values,
+                            vector<uint8_t>& output) {
+  size_t idx = 0;
+
+  while (idx < values.size()) {
+    size_t zero_count = 0;
+    while (idx + zero_count < values.size() && zero_count < kMaxZeroRun
+           && values[idx + zero_count] == 0) {
+      zero_count++;
+    }
+
+    bool is_small_triple = idx + kSmallTripleCount <= values.size();
+    for (size_t offset = 0; is_small_triple && offset < kSmallTripleCount;
+         offset++) {
+      is_small_triple = ZigzagEncode(values[idx + offset]) < kSmallValueLimit;
+    }
+
+    // Short runs of zeroes are cheaper to pack along with their neighbours
+    if (zero_count >= kSmallTripleCount
+        || (zero_count > 0 && !is_small_triple)) {
+      output.push_back(kZeroRunTag | static_cast<uint8_t>(zero_count - 1));
+      idx += zero_count;
+    } else if (is_small_triple) {
+      output.push_back(kSmallTripleTag
+                       | static_cast<uint8_t>(ZigzagEncode(values[idx]) << 4
+                           | ZigzagEncode(values[idx + 1]) << 2
+                           | ZigzagEncode(values[idx + 2])));
+      idx += kSmallTripleCount;
+    } else {
+      uint32_t value = ZigzagEncode(values[idx]);
+
+      if (value < kShortValueLimit) {
+        output.push_back(kShortValueTag | static_cast<uint8_t>(value));
+      } else {
+        output.push_back(kLongValueTag | static_cast<uint8_t>(value & 0x3F));
+
+        // Values this large always have bits left after the first 6
+        uint32_t remaining = value >> 6;
+        while (remaining >= 0x80) {
+          output.push_back(static_cast<uint8_t>(remaining & 0x7F) | 0x80);
+          remaining >>= 7;
+        }
+        output.push_back(static_cast<uint8_t>(remaining));
+      }
+
+      idx++;
+    }
+  }
+}
+
+void DecodeTrajectoryValues(const uint8_t* data, size_t size,
+                            vector<int32_t>& values) {
+  size_t value_count = 0;
+  size_t position = 0;
+
+  while (position < size) {
+    uint8_t byte = data[position++];
+    uint8_t tag = byte & 0xC0;
+    size_t decoded_count = tag == kZeroRunTag ? (byte & 0x3F) + 1
+                           : tag == kSmallTripleTag ? kSmallTripleCount : 1;
+
+    if (value_count + decoded_count > values.size()) {
+      throw std::invalid_argument("The trajectory frame has too many values.");
+    }
+
+    if (tag == kZeroRunTag) {
+      for (size_t idx = 0; idx < decoded_count; idx++) {
+        values[value_count++] = 0;
+      }
+    } else if (tag == kSmallTripleTag) {
+      values[value_count++] = ZigzagDecode((byte >> 4) & 0x03);
+      values[value_count++] = ZigzagDecode((byte >> 2) & 0x03);
+      values[value_count++] = ZigzagDecode(byte & 0x03);
+    } else if (tag == kShortValueTag) {
+      values[value_count++] = ZigzagDecode(byte & 0x3F);
+    } else {
+      uint32_t value = byte & 0x3F;
+      uint32_t shift = 6;
+      uint8_t varint_byte;
+
+      do {
+        if (position >= size || shift >= 32) {
+          throw std::invalid_argument("The trajectory frame is corrupt.");
+        }
+
+        varint_byte = data[position++];
+        value |= static_cast<uint32_t>(varint_byte & 0x7F) << shift;
+        shift += 7;
+      } while (varint_byte & 0x80);
+
+      values[value_count++] = ZigzagDecode(value);
+    }
+  }
+
+  if (value_count != values.size()) {
+    throw std::invalid_argument("The trajectory frame has too few values.");
+  }
+}
+
+}  // namespace idealgas
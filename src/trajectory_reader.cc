@@ -0,0 +1,265 @@
+//
+// Created by Neil Kaushikkar on 5/30/21.
+//
+
+#include "trajectory_reader.h"
+
+#include "snapshot_manager.h"
+
+#include <cstring>
+#include <stdexcept>
+
+namespace idealgas {
+
+using glm::vec2;
+using std::string;
+using std::vector;
+
+typedef SnapshotManager::SnapshotSpeciesEntry SpeciesEntry;
+
+TrajectoryReader::TrajectoryReader(const string& file_path)
+    : file_(file_path), frames_end_offset_(0), frame_count_(0),
+      has_decoded_frame_(false), decoded_frame_(0), next_block_offset_(0) {
+  const char* data = file_.GetData();
+  uint64_t file_size = file_.GetSize();
+
+  if (file_size < sizeof(header_)) {
+    throw std::invalid_argument("The file is too small to be a trajectory.");
+  }
+  std::memcpy(&header_, data, sizeof(header_));
+
+  if (std::memcmp(header_.signature, kTrajectoryFileSignature,
+                  sizeof(kTrajectoryFileSignature)) != 0) {
+    throw std::invalid_argument("The file is not a trajectory.");
+  }
+
+  if (header_.version != kTrajectoryFileVersion) {
+    throw std::invalid_argument("The trajectory version is not supported.");
+  }
+
+  // Divide rather than multiply so huge counts can't overflow the checks
+  uint64_t species_table_offset = sizeof(header_);
+  bool is_layout_valid = header_.precision > 0
+      && header_.keyframe_interval > 0
+      && header_.species_count <= file_size / sizeof(SpeciesEntry)
+      && header_.particle_count <= file_size / sizeof(uint32_t)
+      && MappedFile::IsRangeInFile(
+             species_table_offset,
+             header_.species_count * sizeof(SpeciesEntry)
+             + header_.species_names_size, file_size);
+
+  uint64_t type_ids_offset = species_table_offset
+      + header_.species_count * sizeof(SpeciesEntry)
+      + header_.species_names_size;
+  is_layout_valid = is_layout_valid
+      && MappedFile::IsRangeInFile(type_ids_offset,
+                                   header_.particle_count * sizeof(uint32_t),
+                                   file_size);
+
+  if (!is_layout_valid) {
+    throw std::invalid_argument("The trajectory is truncated or corrupt.");
+  }
+
+  const char* species_names = data + species_table_offset
+      + header_.species_count * sizeof(SpeciesEntry);
+
+  for (size_t id = 0; id < header_.species_count; id++) {
+    SpeciesEntry entry;
+    std::memcpy(&entry, data + species_table_offset + id * sizeof(entry),
+                sizeof(entry));
+
+    if (!MappedFile::IsRangeInFile(entry.name_offset, entry.name_length,
+                                   header_.species_names_size)) {
+      throw std::invalid_argument("The trajectory is truncated or corrupt.");
+    }
+
+    ParticleSpecs specs = {
+        entry.radius, entry.mass,
+        ci::Color8u(entry.red, entry.green, entry.blue),
+        string(species_names + entry.name_offset, entry.name_length)};
+    particle_specs_.push_back(specs);
+  }
+
+  particle_type_ids_.resize(header_.particle_count);
+  std::memcpy(particle_type_ids_.data(), data + type_ids_offset,
+              particle_type_ids_.size() * sizeof(uint32_t));
+
+  for (uint32_t type_id : particle_type_ids_) {
+    if (type_id >= particle_specs_.size()) {
+      throw std::invalid_argument("The trajectory is truncated or corrupt.");
+    }
+  }
+
+  uint64_t frames_offset =
+      type_ids_offset + header_.particle_count * sizeof(uint32_t);
+
+  // Finished files end with a footer that locates the keyframe index
+  TrajectoryFooter footer;
+  bool has_index = file_size - frames_offset >= sizeof(footer);
+  if (has_index) {
+    std::memcpy(&footer, data + file_size - sizeof(footer), sizeof(footer));
+    has_index = std::memcmp(footer.signature, kTrajectoryFileSignature,
+                            sizeof(kTrajectoryFileSignature)) == 0;
+  }
+
+  if (has_index) {
+    uint64_t index_end_offset = file_size - sizeof(footer);
+    uint64_t expected_keyframe_count =
+        (footer.frame_count + header_.keyframe_interval - 1)
+        / header_.keyframe_interval;
+
+    bool is_index_valid = footer.keyframe_index_offset >= frames_offset
+        && footer.keyframe_count == expected_keyframe_count
+        && footer.keyframe_count <= file_size / sizeof(uint64_t)
+        && MappedFile::IsRangeInFile(footer.keyframe_index_offset,
+                                     footer.keyframe_count * sizeof(uint64_t),
+                                     index_end_offset)
+        && footer.keyframe_index_offset
+           + footer.keyframe_count * sizeof(uint64_t) == index_end_offset;
+
+    if (!is_index_valid) {
+      throw std::invalid_argument("The trajectory is truncated or corrupt.");
+    }
+
+    keyframe_offsets_.resize(footer.keyframe_count);
+    std::memcpy(keyframe_offsets_.data(), data + footer.keyframe_index_offset,
+                keyframe_offsets_.size() * sizeof(uint64_t));
+    frames_end_offset_ = footer.keyframe_index_offset;
+    frame_count_ = footer.frame_count;
+  } else {
+    ScanFrameBlocks(frames_offset);
+  }
+
+  values_.resize(2 * header_.particle_count);
+  positions_.resize(2 * header_.particle_count);
+  deltas_.resize(2 * header_.particle_count);
+}
+
+void TrajectoryReader::ReadFrame(size_t frame, vector<vec2>& positions) {
+  if (frame >= frame_count_) {
+    throw std::invalid_argument("The frame is not in the trajectory.");
+  }
+
+  size_t keyframe_id = frame / header_.keyframe_interval;
+  size_t keyframe = keyframe_id * header_.keyframe_interval;
+  if (keyframe_id >= keyframe_offsets_.size()) {
+    throw std::invalid_argument("The trajectory is truncated or corrupt.");
+  }
+
+  // Carry on from the last frame decoded if it is on the way to this frame
+  size_t first_frame = keyframe;
+  if (has_decoded_frame_ && decoded_frame_ >= keyframe
+      && decoded_frame_ <= frame) {
+    first_frame = decoded_frame_ + 1;
+  } else {
+    next_block_offset_ = keyframe_offsets_[keyframe_id];
+  }
+
+  for (size_t next_frame = first_frame; next_frame <= frame; next_frame++) {
+    DecodeNextFrame(next_frame);
+  }
+
+  positions.resize(header_.particle_count);
+  for (size_t idx = 0; idx < positions.size(); idx++) {
+    positions[idx] =
+        vec2(static_cast<float>(positions_[2 * idx] * header_.precision),
+             static_cast<float>(positions_[2 * idx + 1] * header_.precision));
+  }
+}
+
+size_t TrajectoryReader::GetFrameCount() const {
+  return frame_count_;
+}
+
+size_t TrajectoryReader::GetParticleCount() const {
+  return header_.particle_count;
+}
+
+double TrajectoryReader::GetPrecision() const {
+  return header_.precision;
+}
+
+size_t TrajectoryReader::GetKeyframeInterval() const {
+  return header_.keyframe_interval;
+}
+
+const vector<ParticleSpecs>& TrajectoryReader::GetParticleSpecs() const {
+  return particle_specs_;
+}
+
+const vector<uint32_t>& TrajectoryReader::GetParticleTypeIds() const {
+  return particle_type_ids_;
+}
+
+void TrajectoryReader::ScanFrameBlocks(uint64_t frames_offset) {
+  const char* data = file_.GetData();
+  uint64_t file_size = file_.GetSize();
+  uint64_t offset = frames_offset;
+
+  // Stop at the first block that was not completely written
+  while (MappedFile::IsRangeInFile(offset, sizeof(TrajectoryFrameHeader),
+                                   file_size)) {
+    TrajectoryFrameHeader frame_header;
+    std::memcpy(&frame_header, data + offset, sizeof(frame_header));
+
+    bool is_keyframe = frame_count_ % header_.keyframe_interval == 0;
+    if (frame_header.frame != frame_count_
+        || (frame_header.is_keyframe != 0) != is_keyframe
+        || !MappedFile::IsRangeInFile(offset + sizeof(frame_header),
+                                      frame_header.payload_size, file_size)) {
+      break;
+    }
+
+    if (is_keyframe) {
+      keyframe_offsets_.push_back(offset);
+    }
+
+    offset += sizeof(frame_header) + frame_header.payload_size;
+    frame_count_++;
+  }
+
+  frames_end_offset_ = offset;
+}
+
+void TrajectoryReader::DecodeNextFrame(size_t frame) {
+  // Nothing can follow on from a frame that fails to decode
+  has_decoded_frame_ = false;
+
+  TrajectoryFrameHeader frame_header;
+  if (!MappedFile::IsRangeInFile(next_block_offset_, sizeof(frame_header),
+                                 frames_end_offset_)) {
+    throw std::invalid_argument("The trajectory is truncated or corrupt.");
+  }
+  std::memcpy(&frame_header, file_.GetData() + next_block_offset_,
+              sizeof(frame_header));
+
+  uint64_t payload_offset = next_block_offset_ + sizeof(frame_header);
+  size_t frames_since_keyframe = frame % header_.keyframe_interval;
+
+  if (frame_header.frame != frame
+      || (frame_header.is_keyframe != 0) != (frames_since_keyframe == 0)
+      || !MappedFile::IsRangeInFile(payload_offset, frame_header.payload_size,
+                                    frames_end_offset_)) {
+    throw std::invalid_argument("The trajectory is truncated or corrupt.");
+  }
+
+  DecodeTrajectoryValues(
+      reinterpret_cast<const uint8_t*>(file_.GetData() + payload_offset),
+      frame_header.payload_size, values_);
+
+  for (size_t idx = 0; idx < values_.size(); idx++) {
+    if (frames_since_keyframe == 0) {
+      positions_[idx] = values_[idx];
+    } else {
+      deltas_[idx] = frames_since_keyframe == 1 ? values_[idx]
+                                                : deltas_[idx] + values_[idx];
+      positions_[idx] += deltas_[idx];
+    }
+  }
+
+  has_decoded_frame_ = true;
+  decoded_frame_ = frame;
+  next_block_offset_ = payload_offset + frame_header.payload_size;
+}
+
+}  // namespace idealgas
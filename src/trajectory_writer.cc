@@ -0,0 +1,262 @@
+//
+// Created by Neil Kaushikkar on 5/29/21.
+//
+
+#include "trajectory_writer.h"
+
+#include "snapshot_manager.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <map>
+#include <stdexcept>
+
+namespace idealgas {
+
+using std::map;
+using std::string;
+using std::vector;
+
+constexpr size_t TrajectoryWriter::kStagingBufferCount;
+
+TrajectoryWriter::TrajectoryWriter(const string& file_path,
+                                   const GasContainer& container,
+                                   double precision, size_t keyframe_interval)
+    : output_file_(file_path, std::ios::binary | std::ios::trunc),
+      precision_(precision), keyframe_interval_(keyframe_interval),
+      particle_count_(container.GetParticles().size()), frame_count_(0),
+      is_closing_(false) {
+  if (!output_file_.is_open()) {
+    throw std::invalid_argument("The file path is not valid");
+  }
+
+  if (precision <= 0) {
+    throw std::invalid_argument("The precision must be positive.");
+  }
+
+  // Residuals of positions inside the walls span twice the largest coordinate
+  // in quanta, and must fit in 32 bits
+  const ci::Rectf& wall_bound = container.GetWallBound();
+  double largest_coordinate = std::max(
+      std::max(std::abs(wall_bound.x1), std::abs(wall_bound.x2)),
+      std::max(std::abs(wall_bound.y1), std::abs(wall_bound.y2)));
+  if (2 * largest_coordinate / precision
+      > std::numeric_limits<int32_t>::max()) {
+    throw std::invalid_argument(
+        "The precision is too fine to quantize the container's positions.");
+  }
+
+  if (keyframe_interval == 0) {
+    throw std::invalid_argument("The keyframe interval must be positive.");
+  }
+
+  // The type table matches a snapshot's, with types numbered in table order
+  map<string, uint32_t> species_ids;
+  vector<SnapshotManager::SnapshotSpeciesEntry> species_entries;
+  string species_names;
+
+  for (const auto& type_specs : container.GetParticleSpecifications()) {
+    const ParticleSpecs& specs = type_specs.second;
+    species_ids[type_specs.first] =
+        static_cast<uint32_t>(species_entries.size());
+
+    SnapshotManager::SnapshotSpeciesEntry entry = {
+        specs.radius, specs.mass, specs.color.r, specs.color.g, specs.color.b,
+        0, static_cast<uint32_t>(species_names.size()),
+        static_cast<uint32_t>(type_specs.first.size())};
+    species_entries.push_back(entry);
+    species_names += type_specs.first;
+  }
+
+  vector<uint32_t> particle_species_ids;
+  particle_species_ids.reserve(particle_count_);
+
+  for (const GasParticle& particle : container.GetParticles()) {
+    auto species_id = species_ids.find(particle.GetTypeName());
+    if (species_id == species_ids.end()) {
+      throw std::invalid_argument("A particle's type has no specifications.");
+    }
+
+    particle_species_ids.push_back(species_id->second);
+  }
+
+  TrajectoryHeader header;
+  std::memcpy(header.signature, kTrajectoryFileSignature,
+              sizeof(kTrajectoryFileSignature));
+  header.version = kTrajectoryFileVersion;
+  header.precision = precision;
+  header.keyframe_interval = static_cast<uint32_t>(keyframe_interval);
+  header.species_count = static_cast<uint32_t>(species_entries.size());
+  header.particle_count = particle_count_;
+  header.species_names_size = static_cast<uint32_t>(species_names.size());
+  header.reserved = 0;
+
+  output_file_.write(reinterpret_cast<const char*>(&header), sizeof(header));
+  output_file_.write(
+      reinterpret_cast<const char*>(species_entries.data()),
+      species_entries.size() * sizeof(SnapshotManager::SnapshotSpeciesEntry));
+  output_file_.write(species_names.data(), species_names.size());
+  output_file_.write(reinterpret_cast<const char*>(particle_species_ids.data()),
+                     particle_species_ids.size() * sizeof(uint32_t));
+  file_size_ = sizeof(header)
+      + species_entries.size() * sizeof(SnapshotManager::SnapshotSpeciesEntry)
+      + species_names.size() + particle_species_ids.size() * sizeof(uint32_t);
+
+  previous_positions_.resize(2 * particle_count_);
+  previous_deltas_.resize(2 * particle_count_);
+  residuals_.resize(2 * particle_count_);
+  free_buffers_.assign(kStagingBufferCount,
+                       vector<float>(2 * particle_count_));
+
+  compression_thread_ = std::thread(&TrajectoryWriter::CompressFrames, this);
+}
+
+TrajectoryWriter::~TrajectoryWriter() {
+  // A destructor can't report a failed write, so Close should be called
+  // first by anyone who needs to know
+  try {
+    Close();
+  } catch (const std::invalid_argument&) {
+  }
+}
+
+void TrajectoryWriter::Record(const GasContainer& container) {
+  const vector<GasParticle>& particles = container.GetParticles();
+  if (particles.size() != particle_count_) {
+    throw std::invalid_argument("The number of particles has changed.");
+  }
+
+  vector<float> positions;
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (is_closing_) {
+      throw std::invalid_argument("The trajectory has been closed.");
+    }
+
+    buffer_available_.wait(lock, [this] { return !free_buffers_.empty(); });
+    positions.swap(free_buffers_.back());
+    free_buffers_.pop_back();
+  }
+
+  // Particles store their positions next to their other fields, so the
+  // positions are gathered one at a time rather than copied in one piece
+  for (size_t idx = 0; idx < particle_count_; idx++) {
+    const glm::vec2& position = particles[idx].GetPosition();
+    positions[2 * idx] = position.x;
+    positions[2 * idx + 1] = position.y;
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    StagedFrame staged_frame = {frame_count_++, std::move(positions)};
+    staged_frames_.push_back(std::move(staged_frame));
+  }
+
+  frame_available_.notify_one();
+}
+
+void TrajectoryWriter::Close() {
+  if (compression_thread_.joinable()) {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      is_closing_ = true;
+    }
+
+    frame_available_.notify_one();
+    compression_thread_.join();
+  }
+
+  if (output_file_.is_open()) {
+    TrajectoryFooter footer;
+    footer.keyframe_index_offset = file_size_;
+    footer.keyframe_count = keyframe_offsets_.size();
+    footer.frame_count = frame_count_;
+    std::memcpy(footer.signature, kTrajectoryFileSignature,
+                sizeof(kTrajectoryFileSignature));
+    footer.reserved = 0;
+
+    output_file_.write(reinterpret_cast<const char*>(keyframe_offsets_.data()),
+                       keyframe_offsets_.size() * sizeof(uint64_t));
+    output_file_.write(reinterpret_cast<const char*>(&footer), sizeof(footer));
+    output_file_.close();
+
+    // A failed write of any frame leaves the stream failed until here
+    if (!output_file_) {
+      throw std::invalid_argument("The trajectory could not be fully written.");
+    }
+  }
+}
+
+size_t TrajectoryWriter::GetFrameCount() const {
+  return frame_count_;
+}
+
+void TrajectoryWriter::CompressFrames() {
+  while (true) {
+    StagedFrame staged_frame;
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      frame_available_.wait(lock, [this] {
+        return is_closing_ || !staged_frames_.empty();
+      });
+
+      // Frames recorded before closing are still written
+      if (staged_frames_.empty()) {
+        return;
+      }
+
+      staged_frame = std::move(staged_frames_.front());
+      staged_frames_.pop_front();
+    }
+
+    WriteFrame(staged_frame);
+
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      free_buffers_.push_back(std::move(staged_frame.positions));
+    }
+
+    buffer_available_.notify_one();
+  }
+}
+
+void TrajectoryWriter::WriteFrame(const StagedFrame& staged_frame) {
+  bool is_keyframe = staged_frame.frame % keyframe_interval_ == 0;
+  bool follows_keyframe = staged_frame.frame % keyframe_interval_ == 1;
+
+  for (size_t idx = 0; idx < residuals_.size(); idx++) {
+    int32_t position = static_cast<int32_t>(
+        std::llround(staged_frame.positions[idx] / precision_));
+
+    if (is_keyframe) {
+      residuals_[idx] = position;
+    } else {
+      int32_t delta = position - previous_positions_[idx];
+      residuals_[idx] =
+          follows_keyframe ? delta : delta - previous_deltas_[idx];
+      previous_deltas_[idx] = delta;
+    }
+
+    previous_positions_[idx] = position;
+  }
+
+  payload_.clear();
+  EncodeTrajectoryValues(residuals_, payload_);
+
+  if (is_keyframe) {
+    keyframe_offsets_.push_back(file_size_);
+  }
+
+  TrajectoryFrameHeader frame_header = {
+      staged_frame.frame, static_cast<uint32_t>(is_keyframe),
+      static_cast<uint32_t>(payload_.size())};
+  output_file_.write(reinterpret_cast<const char*>(&frame_header),
+                     sizeof(frame_header));
+  output_file_.write(reinterpret_cast<const char*>(payload_.data()),
+                     payload_.size());
+  file_size_ += sizeof(frame_header) + payload_.size();
+}
+
+}  // namespace idealgas
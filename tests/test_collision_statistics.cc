@@ -0,0 +1,81 @@
+#include <catch2/catch.hpp>
+#include "test_helper.h"
+
+using idealgas::GasParticle;
+using idealgas::GasContainer;
+using idealgas::ParticleSpecs;
+using idealgas::CollisionStatistics;
+
+using idealgas_test::CreateParticle;
+
+using std::map;
+using std::string;
+using std::vector;
+
+TEST_CASE("Testing Collision Statistics Counting") {
+  CollisionStatistics statistics({"heavy", "light"}, {1, 2});
+
+  SECTION("Collisions are counted once for either order of types") {
+    statistics.RecordCollision(0, 1);
+    statistics.RecordCollision(1, 0);
+    statistics.RecordCollision(1, 1);
+
+    bool are_counts_accurate =
+        statistics.GetCollisionCount("heavy", "light") == 2;
+    are_counts_accurate &= statistics.GetCollisionCount("light", "heavy") == 2;
+    are_counts_accurate &= statistics.GetCollisionCount("light", "light") == 1;
+    are_counts_accurate &= statistics.GetCollisionCount("heavy", "heavy") == 0;
+
+    REQUIRE(are_counts_accurate);
+  }
+
+  SECTION("Collision frequency counts both particles of same type pairs") {
+    statistics.RecordCollision(0, 1);
+    statistics.RecordCollision(1, 1);
+    statistics.RecordFrame();
+    statistics.RecordFrame();
+
+    // light particles took part in 1 + 2 collisions, spread over 2 x 2 frames
+    REQUIRE(statistics.GetCollisionFrequency("light") == 0.75);
+  }
+
+  SECTION("Merging adds the counts of a frame's tally") {
+    CollisionStatistics tally({"heavy", "light"}, {1, 2});
+    tally.RecordFreePath(1, 2);
+    tally.RecordFreePath(1, 4);
+    tally.RecordFrame();
+
+    statistics.Merge(tally);
+    tally.Clear();
+    statistics.Merge(tally);
+
+    bool is_merged = statistics.GetMeanFreePath("light") == 3;
+    is_merged &= statistics.GetFrameCount() == 1;
+
+    REQUIRE(is_merged);
+  }
+}
+
+TEST_CASE("Testing Container Collision Recording") {
+  ParticleSpecs specs = {1, 1, ci::Color8u(255, 255, 255), "test"};
+  map<string, ParticleSpecs> specifications = {{"test", specs}};
+
+  SECTION("Colliding particles record the path they travelled") {
+    vector<GasParticle> particles = {CreateParticle(400, 200, 1, 0, specs),
+                                     CreateParticle(405, 200, -1, 0, specs)};
+    GasContainer container = GasContainer(particles, specifications);
+
+    for (size_t frame = 0; frame < 3; frame++) {
+      container.AdvanceOneFrame();
+    }
+
+    const CollisionStatistics& statistics = container.GetCollisionStatistics();
+
+    // The particles touch after 2 frames and collide on the 3rd
+    bool is_recorded = statistics.GetCollisionCount("test", "test") == 1;
+    is_recorded &= statistics.GetMeanFreePath("test") == 2;
+    is_recorded &= statistics.GetFrameCount() == 3;
+
+    REQUIRE(is_recorded);
+  }
+}
@@ -0,0 +1,62 @@
+#include <catch2/catch.hpp>
+#include <counter_rng.h>
+#include "test_helper.h"
+
+using idealgas::CounterRng;
+
+TEST_CASE("Testing Counter-Based Random Numbers") {
+  SECTION("Philox matches the published known-answer tests") {
+    CounterRng::Counter zeros =
+        CounterRng::Philox({{0, 0, 0, 0}}, {{0, 0}});
+    CounterRng::Counter ones = CounterRng::Philox(
+        {{0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff}},
+        {{0xffffffff, 0xffffffff}});
+    CounterRng::Counter digits_of_pi = CounterRng::Philox(
+        {{0x243f6a88, 0x85a308d3, 0x13198a2e, 0x03707344}},
+        {{0xa4093822, 0x299f31d0}});
+
+    bool is_matching =
+        zeros == CounterRng::Counter({{0x6627e8d5, 0xe169c58d,
+                                       0xbc57ac4c, 0x9b00dbd8}})
+        && ones == CounterRng::Counter({{0x408f276d, 0x41c83b0e,
+                                         0xa20bc7c6, 0x6d5451fd}})
+        && digits_of_pi == CounterRng::Counter({{0xd16cfe09, 0x94fdcceb,
+                                                 0x5001e420, 0x24126ea1}});
+
+    REQUIRE(is_matching);
+  }
+
+  SECTION("Generators with the same key draw the same numbers") {
+    CounterRng random(42, 1, 7);
+    CounterRng same_random(42, 1, 7);
+
+    bool is_same = true;
+    for (size_t draw = 0; draw < 10; draw++) {
+      is_same &= random.NextUint() == same_random.NextUint();
+    }
+
+    REQUIRE(is_same);
+  }
+
+  SECTION("Seeds, streams, and indices each change the numbers") {
+    uint32_t value = CounterRng(42, 1, 7).NextUint();
+
+    bool is_different = value != CounterRng(43, 1, 7).NextUint()
+                        && value != CounterRng(42, 2, 7).NextUint()
+                        && value != CounterRng(42, 1, 8).NextUint();
+
+    REQUIRE(is_different);
+  }
+
+  SECTION("Floats are drawn within their range") {
+    CounterRng random(3, 0, 0);
+
+    bool is_in_range = true;
+    for (size_t draw = 0; draw < 1000; draw++) {
+      float value = random.NextFloat(-2, 5);
+      is_in_range &= value >= -2 && value < 5;
+    }
+
+    REQUIRE(is_in_range);
+  }
+}
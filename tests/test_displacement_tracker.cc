@@ -0,0 +1,79 @@
+#include <catch2/catch.hpp>
+#include <displacement_tracker.h>
+#include "test_helper.h"
+
+using idealgas::GasParticle;
+using idealgas::GasContainer;
+using idealgas::ParticleSpecs;
+using idealgas::DisplacementTracker;
+
+using idealgas_test::CreateParticle;
+
+using glm::vec2;
+using std::map;
+using std::string;
+using std::vector;
+
+TEST_CASE("Testing Unwrapped Particle Displacement") {
+  ParticleSpecs specs = {1, 1, ci::Color8u(255, 255, 255), "test"};
+
+  SECTION("Displacement matches the position change away from walls") {
+    GasParticle particle = CreateParticle(400, 200, 2, -1, specs);
+    particle.UpdatePosition();
+    particle.UpdatePosition();
+
+    REQUIRE(particle.GetUnwrappedDisplacement() == vec2(4, -2));
+  }
+
+  SECTION("Displacement keeps growing through a wall bounce") {
+    GasParticle particle = CreateParticle(400, 200, 2, 0, specs);
+    particle.UpdatePosition();
+    particle.ReflectOffWall(GasContainer::kXAxis);
+    particle.UpdatePosition();
+
+    bool is_unwrapped = particle.GetPosition() == vec2(400, 200);
+    is_unwrapped &= particle.GetUnwrappedDisplacement() == vec2(4, 0);
+
+    REQUIRE(is_unwrapped);
+  }
+}
+
+TEST_CASE("Testing Mean Squared Displacement Tracking") {
+  ParticleSpecs specs = {1, 1, ci::Color8u(255, 255, 255), "test"};
+  map<string, ParticleSpecs> specifications = {{"test", specs}};
+
+  SECTION("Lags are powers of 2 up to the maximum lag") {
+    DisplacementTracker tracker(10, 2);
+
+    REQUIRE(tracker.GetLags() == vector<size_t>({1, 2, 4, 8}));
+  }
+
+  SECTION("Ballistic particles have MSD of (speed * lag)^2") {
+    vector<GasParticle> particles = {CreateParticle(400, 200, 1, 0, specs),
+                                     CreateParticle(400, 300, 0, -1, specs)};
+    GasContainer container = GasContainer(particles, specifications);
+    DisplacementTracker tracker(4, 1);
+
+    for (size_t frame = 0; frame < 10; frame++) {
+      tracker.Record(container);
+      container.AdvanceOneFrame();
+    }
+
+    REQUIRE(tracker.GetMeanSquaredDisplacement("test")
+            == vector<double>({1, 4, 16}));
+  }
+
+  SECTION("Diffusion coefficient uses the slope of the largest lags") {
+    vector<GasParticle> particles = {CreateParticle(400, 200, 1, 0, specs)};
+    GasContainer container = GasContainer(particles, specifications);
+    DisplacementTracker tracker(4, 1);
+
+    for (size_t frame = 0; frame < 10; frame++) {
+      tracker.Record(container);
+      container.AdvanceOneFrame();
+    }
+
+    // (16 - 4) / (4 * (4 - 2))
+    REQUIRE(tracker.GetDiffusionCoefficient("test") == 1.5);
+  }
+}
@@ -0,0 +1,100 @@
+#include <catch2/catch.hpp>
+#include <equilibrium_detector.h>
+#include "test_helper.h"
+
+#include <cmath>
+
+using idealgas::GasParticle;
+using idealgas::GasContainer;
+using idealgas::ParticleSpecs;
+using idealgas::EquilibriumDetector;
+
+using idealgas_test::CreateParticle;
+
+using std::map;
+using std::string;
+using std::vector;
+
+/**
+ * Places particles on a grid with speeds given by a function of their index.
+ * @param speed_at - finds the speed of a particle from its index in [0, count)
+ * @param count - the number of particles to place, at most 400
+ * @param specs - the specs of every particle
+ * @return a vector of non-overlapping particles
+ */
+template <typename SpeedFunction>
+static vector<GasParticle> PlaceParticles(SpeedFunction speed_at, size_t count,
+                                          const ParticleSpecs& specs) {
+  vector<GasParticle> particles;
+  for (size_t idx = 0; idx < count; idx++) {
+    float speed = speed_at(idx);
+    float heading = static_cast<float>(idx) * 2.39996f;
+
+    particles.push_back(CreateParticle(310 + 20 * (idx % 20),
+                                       60 + 20 * (idx / 20),
+                                       speed * std::cos(heading),
+                                       speed * std::sin(heading), specs));
+  }
+
+  return particles;
+}
+
+TEST_CASE("Testing Equilibrium Detection") {
+  ParticleSpecs specs = {1, 1, ci::Color8u(255, 255, 255), "test"};
+  map<string, ParticleSpecs> specifications = {{"test", specs}};
+  const size_t particle_count = 400;
+
+  SECTION("Maxwell-Boltzmann speeds are in equilibrium") {
+    // Inverts the 2D speed CDF at evenly spaced quantiles, with m = T = 1
+    vector<GasParticle> particles = PlaceParticles([&](size_t idx) {
+      float quantile = (idx + 0.5f) / particle_count;
+      return std::sqrt(-2 * std::log(1 - quantile));
+    }, particle_count, specs);
+    GasContainer container = GasContainer(particles, specifications);
+
+    EquilibriumDetector detector(1, 0.02, 1);
+    container.AdvanceOneFrame();
+    detector.Record(container);
+
+    REQUIRE((detector.IsEquilibrated()
+             && detector.GetLatestDivergence() < 0.02));
+  }
+
+  SECTION("Equal speeds are not in equilibrium") {
+    vector<GasParticle> particles = PlaceParticles([](size_t) {
+      return 1.0f;
+    }, particle_count, specs);
+    GasContainer container = GasContainer(particles, specifications);
+
+    EquilibriumDetector detector(1, 0.02, 1);
+    container.AdvanceOneFrame();
+    detector.Record(container);
+
+    REQUIRE_FALSE(detector.IsEquilibrated());
+  }
+
+  SECTION("Equilibrium needs enough windows in a row") {
+    vector<GasParticle> particles = PlaceParticles([&](size_t idx) {
+      float quantile = (idx + 0.5f) / particle_count;
+      return std::sqrt(-2 * std::log(1 - quantile));
+    }, particle_count, specs);
+    GasContainer container = GasContainer(particles, specifications);
+
+    EquilibriumDetector detector(2, 0.02, 2);
+    bool is_equilibrated_early = false;
+    for (size_t frame = 0; frame < 3; frame++) {
+      container.AdvanceOneFrame();
+      detector.Record(container);
+      is_equilibrated_early |= detector.IsEquilibrated();
+    }
+    container.AdvanceOneFrame();
+    detector.Record(container);
+
+    REQUIRE((!is_equilibrated_early && detector.IsEquilibrated()));
+  }
+
+  SECTION("Windows need frames before being evaluated") {
+    EquilibriumDetector detector(2, 0.02, 1);
+    REQUIRE(std::isinf(detector.GetLatestDivergence()));
+  }
+}
@@ -0,0 +1,187 @@
+#include <catch2/catch.hpp>
+#include <equilibrium_library.h>
+#include "test_helper.h"
+
+#include <cstdio>
+
+using idealgas::ContainerSpecifications;
+using idealgas::EquilibriumLibrary;
+using idealgas::GasContainer;
+using idealgas::GasParticle;
+using idealgas::ParticleSpecs;
+using idealgas::SaveStatus;
+
+using idealgas_test::CreateParticle;
+
+using std::map;
+using std::string;
+using std::vector;
+
+/**
+ * Finds the total kinetic energy of the particles in a container.
+ * @param container - the container of the particles
+ * @return the sum of the particles' kinetic energies
+ */
+static double FindKineticEnergy(const GasContainer& container) {
+  double kinetic_energy = 0;
+  for (const GasParticle& particle : container.GetParticles()) {
+    const glm::vec2& velocity = particle.GetVelocity();
+    kinetic_energy += 0.5 * particle.GetMass() * glm::dot(velocity, velocity);
+  }
+
+  return kinetic_energy;
+}
+
+TEST_CASE("Testing Scenario Hashing") {
+  ParticleSpecs heavy = {3, 20, ci::Color8u(51, 201, 128), "heavy"};
+  ParticleSpecs light = {1, 5, ci::Color8u(242, 212, 3), "light"};
+  map<string, ParticleSpecs> specifications = {{"heavy", heavy},
+                                               {"light", light}};
+
+  vector<ContainerSpecifications> counts = {{"heavy", 100, 2},
+                                            {"light", 300, 2}};
+  uint64_t hash = EquilibriumLibrary::HashScenario(specifications, counts);
+
+  SECTION("The order of the counts doesn't change the hash") {
+    vector<ContainerSpecifications> reordered = {{"light", 300, 2},
+                                                 {"heavy", 100, 2}};
+
+    REQUIRE(hash == EquilibriumLibrary::HashScenario(specifications,
+                                                     reordered));
+  }
+
+  SECTION("Splitting a count doesn't change the hash") {
+    vector<ContainerSpecifications> split = {{"light", 100, 2},
+                                             {"heavy", 100, 2},
+                                             {"light", 200, 2}};
+
+    REQUIRE(hash == EquilibriumLibrary::HashScenario(specifications, split));
+  }
+
+  SECTION("Colors and unused types don't change the hash") {
+    map<string, ParticleSpecs> recolored = specifications;
+    recolored["heavy"].color = ci::Color8u(0, 0, 0);
+    recolored["unused"] = {2, 10, ci::Color8u(255, 0, 0), "unused"};
+
+    REQUIRE(hash == EquilibriumLibrary::HashScenario(recolored, counts));
+  }
+
+  SECTION("Masses, counts, and velocities change the hash") {
+    map<string, ParticleSpecs> heavier = specifications;
+    heavier["heavy"].mass = 21;
+    vector<ContainerSpecifications> more = {{"heavy", 101, 2},
+                                            {"light", 300, 2}};
+    vector<ContainerSpecifications> faster = {{"heavy", 100, 3},
+                                              {"light", 300, 2}};
+
+    bool are_hashes_different =
+        hash != EquilibriumLibrary::HashScenario(heavier, counts)
+        && hash != EquilibriumLibrary::HashScenario(specifications, more)
+        && hash != EquilibriumLibrary::HashScenario(specifications, faster);
+
+    REQUIRE(are_hashes_different);
+  }
+
+  SECTION("Counts of unknown types throw") {
+    vector<ContainerSpecifications> unknown = {{"unknown", 1, 2}};
+
+    REQUIRE_THROWS_AS(EquilibriumLibrary::HashScenario(specifications, unknown),
+                      std::out_of_range);
+  }
+}
+
+TEST_CASE("Testing Equilibrated State Storage") {
+  ParticleSpecs heavy = {3, 20, ci::Color8u(51, 201, 128), "heavy"};
+  ParticleSpecs light = {1, 5, ci::Color8u(242, 212, 3), "light"};
+  map<string, ParticleSpecs> specifications = {{"heavy", heavy},
+                                               {"light", light}};
+
+  vector<GasParticle> particles;
+  for (size_t idx = 0; idx < 200; idx++) {
+    float offset = static_cast<float>(idx);
+    particles.push_back(CreateParticle(
+        310 + offset, 60 + offset, 0.01f * offset - 1, 1 - 0.02f * offset,
+        idx % 2 == 0 ? heavy : light));
+  }
+  GasContainer container = GasContainer(particles, specifications);
+
+  EquilibriumLibrary library(".", 0x1234abcd);
+
+  SECTION("A stored state loads back the same") {
+    std::remove(library.FindStatePath().c_str());
+    bool has_no_state = !library.HasState();
+    library.StoreState(container);
+    library.WaitForStores();
+    bool is_stored = library.GetStoreStatus() == SaveStatus::kSucceeded;
+
+    vector<GasParticle> loaded_particles = library.LoadState().GetParticles();
+    std::remove(library.FindStatePath().c_str());
+
+    bool is_loaded = has_no_state && is_stored
+                     && loaded_particles.size() == particles.size();
+    for (size_t idx = 0; is_loaded && idx < particles.size(); idx++) {
+      is_loaded &= loaded_particles[idx].GetPosition()
+                       == particles[idx].GetPosition()
+                   && loaded_particles[idx].GetVelocity()
+                       == particles[idx].GetVelocity();
+    }
+
+    REQUIRE(is_loaded);
+  }
+
+  SECTION("A state that can't be written is reported as failed") {
+    EquilibriumLibrary unwritable_library("missing_directory/library", 1);
+    unwritable_library.StoreState(container);
+    unwritable_library.WaitForStores();
+
+    REQUIRE(unwritable_library.GetStoreStatus() == SaveStatus::kFailed);
+  }
+
+  SECTION("Loading a missing state throws") {
+    std::remove(library.FindStatePath().c_str());
+
+    REQUIRE_THROWS_AS(library.LoadState(), std::invalid_argument);
+  }
+
+  SECTION("Randomized velocities keep positions and kinetic energy") {
+    GasContainer randomized =
+        EquilibriumLibrary::RandomizeVelocities(container, 7);
+    vector<GasParticle> randomized_particles = randomized.GetParticles();
+
+    double kinetic_energy = FindKineticEnergy(container);
+    bool is_energy_kept =
+        std::abs(FindKineticEnergy(randomized) - kinetic_energy)
+        < 1e-4 * kinetic_energy;
+
+    bool are_positions_kept = true;
+    bool are_velocities_changed = true;
+    for (size_t idx = 0; idx < particles.size(); idx++) {
+      are_positions_kept &= randomized_particles[idx].GetPosition()
+                            == particles[idx].GetPosition();
+      are_velocities_changed &= randomized_particles[idx].GetVelocity()
+                                != particles[idx].GetVelocity();
+    }
+
+    REQUIRE((is_energy_kept && are_positions_kept && are_velocities_changed));
+  }
+
+  SECTION("The same seed randomizes velocities the same way") {
+    vector<GasParticle> randomized_particles =
+        EquilibriumLibrary::RandomizeVelocities(container, 7).GetParticles();
+    vector<GasParticle> same_particles =
+        EquilibriumLibrary::RandomizeVelocities(container, 7).GetParticles();
+    vector<GasParticle> other_particles =
+        EquilibriumLibrary::RandomizeVelocities(container, 8).GetParticles();
+
+    bool is_reproducible = true;
+    bool is_seeded = false;
+    for (size_t idx = 0; idx < particles.size(); idx++) {
+      is_reproducible &= randomized_particles[idx].GetVelocity()
+                         == same_particles[idx].GetVelocity();
+      is_seeded |= randomized_particles[idx].GetVelocity()
+                   != other_particles[idx].GetVelocity();
+    }
+
+    REQUIRE((is_reproducible && is_seeded));
+  }
+}
@@ -0,0 +1,106 @@
+#include <catch2/catch.hpp>
+#include <field_grid.h>
+#include "test_helper.h"
+
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <limits>
+
+using idealgas::GasParticle;
+using idealgas::GasContainer;
+using idealgas::ParticleSpecs;
+using idealgas::FieldGrid;
+
+using idealgas_test::CreateParticle;
+using idealgas_test::kFloatEqualityThreshold;
+
+using glm::vec2;
+using std::map;
+using std::string;
+using std::vector;
+
+TEST_CASE("Testing Field Deposition") {
+  ParticleSpecs specs = {1, 1, ci::Color8u(255, 255, 255), "test"};
+  map<string, ParticleSpecs> specifications = {{"test", specs}};
+
+  // A 2x2 grid over the container has 200x200 cells
+  vector<GasParticle> particles = {CreateParticle(350, 100, 1, 0, specs),
+                                   CreateParticle(360, 100, -1, 0, specs),
+                                   CreateParticle(650, 400, 2, 0, specs)};
+  GasContainer container = GasContainer(particles, specifications);
+  const float cell_area = 200 * 200;
+
+  SECTION("Fields are found from the particles in each cell") {
+    FieldGrid grid(2, 2, 1, false, 3);
+    grid.Deposit(container);
+
+    const vector<float>& density = grid.GetDensity();
+    const vector<vec2>& velocity = grid.GetVelocity();
+    const vector<float>& temperature = grid.GetTemperature();
+
+    // Opposing velocities cancel into heat, while a lone particle has none
+    bool are_fields_accurate =
+        std::abs(density[0] - 2 / cell_area) < kFloatEqualityThreshold;
+    are_fields_accurate &= velocity[0] == vec2(0, 0);
+    are_fields_accurate &= temperature[0] == 0.5f;
+    are_fields_accurate &= density[1] == 0 && density[2] == 0;
+    are_fields_accurate &= velocity[3] == vec2(2, 0);
+    are_fields_accurate &= temperature[3] == 0;
+
+    REQUIRE(are_fields_accurate);
+  }
+
+  SECTION("Time averaging divides by the number of deposits") {
+    FieldGrid grid(2, 2, 1, true, 3);
+    grid.Deposit(container);
+    grid.Deposit(container);
+
+    bool is_averaged = grid.GetDepositCount() == 2;
+    is_averaged &= std::abs(grid.GetDensity()[3] - 1 / cell_area)
+                   < kFloatEqualityThreshold;
+
+    REQUIRE(is_averaged);
+  }
+
+  SECTION("Deposits are only made every deposit interval") {
+    FieldGrid grid(2, 2, 2, true, 3);
+    grid.Deposit(container);
+    grid.Deposit(container);
+
+    REQUIRE(grid.GetDepositCount() == 1);
+  }
+
+  SECTION("Particles without finite positions aren't deposited") {
+    particles.push_back(CreateParticle(std::nanf(""), 100, 1, 0, specs));
+    particles.push_back(CreateParticle(
+        350, std::numeric_limits<float>::infinity(), 1, 0, specs));
+    GasContainer broken_container = GasContainer(particles, specifications);
+
+    FieldGrid grid(2, 2, 1, false, 3);
+    grid.Deposit(broken_container);
+
+    float total_density = 0;
+    for (float cell_density : grid.GetDensity()) {
+      total_density += cell_density;
+    }
+
+    REQUIRE(std::abs(total_density - 3 / cell_area) < kFloatEqualityThreshold);
+  }
+
+  SECTION("Binary dumps hold the header and every field") {
+    FieldGrid grid(2, 2, 1, false, 3);
+    grid.Deposit(container);
+
+    string file_path = "test_field_grid_dump.bin";
+    grid.WriteFields(file_path);
+
+    std::ifstream input_file(file_path, std::ios::binary | std::ios::ate);
+    size_t file_size = static_cast<size_t>(input_file.tellg());
+    input_file.close();
+    std::remove(file_path.c_str());
+
+    // 40 header bytes, then 4 floats per cell
+    REQUIRE(file_size == 40 + 4 * 4 * sizeof(float));
+  }
+}
@@ -0,0 +1,66 @@
+#include <catch2/catch.hpp>
+#include "test_helper.h"
+
+using idealgas::GasParticle;
+using idealgas::GasContainer;
+using idealgas::ParticleSpecs;
+using idealgas::FrameObservables;
+
+using idealgas_test::CreateParticle;
+using idealgas_test::kFloatEqualityThreshold;
+
+using std::map;
+using std::string;
+using std::vector;
+
+TEST_CASE("Testing Frame Observables") {
+  ParticleSpecs specs = {1, 2, ci::Color8u(255, 255, 255), "test"};
+  map<string, ParticleSpecs> specifications = {{"test", specs}};
+
+  SECTION("Kinetic energy, momentum, and temperature of moving particles") {
+    vector<GasParticle> particles = {CreateParticle(400, 200, 1, 0, specs),
+                                     CreateParticle(500, 300, 0, -2, specs)};
+    GasContainer container = GasContainer(particles, specifications);
+    container.AdvanceOneFrame();
+
+    const FrameObservables& observables = container.GetObservables();
+
+    bool is_accurate = observables.frame == 1;
+    is_accurate &= std::abs(observables.kinetic_energy - 5)
+                   < kFloatEqualityThreshold;
+    is_accurate &= std::abs(observables.temperature - 2.5)
+                   < kFloatEqualityThreshold;
+    is_accurate &= observables.momentum == glm::vec2(2, -4);
+
+    REQUIRE(is_accurate);
+  }
+
+  SECTION("Wall bounce transfers impulse to only that wall") {
+    float wall_bound = GasContainer::kContainerLeftBound + 1;
+    vector<GasParticle> particles =
+        {CreateParticle(wall_bound, 200, -3, 0, specs)};
+    GasContainer container = GasContainer(particles, specifications);
+    container.AdvanceOneFrame();
+
+    const FrameObservables& observables = container.GetObservables();
+
+    bool is_accurate = observables.wall_impulses[idealgas::kLeftWall] == 12;
+    is_accurate &= observables.wall_impulses[idealgas::kRightWall] == 0;
+    is_accurate &= observables.wall_impulses[idealgas::kUpperWall] == 0;
+    is_accurate &= observables.wall_impulses[idealgas::kLowerWall] == 0;
+    is_accurate &= observables.pressure == 12.0f / 1600;
+
+    REQUIRE(is_accurate);
+  }
+
+  SECTION("Wall impulses are reset on the next frame") {
+    float wall_bound = GasContainer::kContainerLeftBound + 1;
+    vector<GasParticle> particles =
+        {CreateParticle(wall_bound, 200, -3, 0, specs)};
+    GasContainer container = GasContainer(particles, specifications);
+    container.AdvanceOneFrame();
+    container.AdvanceOneFrame();
+
+    REQUIRE(container.GetObservables().pressure == 0);
+  }
+}
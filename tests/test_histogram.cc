@@ -209,4 +209,82 @@ TEST_CASE("Testing Bin Updating for Unsorted Vectors") {
 
     REQUIRE(are_bins_accurate);
   }
-}
\ No newline at end of file
+}
+
+TEST_CASE("Testing Bins Offset By A Minimum Value") {
+  SECTION("Negative values are placed into bins starting at the minimum") {
+    Histogram hist = Histogram("data", 4, 1, 0, 0, ci::Color8u(), -2);
+
+    hist.UpdateBinDistribution({-2, -1.5, -0.5, 0, 0.5, 1.5, 2});
+    vector<size_t> bin_values = hist.GetBinValues();
+
+    REQUIRE(bin_values == vector<size_t>({2, 2, 1, 2}));
+  }
+
+  SECTION("Values outside the offset range are excluded") {
+    Histogram hist = Histogram("data", 4, 1, 0, 0, ci::Color8u(), -2);
+
+    hist.UpdateBinDistribution({-2.5, -2.01, 2.01, 3});
+    vector<size_t> bin_values = hist.GetBinValues();
+
+    REQUIRE(std::accumulate(bin_values.begin(), bin_values.end(), 0ul) == 0ul);
+  }
+}
+
+TEST_CASE("Testing Auto-Ranging Bins") {
+  SECTION("Values past the range merge adjacent bins and double the span") {
+    Histogram hist = Histogram("data", 4, 1, 0, 0, ci::Color8u());
+    hist.SetAutoRanging(true);
+
+    hist.ResetBins();
+    hist.AddValue(0.5);
+    hist.AddValue(1.5);
+    hist.AddValue(2.5);
+    hist.AddValue(7);
+
+    bool is_range_expanded = hist.GetSingleBinRange() == 2;
+    is_range_expanded &= hist.GetMinimumValue() == 0;
+    is_range_expanded &= hist.GetBinValues() == vector<size_t>({2, 1, 0, 1});
+
+    REQUIRE(is_range_expanded);
+  }
+
+  SECTION("Values below the range grow the range downwards") {
+    Histogram hist = Histogram("data", 4, 1, 0, 0, ci::Color8u());
+    hist.SetAutoRanging(true);
+
+    hist.ResetBins();
+    hist.AddValue(0.5);
+    hist.AddValue(3.5);
+    hist.AddValue(-1);
+
+    bool is_range_expanded = hist.GetSingleBinRange() == 2;
+    is_range_expanded &= hist.GetMinimumValue() == -4;
+    is_range_expanded &= hist.GetBinValues() == vector<size_t>({0, 1, 1, 1});
+
+    REQUIRE(is_range_expanded);
+  }
+
+  SECTION("Range shrinks back to fit the values after a reset") {
+    Histogram hist = Histogram("data", 4, 1, 0, 0, ci::Color8u());
+    hist.SetAutoRanging(true);
+
+    hist.UpdateBinDistribution({30});
+    hist.UpdateBinDistribution({0.5, 1.5});
+    hist.UpdateBinDistribution({0.5, 1.5});
+
+    bool is_range_shrunk = hist.GetSingleBinRange() == 1;
+    is_range_shrunk &= hist.GetBinValues() == vector<size_t>({1, 1, 0, 0});
+
+    REQUIRE(is_range_shrunk);
+  }
+
+  SECTION("Fixed range histograms still exclude out of range values") {
+    Histogram hist = Histogram("data", 4, 1, 0, 0, ci::Color8u());
+
+    hist.UpdateBinDistribution({7});
+    vector<size_t> bin_values = hist.GetBinValues();
+
+    REQUIRE(std::accumulate(bin_values.begin(), bin_values.end(), 0ul) == 0ul);
+  }
+}
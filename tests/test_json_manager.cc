@@ -0,0 +1,414 @@
+#include <catch2/catch.hpp>
+#include <container_sax_handler.h>
+#include <json_manager.h>
+#include "test_helper.h"
+
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+
+using idealgas::GasParticle;
+using idealgas::GasContainer;
+using idealgas::ContainerJsonWriter;
+using idealgas::ContainerSaxHandler;
+using idealgas::JsonLayout;
+using idealgas::JsonManager;
+using idealgas::ParticleSpecs;
+
+using idealgas_test::CreateParticle;
+
+using nlohmann::json;
+using std::map;
+using std::string;
+using std::vector;
+
+/**
+ * Writes a string to a file.
+ * @param file_path - the path of the file to write
+ * @param contents - what to write to the file
+ */
+static void WriteFile(const string& file_path, const string& contents) {
+  std::ofstream output_file(file_path);
+  output_file << contents;
+}
+
+/**
+ * Reads a whole file into a string.
+ * @param file_path - the path of the file to read
+ * @return a string of the file's contents
+ */
+static string ReadFile(const string& file_path) {
+  std::ifstream input_file(file_path);
+  std::stringstream contents;
+  contents << input_file.rdbuf();
+
+  return contents.str();
+}
+
+/**
+ * Checks whether 2 containers hold the same particles of the same types.
+ * @param container - the container to check
+ * @param expected_container - the container it should match
+ * @return a bool indicating whether the containers match
+ */
+static bool AreContainersEqual(const GasContainer& container,
+                               const GasContainer& expected_container) {
+  const vector<GasParticle>& particles = container.GetParticles();
+  const vector<GasParticle>& expected_particles =
+      expected_container.GetParticles();
+
+  bool are_equal = particles.size() == expected_particles.size()
+      && container.GetParticleTypeNames()
+         == expected_container.GetParticleTypeNames();
+
+  for (size_t idx = 0; are_equal && idx < particles.size(); idx++) {
+    are_equal &= particles[idx].GetPosition()
+                     == expected_particles[idx].GetPosition()
+                 && particles[idx].GetVelocity()
+                    == expected_particles[idx].GetVelocity()
+                 && particles[idx].GetTypeName()
+                    == expected_particles[idx].GetTypeName()
+                 && particles[idx].GetRadius()
+                    == expected_particles[idx].GetRadius()
+                 && particles[idx].GetMass()
+                    == expected_particles[idx].GetMass()
+                 && particles[idx].GetColor()
+                    == expected_particles[idx].GetColor();
+  }
+
+  return are_equal;
+}
+
+TEST_CASE("Testing Streaming Json Loading") {
+  string file_path = "test_json_manager.json";
+  JsonManager json_manager;
+
+  SECTION("Saved simulations load the same as through a json tree") {
+    ParticleSpecs heavy = {4, 2, ci::Color8u(255, 0, 0), "heavy"};
+    ParticleSpecs light = {2, 1, ci::Color8u(0, 128, 255), "light"};
+    vector<GasParticle> particles;
+    for (size_t idx = 0; idx < 50; idx++) {
+      particles.push_back(CreateParticle(310 + 7.3f * idx, 60 + 7.7f * idx,
+                                         0.1f * idx - 2, 1.5f - 0.03f * idx,
+                                         idx % 3 == 0 ? heavy : light));
+    }
+    GasContainer container =
+        GasContainer(particles, {{"heavy", heavy}, {"light", light}});
+    json_manager.WriteContainerToJson(container, file_path);
+
+    std::ifstream input_file(file_path);
+    GasContainer tree_container = json::parse(input_file).get<GasContainer>();
+    tree_container.Configure();
+
+    GasContainer loaded_container =
+        json_manager.LoadContainerFromJson(file_path);
+
+    REQUIRE(AreContainersEqual(loaded_container, tree_container));
+  }
+
+  SECTION("Keys can be in any order and unknown keys are skipped") {
+    WriteFile(file_path, R"({
+      "comment": {"nested": [1, {"position_": [5, 5]}], "flag": true},
+      "particle_specifications_": {
+        "argon": {"name": "argon", "mass": 3, "radius": 2.5, "extra": null,
+                  "color": {"blue": 30, "green": "not a number", "red": 10}}
+      },
+      "all_particles_": [
+        {"velocity_": [1.5, -2], "tag": [1, 2],
+         "position_": [400, 200, 7], "particle_type_name_": "argon"},
+        {"particle_type_name_": "argon", "position_": [350],
+         "velocity_": []}
+      ]
+    })");
+
+    GasContainer container = json_manager.LoadContainerFromJson(file_path);
+    const vector<GasParticle>& particles = container.GetParticles();
+
+    bool is_loaded = particles.size() == 2
+        && particles[0].GetPosition() == glm::vec2(400, 200)
+        && particles[0].GetVelocity() == glm::vec2(1.5, -2)
+        && particles[0].GetRadius() == 2.5f && particles[0].GetMass() == 3
+        && particles[0].GetColor() == ci::Color8u(10, 0, 30)
+        && particles[1].GetPosition() == glm::vec2(350, 0)
+        && particles[1].GetVelocity() == glm::vec2(0, 0);
+
+    REQUIRE(is_loaded);
+  }
+
+  SECTION("Particles missing a key throw") {
+    WriteFile(file_path, R"({
+      "particle_specifications_": {},
+      "all_particles_": [{"particle_type_name_": "argon", "position_": [1, 2]}]
+    })");
+
+    REQUIRE_THROWS_AS(json_manager.LoadContainerFromJson(file_path),
+                      std::invalid_argument);
+  }
+
+  SECTION("Files missing the particle types throw") {
+    WriteFile(file_path, R"({"all_particles_": []})");
+
+    REQUIRE_THROWS_AS(json_manager.LoadContainerFromJson(file_path),
+                      std::invalid_argument);
+  }
+
+  SECTION("Values of the wrong type throw") {
+    WriteFile(file_path, R"({
+      "particle_specifications_": {},
+      "all_particles_": [{"particle_type_name_": 5, "position_": [1, 2],
+                          "velocity_": [0, 0]}]
+    })");
+
+    REQUIRE_THROWS_AS(json_manager.LoadContainerFromJson(file_path),
+                      std::invalid_argument);
+  }
+
+  SECTION("Malformed json throws") {
+    WriteFile(file_path, R"({"all_particles_": [{"position_": [1, 2})");
+
+    REQUIRE_THROWS_AS(json_manager.LoadContainerFromJson(file_path),
+                      std::invalid_argument);
+  }
+
+  SECTION("Particles are counted across the blocks they are scanned in") {
+    string particle = R"({"particle_type_name_":"a"},)";
+    // Start a particle just before the end of the first block, so its key
+    // is split between 2 blocks
+    string saved_simulation(ContainerSaxHandler::kCountBlockSize - 5, ' ');
+    for (size_t idx = 0; idx < 3000; idx++) {
+      saved_simulation += particle;
+    }
+
+    std::istringstream input(saved_simulation);
+
+    REQUIRE(ContainerSaxHandler::CountParticles(input) == 3000);
+  }
+
+  std::remove(file_path.c_str());
+}
+
+TEST_CASE("Testing Streaming Json Writing") {
+  string file_path = "test_json_manager.json";
+  JsonManager json_manager;
+
+  // Values with short decimals, which the json tree prints the same as floats
+  ParticleSpecs heavy = {4, 2.5, ci::Color8u(255, 0, 7), "heavy"};
+  ParticleSpecs light = {2, 1, ci::Color8u(0, 128, 255), "light"};
+  vector<GasParticle> particles;
+  for (size_t idx = 0; idx < 20; idx++) {
+    particles.push_back(CreateParticle(310 + 0.5f * idx, 60 + 2.25f * idx,
+                                       0.125f * idx - 2, 1.5f,
+                                       idx % 3 == 0 ? heavy : light));
+  }
+  GasContainer container =
+      GasContainer(particles, {{"heavy", heavy}, {"light", light}});
+  json container_json = container;
+
+  SECTION("Indented json matches dumping the json tree") {
+    json_manager.WriteContainerToJson(container, file_path);
+
+    std::stringstream expected_json;
+    expected_json << std::setw(2) << container_json << std::endl;
+
+    REQUIRE(ReadFile(file_path) == expected_json.str());
+  }
+
+#ifdef __linux__
+  SECTION("Json that can't be fully written throws") {
+    // Every write to /dev/full fails as if the disk were full
+    REQUIRE_THROWS_AS(json_manager.WriteContainerToJson(container, "/dev/full"),
+                      std::invalid_argument);
+  }
+#endif
+
+  SECTION("Compact json matches dumping the json tree without whitespace") {
+    json_manager.WriteContainerToJson(container, file_path,
+                                      JsonLayout::kCompact);
+
+    REQUIRE(ReadFile(file_path) == container_json.dump() + "\n");
+  }
+
+  SECTION("Empty containers match dumping the json tree") {
+    std::stringstream written_json;
+    ContainerJsonWriter(JsonLayout::kIndented)
+        .Write(GasContainer({}, {}), written_json);
+
+    REQUIRE(written_json.str() == json(GasContainer({}, {})).dump(2) + "\n");
+  }
+
+  SECTION("Json formatted on many threads matches formatting it on 1") {
+    // Enough particles for several chunks per worker, with a partial chunk
+    size_t particle_count = 5 * ContainerJsonWriter::kChunkParticleCount + 7;
+    vector<GasParticle> many_particles;
+    for (size_t idx = 0; idx < particle_count; idx++) {
+      many_particles.push_back(CreateParticle(
+          300 + 0.37f * (idx % 1000), 50 + 0.011f * idx, 0.7f * (idx % 13),
+          -0.3f * (idx % 7), idx % 3 == 0 ? heavy : light));
+    }
+    GasContainer large_container =
+        GasContainer(many_particles, {{"heavy", heavy}, {"light", light}});
+
+    std::stringstream sequential_json;
+    ContainerJsonWriter(JsonLayout::kIndented, 1)
+        .Write(large_container, sequential_json);
+
+    bool is_identical = true;
+    for (size_t worker_count : {2, 3, 8}) {
+      std::stringstream parallel_json;
+      ContainerJsonWriter(JsonLayout::kIndented, worker_count)
+          .Write(large_container, parallel_json);
+      is_identical &= parallel_json.str() == sequential_json.str();
+    }
+
+    REQUIRE(is_identical);
+  }
+
+  SECTION("Saved floats load back exactly") {
+    ParticleSpecs argon = {2.7f, 0.3f, ci::Color8u(1, 2, 3), "argon"};
+    GasContainer float_container = GasContainer(
+        {CreateParticle(347.17706f, 123.456f, 0.1f, -1e-7f, argon),
+         CreateParticle(699.99994f, 50.000004f, 3.3333333f, 1e20f, argon)},
+        {{"argon", argon}});
+    json_manager.WriteContainerToJson(float_container, file_path,
+                                      JsonLayout::kCompact);
+
+    GasContainer loaded_container =
+        json_manager.LoadContainerFromJson(file_path);
+    float_container.Configure();
+
+    REQUIRE(AreContainersEqual(loaded_container, float_container));
+  }
+
+  SECTION("Names are escaped like the json library escapes them") {
+    ParticleSpecs quoted = {2, 1, ci::Color8u(), "say \"hi\"\\\n\t\x01"};
+    GasContainer quoted_container =
+        GasContainer({CreateParticle(400, 200, 1, 1, quoted)},
+                     {{quoted.name, quoted}});
+
+    std::stringstream written_json;
+    ContainerJsonWriter(JsonLayout::kCompact)
+        .Write(quoted_container, written_json);
+
+    REQUIRE(written_json.str() == json(quoted_container).dump() + "\n");
+  }
+
+  std::remove(file_path.c_str());
+}
+
+TEST_CASE("Testing Seeded Random Generation") {
+  string file_path = "test_json_manager.json";
+  JsonManager json_manager;
+
+  string particle_types = R"(
+    "particle_types": {
+      "argon": {"name": "argon", "mass": 3, "radius": 2,
+                "color": {"red": 10, "green": 20, "blue": 30}},
+      "neon": {"name": "neon", "mass": 1, "radius": 1,
+               "color": {"red": 40, "green": 50, "blue": 60}}
+    },
+    "particle_counts": [
+      {"particle_name": "argon", "count": 300, "max_velocity": 2},
+      {"particle_name": "neon", "count": 0, "max_velocity": 1},
+      {"particle_name": "neon", "count": 201, "max_velocity": 1}
+    ])";
+
+  SECTION("The same seed gives the same particles on any number of threads") {
+    WriteFile(file_path, "{\"seed\": 2021," + particle_types + "}");
+
+    GasContainer container =
+        json_manager.GenerateRandomContainerFromJson(file_path, 1);
+    bool is_reproducible = container.GetParticles().size() == 501
+        && container.GetParticles()[300].GetTypeName() == "neon";
+
+    for (size_t worker_count : {3, 8}) {
+      is_reproducible &= AreContainersEqual(
+          json_manager.GenerateRandomContainerFromJson(file_path,
+                                                       worker_count),
+          container);
+    }
+
+    REQUIRE(is_reproducible);
+  }
+
+  SECTION("Particles start inside the container within their max velocity") {
+    WriteFile(file_path, "{\"seed\": 7," + particle_types + "}");
+
+    GasContainer container =
+        json_manager.GenerateRandomContainerFromJson(file_path);
+
+    bool is_in_bounds = true;
+    for (const GasParticle& particle : container.GetParticles()) {
+      float max_velocity = particle.GetTypeName() == "argon" ? 2 : 1;
+      is_in_bounds &=
+          particle.GetPosition().x >= GasContainer::kContainerLeftBound
+          && particle.GetPosition().x <= GasContainer::kContainerRightBound
+          && particle.GetPosition().y >= GasContainer::kContainerUpperBound
+          && particle.GetPosition().y <= GasContainer::kContainerLowerBound
+          && std::abs(particle.GetVelocity().x) <= max_velocity
+          && std::abs(particle.GetVelocity().y) <= max_velocity;
+    }
+
+    REQUIRE(is_in_bounds);
+  }
+
+  SECTION("Different seeds give different particles") {
+    WriteFile(file_path, "{\"seed\": 1," + particle_types + "}");
+    GasContainer container =
+        json_manager.GenerateRandomContainerFromJson(file_path);
+    WriteFile(file_path, "{\"seed\": 2," + particle_types + "}");
+    GasContainer other_container =
+        json_manager.GenerateRandomContainerFromJson(file_path);
+
+    REQUIRE(!AreContainersEqual(container, other_container));
+  }
+
+  std::remove(file_path.c_str());
+}
+
+TEST_CASE("Testing Poisson-Disk Random Generation") {
+  string file_path = "test_json_manager.json";
+  JsonManager json_manager;
+
+  WriteFile(file_path, R"({
+    "seed": 9,
+    "placement": "poisson_disk",
+    "particle_types": {
+      "big": {"name": "big", "mass": 3, "radius": 8,
+              "color": {"red": 10, "green": 20, "blue": 30}},
+      "small": {"name": "small", "mass": 1, "radius": 3,
+                "color": {"red": 40, "green": 50, "blue": 60}}
+    },
+    "particle_counts": [
+      {"particle_name": "small", "count": 500, "max_velocity": 1},
+      {"particle_name": "big", "count": 200, "max_velocity": 2}
+    ]
+  })");
+
+  SECTION("No particles start overlapping") {
+    GasContainer container =
+        json_manager.GenerateRandomContainerFromJson(file_path);
+    const vector<GasParticle>& particles = container.GetParticles();
+
+    bool is_apart = particles.size() == 700;
+    for (size_t idx = 0; is_apart && idx < particles.size(); idx++) {
+      for (size_t other = idx + 1; other < particles.size(); other++) {
+        is_apart &= glm::distance(particles[idx].GetPosition(),
+                                  particles[other].GetPosition())
+                    >= particles[idx].GetRadius()
+                       + particles[other].GetRadius();
+      }
+    }
+
+    REQUIRE(is_apart);
+  }
+
+  SECTION("Placement is the same on any number of threads") {
+    REQUIRE(AreContainersEqual(
+        json_manager.GenerateRandomContainerFromJson(file_path, 1),
+        json_manager.GenerateRandomContainerFromJson(file_path, 4)));
+  }
+
+  std::remove(file_path.c_str());
+}
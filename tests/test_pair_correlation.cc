@@ -0,0 +1,141 @@
+#include <catch2/catch.hpp>
+#include <pair_correlation.h>
+#include "test_helper.h"
+
+#include <atomic>
+
+using idealgas::GasParticle;
+using idealgas::GasContainer;
+using idealgas::ParticleSpecs;
+using idealgas::CellList;
+using idealgas::PairCorrelationAccumulator;
+
+using idealgas_test::CreateParticle;
+
+using glm::vec2;
+using std::map;
+using std::string;
+using std::vector;
+
+TEST_CASE("Testing Parallel For Splits Work Between Workers") {
+  SECTION("Every item is visited exactly once") {
+    vector<std::atomic<int>> visits(103);
+    for (std::atomic<int>& visit : visits) {
+      visit = 0;
+    }
+
+    idealgas::ParallelFor(visits.size(), 4,
+                          [&](size_t begin, size_t end, size_t) {
+      for (size_t idx = begin; idx < end; idx++) {
+        visits[idx]++;
+      }
+    });
+
+    bool is_each_visited_once = true;
+    for (const std::atomic<int>& visit : visits) {
+      is_each_visited_once &= visit == 1;
+    }
+
+    REQUIRE(is_each_visited_once);
+  }
+
+  SECTION("Exceptions from workers reach the caller") {
+    REQUIRE_THROWS_AS(idealgas::ParallelFor(8, 4, [](size_t, size_t, size_t) {
+      throw std::runtime_error("failed");
+    }), std::runtime_error);
+  }
+}
+
+TEST_CASE("Testing Cell List Placement") {
+  ParticleSpecs specs = {1, 1, ci::Color8u(255, 255, 255), "test"};
+  CellList cell_list = CellList(vec2(0, 0), vec2(100, 100), 30);
+
+  SECTION("Cells are at least the minimum size") {
+    bool is_size_accurate = cell_list.GetColumnCount() == 3;
+    is_size_accurate &= cell_list.GetCellWidth() >= 30;
+
+    REQUIRE(is_size_accurate);
+  }
+
+  SECTION("Particles are grouped by cell, including those out of bounds") {
+    vector<GasParticle> particles = {CreateParticle(10, 10, 0, 0, specs),
+                                     CreateParticle(90, 90, 0, 0, specs),
+                                     CreateParticle(-5, 150, 0, 0, specs),
+                                     CreateParticle(20, 5, 0, 0, specs)};
+    cell_list.Build(particles);
+
+    vector<size_t> first_cell(cell_list.GetCellBegin(0, 0),
+                              cell_list.GetCellEnd(0, 0));
+    vector<size_t> last_cell(cell_list.GetCellBegin(2, 2),
+                             cell_list.GetCellEnd(2, 2));
+    vector<size_t> corner_cell(cell_list.GetCellBegin(0, 2),
+                               cell_list.GetCellEnd(0, 2));
+
+    bool is_placement_accurate = first_cell == vector<size_t>({0, 3});
+    is_placement_accurate &= last_cell == vector<size_t>({1});
+    is_placement_accurate &= corner_cell == vector<size_t>({2});
+
+    REQUIRE(is_placement_accurate);
+  }
+}
+
+TEST_CASE("Testing Pair Correlation Accumulation") {
+  ParticleSpecs light = {1, 1, ci::Color8u(255, 255, 255), "light"};
+  ParticleSpecs heavy = {1, 5, ci::Color8u(255, 0, 0), "heavy"};
+  map<string, ParticleSpecs> specifications = {{"light", light},
+                                               {"heavy", heavy}};
+  float area = 400 * 400;
+
+  SECTION("A single pair is counted in the bin of its separation") {
+    vector<GasParticle> particles = {CreateParticle(400, 200, 0, 0, light),
+                                     CreateParticle(401.5, 200, 0, 0, light)};
+    GasContainer container = GasContainer(particles, specifications);
+    PairCorrelationAccumulator pair_correlation(4, 4, 1, 2);
+
+    pair_correlation.Sample(container);
+    vector<float> g = pair_correlation.GetPairCorrelation("light", "light");
+
+    // 1 pair in the shell from 1 to 2, compared to 1 pair spread over the area
+    float expected = area / (M_PI * (4 - 1));
+
+    bool is_accurate = std::abs(g.at(1) - expected) < 0.01f;
+    is_accurate &= g.at(0) == 0 && g.at(2) == 0 && g.at(3) == 0;
+
+    REQUIRE(is_accurate);
+  }
+
+  SECTION("Pairs across cell borders and types are counted once") {
+    vector<GasParticle> particles = {CreateParticle(399.5, 199.5, 0, 0, light),
+                                     CreateParticle(400.5, 200.5, 0, 0, heavy),
+                                     CreateParticle(600, 400, 0, 0, light)};
+    GasContainer container = GasContainer(particles, specifications);
+    PairCorrelationAccumulator pair_correlation(2, 2, 1, 3);
+
+    pair_correlation.Sample(container);
+    vector<float> mixed = pair_correlation.GetPairCorrelation("light", "heavy");
+    vector<float> reversed =
+        pair_correlation.GetPairCorrelation("heavy", "light");
+    vector<float> same = pair_correlation.GetPairCorrelation("light", "light");
+
+    // 2 light and 1 heavy particle make 2 mixed pairs, only 1 of them close
+    float expected = area / (2 * M_PI * (4 - 1));
+
+    bool is_accurate = std::abs(mixed.at(1) - expected) < 0.01f;
+    is_accurate &= mixed == reversed;
+    is_accurate &= same == vector<float>({0, 0});
+
+    REQUIRE(is_accurate);
+  }
+
+  SECTION("Samples are only taken every sample interval") {
+    vector<GasParticle> particles = {CreateParticle(400, 200, 0, 0, light)};
+    GasContainer container = GasContainer(particles, specifications);
+    PairCorrelationAccumulator pair_correlation(4, 4, 3, 1);
+
+    for (size_t frame = 0; frame < 7; frame++) {
+      pair_correlation.Sample(container);
+    }
+
+    REQUIRE(pair_correlation.GetSampleCount() == 3);
+  }
+}
@@ -0,0 +1,71 @@
+#include <catch2/catch.hpp>
+#include <particle_quantity.h>
+
+using idealgas::GasParticle;
+using idealgas::ParticleSpecs;
+using idealgas::ParticleQuantity;
+using idealgas::MeasureParticleQuantity;
+using glm::vec2;
+
+TEST_CASE("Testing Particle Quantity Measurements") {
+  ParticleSpecs specs = {1, 4, ci::Color8u(255, 255, 255), "test"};
+  GasParticle particle = GasParticle(vec2(20, 20), vec2(3, -4), specs);
+
+  SECTION("Speed is the length of the velocity") {
+    REQUIRE(MeasureParticleQuantity(particle, ParticleQuantity::kSpeed) == 5);
+  }
+
+  SECTION("Kinetic energy uses the particle's mass") {
+    float energy =
+        MeasureParticleQuantity(particle, ParticleQuantity::kKineticEnergy);
+    REQUIRE(energy == 50);
+  }
+
+  SECTION("Velocity components are measured separately") {
+    bool are_components_accurate =
+        MeasureParticleQuantity(particle, ParticleQuantity::kVelocityX) == 3;
+    are_components_accurate &=
+        MeasureParticleQuantity(particle, ParticleQuantity::kVelocityY) == -4;
+
+    REQUIRE(are_components_accurate);
+  }
+
+  SECTION("Heading is the angle of the velocity") {
+    float heading =
+        MeasureParticleQuantity(particle, ParticleQuantity::kHeading);
+    REQUIRE(std::abs(heading - std::atan2(-4.0f, 3.0f)) < 0.00001f);
+  }
+}
+
+TEST_CASE("Testing Histogram Specifications From Json") {
+  SECTION("Quantities are read by name") {
+    nlohmann::json settings_json = {{"quantity", "velocity_x"},
+                                    {"bin_count", 8},
+                                    {"bin_range", 0.5},
+                                    {"min_value", -2},
+                                    {"display", false},
+                                    {"auto_range", true}};
+
+    auto settings = settings_json.get<idealgas::HistogramSpecifications>();
+
+    bool is_parsed = settings.quantity == ParticleQuantity::kVelocityX;
+    is_parsed &= settings.bin_count == 8;
+    is_parsed &= settings.min_value == -2;
+    is_parsed &= !settings.display;
+    is_parsed &= settings.auto_range;
+
+    REQUIRE(is_parsed);
+  }
+
+  SECTION("Unknown quantities throw") {
+    nlohmann::json settings_json = {{"quantity", "sped"},
+                                    {"bin_count", 8},
+                                    {"bin_range", 0.5},
+                                    {"min_value", -2},
+                                    {"display", false},
+                                    {"auto_range", true}};
+
+    REQUIRE_THROWS_AS(settings_json.get<idealgas::HistogramSpecifications>(),
+                      std::invalid_argument);
+  }
+}
@@ -0,0 +1,61 @@
+#include <catch2/catch.hpp>
+#include "test_helper.h"
+
+using idealgas::GasParticle;
+using idealgas::GasContainer;
+using idealgas::ParticleSpecs;
+using idealgas::ParticleView;
+
+using idealgas_test::CreateParticle;
+
+using std::map;
+using std::string;
+using std::vector;
+
+TEST_CASE("Testing Read-Only Particle Views") {
+  ParticleSpecs light = {1, 1, ci::Color8u(255, 255, 255), "light"};
+  ParticleSpecs heavy = {2, 5, ci::Color8u(255, 0, 0), "heavy"};
+  map<string, ParticleSpecs> specifications = {{"light", light},
+                                               {"heavy", heavy}};
+
+  vector<GasParticle> particles = {CreateParticle(400, 200, 1, 0, light),
+                                   CreateParticle(450, 200, 2, 0, heavy),
+                                   CreateParticle(500, 200, 3, 0, light)};
+  GasContainer container = GasContainer(particles, specifications);
+
+  SECTION("Full view does not copy the particles") {
+    const vector<GasParticle>& view = container.GetParticles();
+
+    bool is_same_storage = &view == &container.GetParticles();
+    is_same_storage &= view.size() == 3;
+
+    REQUIRE(is_same_storage);
+  }
+
+  SECTION("Type view only contains particles of that type, in order") {
+    ParticleView light_view = container.GetParticlesOfType("light");
+
+    vector<float> velocities;
+    for (const GasParticle& particle : light_view) {
+      velocities.push_back(particle.GetVelocity().x);
+    }
+
+    REQUIRE(velocities == vector<float>({1, 3}));
+  }
+
+  SECTION("Type view indices refer to the container's particles") {
+    ParticleView heavy_view = container.GetParticlesOfType("heavy");
+
+    bool is_index_accurate = heavy_view.size() == 1;
+    is_index_accurate &= heavy_view.GetIndices().at(0) == 1;
+    is_index_accurate &= &heavy_view[0] == &container.GetParticles()[1];
+
+    REQUIRE(is_index_accurate);
+  }
+
+  SECTION("Type view of a missing type is empty") {
+    ParticleView missing_view = container.GetParticlesOfType("missing");
+
+    REQUIRE(missing_view.empty());
+  }
+}
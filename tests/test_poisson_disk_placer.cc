@@ -0,0 +1,113 @@
+#include <catch2/catch.hpp>
+#include <poisson_disk_placer.h>
+#include "test_helper.h"
+
+using glm::vec2;
+using idealgas::PlacementMode;
+using idealgas::PoissonDiskPlacer;
+
+using std::vector;
+
+/**
+ * Checks that every particle is inside a rectangle and that no 2 overlap.
+ * @param positions - the position of each particle
+ * @param radii - the radius of each particle
+ * @param upper_left - the corner of the rectangle with the smallest values
+ * @param lower_right - the corner of the rectangle with the largest values
+ * @return a bool indicating whether the particles are all apart and inside
+ */
+static bool AreParticlesApart(const vector<vec2>& positions,
+                              const vector<float>& radii,
+                              const vec2& upper_left, const vec2& lower_right) {
+  bool are_apart = positions.size() == radii.size();
+
+  for (size_t idx = 0; are_apart && idx < positions.size(); idx++) {
+    are_apart &= positions[idx].x - radii[idx] >= upper_left.x
+                 && positions[idx].x + radii[idx] <= lower_right.x
+                 && positions[idx].y - radii[idx] >= upper_left.y
+                 && positions[idx].y + radii[idx] <= lower_right.y;
+
+    for (size_t other = idx + 1; are_apart && other < positions.size();
+         other++) {
+      are_apart &= glm::distance(positions[idx], positions[other])
+                   >= radii[idx] + radii[other];
+    }
+  }
+
+  return are_apart;
+}
+
+TEST_CASE("Testing Poisson-Disk Placement") {
+  vec2 upper_left(300, 50);
+  vec2 lower_right(700, 450);
+
+  SECTION("Particles of different sizes are placed without overlapping") {
+    vector<float> radii;
+    for (size_t idx = 0; idx < 700; idx++) {
+      radii.push_back(idx % 3 == 0 ? 7 : (idx % 3 == 1 ? 5 : 3));
+    }
+
+    vector<vec2> positions =
+        PoissonDiskPlacer(upper_left, lower_right, 11).Place(radii);
+
+    REQUIRE(AreParticlesApart(positions, radii, upper_left, lower_right));
+  }
+
+  SECTION("Dense mixtures of sizes are placed without overlapping") {
+    // A lattice spaced by the large particles has too few sites for these
+    vector<float> radii(4, 60);
+    radii.resize(450, 5);
+
+    PoissonDiskPlacer placer(upper_left, lower_right, 11);
+    vector<vec2> positions = placer.Place(radii);
+
+    bool is_dense = placer.FindPackingFraction(radii) > 0.5f;
+
+    REQUIRE((is_dense
+             && AreParticlesApart(positions, radii, upper_left, lower_right)));
+  }
+
+  SECTION("The same seed places particles the same way") {
+    vector<float> radii(300, 4);
+
+    vector<vec2> positions =
+        PoissonDiskPlacer(upper_left, lower_right, 5).Place(radii);
+    vector<vec2> same_positions =
+        PoissonDiskPlacer(upper_left, lower_right, 5).Place(radii);
+
+    REQUIRE(positions == same_positions);
+  }
+
+  SECTION("Nearly jammed particles are placed on a lattice") {
+    vector<float> radii(1500, 5);
+
+    PoissonDiskPlacer placer(upper_left, lower_right, 3);
+    vector<vec2> positions = placer.Place(radii);
+
+    bool is_jammed = placer.FindPackingFraction(radii) > 0.7f;
+
+    REQUIRE((is_jammed
+             && AreParticlesApart(positions, radii, upper_left, lower_right)));
+  }
+
+  SECTION("Particles that can't fit throw") {
+    vector<float> radii(2000, 5);
+    PoissonDiskPlacer placer(upper_left, lower_right, 3);
+
+    REQUIRE_THROWS_AS(placer.Place(radii), std::invalid_argument);
+  }
+}
+
+TEST_CASE("Testing Placement Modes From Json") {
+  SECTION("Placement modes are read by name") {
+    nlohmann::json mode_json = "poisson_disk";
+
+    REQUIRE(mode_json.get<PlacementMode>() == PlacementMode::kPoissonDisk);
+  }
+
+  SECTION("Unknown placement modes throw") {
+    nlohmann::json mode_json = "poisson";
+
+    REQUIRE_THROWS_AS(mode_json.get<PlacementMode>(), std::invalid_argument);
+  }
+}
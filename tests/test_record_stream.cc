@@ -0,0 +1,167 @@
+#include <catch2/catch.hpp>
+#include <record_stream.h>
+#include "test_helper.h"
+
+#include <chrono>
+#include <mutex>
+#include <thread>
+
+using idealgas::GasParticle;
+using idealgas::GasContainer;
+using idealgas::ParticleSpecs;
+using idealgas::SpscRingBuffer;
+using idealgas::AsyncRecordStream;
+using idealgas::OverflowPolicy;
+using idealgas::CollisionEvent;
+using idealgas::CollisionEventKind;
+using idealgas::CollisionEventStream;
+
+using idealgas_test::CreateParticle;
+
+using std::map;
+using std::string;
+using std::vector;
+
+TEST_CASE("Testing Ring Buffer") {
+  SECTION("Capacity is rounded up to a power of two") {
+    SpscRingBuffer<int> buffer(5);
+    REQUIRE(buffer.GetCapacity() == 8);
+  }
+
+  SECTION("Pushing into a full buffer fails") {
+    SpscRingBuffer<int> buffer(2);
+    bool is_pushed = buffer.TryPush(1);
+    is_pushed &= buffer.TryPush(2);
+
+    REQUIRE((is_pushed && !buffer.TryPush(3)));
+  }
+
+  SECTION("Popping returns items in the order they were pushed") {
+    SpscRingBuffer<int> buffer(4);
+    int popped[4] = {0, 0, 0, 0};
+
+    // Wrap around the end of the slots before popping
+    for (int value = 0; value < 3; value++) {
+      buffer.TryPush(value);
+    }
+    buffer.PopBatch(popped, 2);
+    for (int value = 3; value < 6; value++) {
+      buffer.TryPush(value);
+    }
+
+    size_t count = buffer.PopBatch(popped, 4);
+
+    bool is_in_order = count == 4;
+    for (int idx = 0; idx < 4; idx++) {
+      is_in_order &= popped[idx] == idx + 2;
+    }
+
+    REQUIRE((is_in_order && buffer.IsEmpty()));
+  }
+}
+
+TEST_CASE("Testing Async Record Stream") {
+  std::mutex received_mutex;
+  vector<int> received;
+  AsyncRecordStream<int>::Sink sink = [&](const int* records, size_t count) {
+    std::lock_guard<std::mutex> lock(received_mutex);
+    received.insert(received.end(), records, records + count);
+  };
+
+  SECTION("Closing delivers every record published while blocking") {
+    AsyncRecordStream<int> stream(4, OverflowPolicy::kBlock, sink);
+    for (int value = 0; value < 1000; value++) {
+      stream.Publish(value);
+    }
+    stream.Close();
+
+    bool is_delivered = received.size() == 1000;
+    for (size_t idx = 0; idx < received.size(); idx++) {
+      is_delivered &= received[idx] == static_cast<int>(idx);
+    }
+    is_delivered &= stream.GetDroppedCount() == 0;
+
+    REQUIRE(is_delivered);
+  }
+
+  SECTION("Dropped records are counted") {
+    AsyncRecordStream<int> stream(4, OverflowPolicy::kDropAndCount, sink);
+    for (int value = 0; value < 1000; value++) {
+      stream.Publish(value);
+    }
+    stream.Close();
+    stream.Publish(1000);
+
+    bool is_counted = stream.GetPublishedCount() == 1001;
+    is_counted &= received.size() + stream.GetDroppedCount() == 1001;
+
+    REQUIRE(is_counted);
+  }
+
+  SECTION("Records published while closing are delivered or counted") {
+    AsyncRecordStream<int> stream(4, OverflowPolicy::kBlock, sink);
+    std::thread publisher([&stream]() {
+      for (int value = 0; value < 100000; value++) {
+        stream.Publish(value);
+      }
+    });
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    stream.Close();
+    publisher.join();
+
+    REQUIRE(received.size() + stream.GetDroppedCount() == 100000);
+  }
+}
+
+TEST_CASE("Testing Container Collision Event Publishing") {
+  ParticleSpecs specs = {1, 1, ci::Color8u(255, 255, 255), "test"};
+  map<string, ParticleSpecs> specifications = {{"test", specs}};
+
+  vector<CollisionEvent> events;
+  CollisionEventStream::Sink sink = [&](const CollisionEvent* records,
+                                        size_t count) {
+    events.insert(events.end(), records, records + count);
+  };
+
+  SECTION("Particle collisions publish the momentum transferred") {
+    vector<GasParticle> particles = {CreateParticle(400, 200, 1, 0, specs),
+                                     CreateParticle(405, 200, -1, 0, specs)};
+    GasContainer container = GasContainer(particles, specifications);
+
+    CollisionEventStream stream(16, OverflowPolicy::kBlock, sink);
+    container.SetCollisionEventStream(&stream);
+    for (size_t frame = 0; frame < 3; frame++) {
+      container.AdvanceOneFrame();
+    }
+    container.SetCollisionEventStream(nullptr);
+    stream.Close();
+
+    bool is_published = events.size() == 1;
+    is_published &= events[0].kind == CollisionEventKind::kParticleCollision;
+    is_published &= events[0].frame == 2;
+    is_published &= events[0].particle_id == 0 && events[0].other_id == 1;
+    is_published &= events[0].impulse == 2;
+    is_published &= events[0].x_position == 402.5f;
+
+    REQUIRE(is_published);
+  }
+
+  SECTION("Wall collisions publish which wall was hit") {
+    vector<GasParticle> particles = {CreateParticle(301, 200, -1, 0, specs)};
+    GasContainer container = GasContainer(particles, specifications);
+
+    CollisionEventStream stream(16, OverflowPolicy::kBlock, sink);
+    container.SetCollisionEventStream(&stream);
+    container.AdvanceOneFrame();
+    container.SetCollisionEventStream(nullptr);
+    stream.Close();
+
+    bool is_published = events.size() == 1;
+    is_published &= events[0].kind == CollisionEventKind::kWallCollision;
+    is_published &= events[0].other_id == idealgas::kLeftWall;
+    is_published &= events[0].impulse == 2;
+
+    REQUIRE(is_published);
+  }
+}
@@ -0,0 +1,79 @@
+#include <catch2/catch.hpp>
+#include <save_worker.h>
+
+#include <atomic>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+
+using idealgas::SaveWorker;
+using idealgas::SaveStatus;
+
+using std::string;
+
+/**
+ * Reads a whole file into a string.
+ * @param file_path - the path of the file to read
+ * @return the contents of the file, or an empty string if it doesn't exist
+ */
+static string ReadFile(const string& file_path) {
+  std::ifstream input_file(file_path);
+  return string(std::istreambuf_iterator<char>(input_file),
+                std::istreambuf_iterator<char>());
+}
+
+TEST_CASE("Testing Background Saving") {
+  string file_path = "test_save_worker.txt";
+  std::remove(file_path.c_str());
+
+  SaveWorker worker;
+  std::atomic<int> completed_count(0);
+  std::atomic<bool> was_last_save_successful(false);
+
+  SaveWorker::CompletionCallback on_complete = [&](bool is_saved) {
+    was_last_save_successful = is_saved;
+    completed_count++;
+  };
+
+  SECTION("Nothing has been saved before the first save") {
+    REQUIRE(worker.GetStatus() == SaveStatus::kIdle);
+  }
+
+  SECTION("Saves are written and moved into place") {
+    worker.Enqueue(file_path, [](const string& path) {
+      std::ofstream output_file(path);
+      output_file << "saved";
+    }, on_complete);
+    worker.WaitUntilIdle();
+
+    bool is_saved = ReadFile(file_path) == "saved";
+    is_saved &= ReadFile(file_path + SaveWorker::kTemporaryFileSuffix).empty();
+    is_saved &= completed_count == 1 && was_last_save_successful;
+    is_saved &= worker.GetStatus() == SaveStatus::kSucceeded;
+
+    REQUIRE(is_saved);
+  }
+
+  SECTION("Failed saves leave the previous save untouched") {
+    worker.Enqueue(file_path, [](const string& path) {
+      std::ofstream output_file(path);
+      output_file << "first";
+    }, on_complete);
+    worker.Enqueue(file_path, [](const string& path) {
+      std::ofstream output_file(path);
+      output_file << "partial";
+      throw std::invalid_argument("The save failed.");
+    }, on_complete);
+    worker.WaitUntilIdle();
+
+    bool is_untouched = ReadFile(file_path) == "first";
+    is_untouched &= completed_count == 2 && !was_last_save_successful;
+    is_untouched &= worker.GetStatus() == SaveStatus::kFailed;
+
+    REQUIRE(is_untouched);
+  }
+
+  std::remove(file_path.c_str());
+}
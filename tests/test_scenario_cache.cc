@@ -0,0 +1,113 @@
+#include <catch2/catch.hpp>
+#include <scenario_cache.h>
+#include "test_helper.h"
+
+#include <json_manager.h>
+
+#include <cstdio>
+#include <fstream>
+
+using idealgas::GasParticle;
+using idealgas::GasContainer;
+using idealgas::JsonManager;
+using idealgas::ParticleSpecs;
+using idealgas::ScenarioCache;
+
+using idealgas_test::CreateParticle;
+
+using std::map;
+using std::string;
+using std::vector;
+
+TEST_CASE("Testing Parsed Scenario Caches") {
+  ParticleSpecs heavy = {3, 20, ci::Color8u(51, 201, 128), "heavy"};
+  ParticleSpecs light = {1, 5, ci::Color8u(242, 212, 3), "light"};
+  map<string, ParticleSpecs> specifications = {{"heavy", heavy},
+                                               {"light", light}};
+
+  vector<GasParticle> particles = {CreateParticle(400, 200, 1.5f, -2, heavy),
+                                   CreateParticle(450, 300, -0.25f, 0, light),
+                                   CreateParticle(600, 100, 0, 3, light)};
+  GasContainer container = GasContainer(particles, specifications);
+
+  JsonManager json_manager;
+  string file_path = "test_scenario_cache.json";
+  string cache_path = ScenarioCache::FindCachePath(file_path);
+  std::remove(cache_path.c_str());
+  json_manager.WriteContainerToJson(container, file_path);
+
+  // Counts how many times the source file is parsed
+  size_t parse_count = 0;
+  ScenarioCache::ParseFunction parse = [&](const string& path) {
+    parse_count++;
+    return json_manager.LoadContainerFromJson(path);
+  };
+
+  ScenarioCache scenario_cache;
+  scenario_cache.LoadContainer(file_path, parse);
+
+  SECTION("Later loads come from the cache and match the source") {
+    GasContainer loaded = scenario_cache.LoadContainer(file_path, parse);
+    const vector<GasParticle>& loaded_particles = loaded.GetParticles();
+
+    bool is_restored = parse_count == 1
+        && loaded_particles.size() == particles.size();
+    for (size_t idx = 0; idx < particles.size() && is_restored; idx++) {
+      const GasParticle& loaded_particle = loaded_particles[idx];
+      is_restored &= loaded_particle.GetPosition()
+                     == particles[idx].GetPosition();
+      is_restored &= loaded_particle.GetVelocity()
+                     == particles[idx].GetVelocity();
+      is_restored &= loaded_particle.GetTypeName()
+                     == particles[idx].GetTypeName();
+      is_restored &= loaded_particle.GetMass() == particles[idx].GetMass();
+      is_restored &= loaded_particle.GetColor() == particles[idx].GetColor();
+    }
+
+    REQUIRE(is_restored);
+  }
+
+  SECTION("Rewriting the source with the same contents keeps the cache") {
+    json_manager.WriteContainerToJson(container, file_path);
+    scenario_cache.LoadContainer(file_path, parse);
+
+    REQUIRE(parse_count == 1);
+  }
+
+  SECTION("Changing the source rebuilds the cache") {
+    // The same size as before, and most likely within the same second
+    vector<GasParticle> moved_particles = particles;
+    moved_particles[0] = CreateParticle(500, 200, 1.5f, -2, heavy);
+    json_manager.WriteContainerToJson(
+        GasContainer(moved_particles, specifications), file_path);
+
+    GasContainer loaded = scenario_cache.LoadContainer(file_path, parse);
+    GasContainer reloaded = scenario_cache.LoadContainer(file_path, parse);
+
+    bool is_rebuilt = parse_count == 2
+        && loaded.GetParticles()[0].GetPosition() == glm::vec2(500, 200)
+        && reloaded.GetParticles()[0].GetPosition() == glm::vec2(500, 200);
+
+    REQUIRE(is_rebuilt);
+  }
+
+  SECTION("Corrupt caches are rebuilt") {
+    std::ofstream cache_file(cache_path, std::ios::binary | std::ios::trunc);
+    cache_file << "not a cache";
+    cache_file.close();
+
+    scenario_cache.LoadContainer(file_path, parse);
+    GasContainer reloaded = scenario_cache.LoadContainer(file_path, parse);
+
+    REQUIRE((parse_count == 2
+             && reloaded.GetParticles().size() == particles.size()));
+  }
+
+  SECTION("Hashes match 64-bit FNV-1a") {
+    REQUIRE((ScenarioCache::HashBytes("", 0) == 0xcbf29ce484222325ULL
+             && ScenarioCache::HashBytes("a", 1) == 0xaf63dc4c8601ec8cULL));
+  }
+
+  std::remove(file_path.c_str());
+  std::remove(cache_path.c_str());
+}
@@ -0,0 +1,55 @@
+#include <catch2/catch.hpp>
+#include <simulation_engine.h>
+#include "test_helper.h"
+
+#include <cstdio>
+#include <fstream>
+
+using idealgas::HistogramSpecifications;
+using idealgas::ParticleQuantity;
+using idealgas::SimulationEngine;
+
+using std::string;
+using std::vector;
+
+TEST_CASE("Testing Histogram Settings Loading") {
+  string file_path = "test_simulation_engine_histograms.json";
+
+  SECTION("A missing settings file shows only speeds") {
+    std::remove(file_path.c_str());
+    vector<HistogramSpecifications> settings =
+        SimulationEngine::HistogramInitializer(file_path);
+
+    REQUIRE((settings.size() == 1
+             && settings[0].quantity == ParticleQuantity::kSpeed));
+  }
+
+  SECTION("Settings are loaded from the file") {
+    std::ofstream(file_path) << R"({"histograms": [{
+        "quantity": "heading", "bin_count": 8, "bin_range": 1,
+        "min_value": -4, "display": true, "auto_range": false}]})";
+    vector<HistogramSpecifications> settings =
+        SimulationEngine::HistogramInitializer(file_path);
+
+    REQUIRE((settings.size() == 1
+             && settings[0].quantity == ParticleQuantity::kHeading));
+  }
+
+  SECTION("Unknown quantities throw instead of falling back") {
+    std::ofstream(file_path) << R"({"histograms": [{
+        "quantity": "sped", "bin_count": 8, "bin_range": 1,
+        "min_value": 0, "display": true, "auto_range": false}]})";
+
+    REQUIRE_THROWS_AS(SimulationEngine::HistogramInitializer(file_path),
+                      std::invalid_argument);
+  }
+
+  SECTION("Malformed settings throw instead of falling back") {
+    std::ofstream(file_path) << R"({"histograms": [)";
+
+    REQUIRE_THROWS_AS(SimulationEngine::HistogramInitializer(file_path),
+                      nlohmann::json::exception);
+  }
+
+  std::remove(file_path.c_str());
+}
@@ -0,0 +1,219 @@
+#include <catch2/catch.hpp>
+#include <simulation_runner.h>
+#include "test_helper.h"
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+using glm::vec2;
+using idealgas::SimulationFrame;
+using idealgas::SimulationRunner;
+
+using idealgas_test::AreResultsAccurate;
+
+using std::vector;
+
+typedef SimulationFrame::Clock Clock;
+
+/**
+ * A simulation that only counts its steps, and records whether anything ran on
+ * it while a step was in progress.
+ */
+class CountingSimulation {
+ public:
+  std::atomic<size_t> step_count;
+  std::atomic<bool> is_stepping;
+  // set if a command ran on the simulation while it was stepping
+  std::atomic<bool> was_interrupted;
+  // the ids of the commands, in the order they ran
+  vector<int> command_order;
+
+  CountingSimulation()
+      : step_count(0), is_stepping(false), was_interrupted(false) {}
+
+  void AdvanceToNextFrame() {
+    is_stepping = true;
+    std::this_thread::sleep_for(std::chrono::microseconds(100));
+    step_count++;
+    is_stepping = false;
+  }
+
+  void CaptureFrame(SimulationFrame& frame) const {
+    frame.positions.assign(1, vec2(static_cast<float>(step_count), 0));
+    frame.radii.assign(1, 1);
+    frame.colors.assign(1, ci::Color8u(255, 255, 255));
+  }
+
+  void RunCommand(int command_id) {
+    if (is_stepping) {
+      was_interrupted = true;
+    }
+    command_order.push_back(command_id);
+  }
+};
+
+typedef SimulationRunner<CountingSimulation> CountingRunner;
+
+TEST_CASE("Testing Simulation Runner Commands") {
+  CountingSimulation simulation;
+
+  SECTION("Commands run in order between steps") {
+    CountingRunner runner(simulation, CountingRunner::kUnlimitedStepRate);
+
+    vector<std::future<void>> results;
+    for (int command_id = 0; command_id < 50; command_id++) {
+      results.push_back(runner.Post([command_id](CountingSimulation& counted) {
+        counted.RunCommand(command_id);
+      }));
+    }
+    for (std::future<void>& result : results) {
+      result.wait();
+    }
+
+    bool is_in_order = simulation.command_order.size() == 50;
+    for (size_t idx = 0; is_in_order && idx < 50; idx++) {
+      is_in_order &= simulation.command_order[idx] == static_cast<int>(idx);
+    }
+
+    REQUIRE((is_in_order && !simulation.was_interrupted));
+  }
+
+  SECTION("Exceptions thrown by commands reach their futures") {
+    CountingRunner runner(simulation, CountingRunner::kUnlimitedStepRate);
+    std::future<void> result = runner.Post([](CountingSimulation&) {
+      throw std::invalid_argument("The command failed.");
+    });
+
+    REQUIRE_THROWS_AS(result.get(), std::invalid_argument);
+  }
+
+  SECTION("Stopping the runner runs every posted command first") {
+    {
+      CountingRunner runner(simulation, CountingRunner::kUnlimitedStepRate);
+      runner.Pause();
+      for (int command_id = 0; command_id < 20; command_id++) {
+        runner.Post([command_id](CountingSimulation& counted) {
+          counted.RunCommand(command_id);
+        });
+      }
+    }
+
+    REQUIRE(simulation.command_order.size() == 20);
+  }
+}
+
+TEST_CASE("Testing Simulation Runner Pacing") {
+  CountingSimulation simulation;
+
+  SECTION("A paused runner doesn't step until resumed") {
+    CountingRunner runner(simulation, CountingRunner::kUnlimitedStepRate);
+    runner.Pause();
+    // Once a command has run, the step in progress has finished
+    runner.Post([](CountingSimulation&) {}).wait();
+
+    size_t paused_step_count = simulation.step_count;
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    bool is_paused = runner.IsPaused()
+                     && simulation.step_count == paused_step_count;
+
+    runner.Resume();
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+
+    REQUIRE((is_paused && simulation.step_count > paused_step_count));
+  }
+
+  SECTION("Steps run at the target rate") {
+    Clock::time_point start_time = Clock::now();
+    CountingRunner runner(simulation, 100);
+    std::this_thread::sleep_for(std::chrono::milliseconds(300));
+    size_t step_count = runner.GetStepCount();
+    double elapsed_seconds =
+        std::chrono::duration<double>(Clock::now() - start_time).count();
+
+    // A slow machine may fall behind, but never gets ahead of the rate
+    bool is_paced = step_count >= 10
+                    && step_count <= 100 * elapsed_seconds + 1;
+
+    REQUIRE(is_paced);
+  }
+
+  SECTION("An unlimited rate steps faster than a limited one") {
+    CountingRunner runner(simulation, 100);
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    size_t limited_step_count = runner.GetStepCount();
+
+    runner.SetTargetStepRate(CountingRunner::kUnlimitedStepRate);
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    size_t unlimited_step_count = runner.GetStepCount() - limited_step_count;
+
+    REQUIRE(unlimited_step_count > 2 * limited_step_count);
+  }
+
+  SECTION("Negative rates throw") {
+    CountingRunner runner(simulation, 100);
+
+    REQUIRE_THROWS_AS(runner.SetTargetStepRate(-1), std::invalid_argument);
+  }
+}
+
+TEST_CASE("Testing Step Interpolation Fractions") {
+  Clock::time_point previous_time = Clock::now();
+  Clock::time_point latest_time = previous_time + std::chrono::milliseconds(10);
+
+  SECTION("The fraction is how far into the next step the clock is") {
+    float fraction = idealgas::FindInterpolationFraction(
+        previous_time, latest_time,
+        latest_time + std::chrono::milliseconds(4));
+
+    REQUIRE(std::abs(fraction - 0.4f) < idealgas_test::kFloatEqualityThreshold);
+  }
+
+  SECTION("The fraction stays between 0 and 1") {
+    bool is_clamped =
+        idealgas::FindInterpolationFraction(
+            previous_time, latest_time,
+            latest_time + std::chrono::milliseconds(25)) == 1
+        && idealgas::FindInterpolationFraction(
+               previous_time, latest_time,
+               latest_time - std::chrono::milliseconds(5)) == 0;
+
+    REQUIRE(is_clamped);
+  }
+
+  SECTION("Frames captured at the same time show the latest frame") {
+    REQUIRE(idealgas::FindInterpolationFraction(
+                latest_time, latest_time, latest_time) == 1);
+  }
+}
+
+TEST_CASE("Testing Position Interpolation") {
+  vector<vec2> previous_positions = {vec2(400, 200), vec2(500, 300)};
+  vector<vec2> latest_positions = {vec2(410, 190), vec2(500, 320)};
+  vector<vec2> positions;
+
+  SECTION("Positions are interpolated linearly") {
+    idealgas::InterpolatePositions(previous_positions, latest_positions,
+                                   0.25f, positions);
+
+    vec2 position_one_accuracy = glm::abs(positions[0] - vec2(402.5f, 197.5f));
+    vec2 position_two_accuracy = glm::abs(positions[1] - vec2(500, 305));
+
+    REQUIRE(AreResultsAccurate(position_one_accuracy, position_two_accuracy));
+  }
+
+  SECTION("Frames with different particle counts aren't interpolated") {
+    previous_positions.pop_back();
+    idealgas::InterpolatePositions(previous_positions, latest_positions, 0.5f,
+                                   positions);
+
+    REQUIRE(positions == latest_positions);
+  }
+
+  SECTION("A fraction of 1 gives the latest positions") {
+    idealgas::InterpolatePositions(previous_positions, latest_positions, 1,
+                                   positions);
+
+    REQUIRE(positions == latest_positions);
+  }
+}
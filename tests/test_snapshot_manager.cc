@@ -0,0 +1,105 @@
+#include <catch2/catch.hpp>
+#include <snapshot_manager.h>
+#include "test_helper.h"
+
+#include <cstdio>
+#include <fstream>
+
+using idealgas::GasParticle;
+using idealgas::GasContainer;
+using idealgas::ParticleSpecs;
+using idealgas::SnapshotManager;
+
+using idealgas_test::CreateParticle;
+
+using std::map;
+using std::string;
+using std::vector;
+
+TEST_CASE("Testing Binary Snapshots") {
+  ParticleSpecs heavy = {3, 20, ci::Color8u(51, 201, 128), "heavy"};
+  ParticleSpecs light = {1, 5, ci::Color8u(242, 212, 3), "light"};
+  map<string, ParticleSpecs> specifications = {{"heavy", heavy},
+                                               {"light", light}};
+
+  vector<GasParticle> particles = {CreateParticle(400, 200, 1.5f, -2, heavy),
+                                   CreateParticle(450, 300, -0.25f, 0, light),
+                                   CreateParticle(600, 100, 0, 3, light)};
+  GasContainer container = GasContainer(particles, specifications);
+
+  SnapshotManager snapshot_manager;
+  string file_path = "test_snapshot.snapshot";
+  snapshot_manager.WriteContainerToSnapshot(container, file_path);
+
+  SECTION("Loading a snapshot restores every particle and type") {
+    GasContainer loaded = snapshot_manager.LoadContainerFromSnapshot(file_path);
+    const vector<GasParticle>& loaded_particles = loaded.GetParticles();
+
+    bool is_restored = loaded_particles.size() == particles.size();
+    for (size_t idx = 0; idx < particles.size() && is_restored; idx++) {
+      const GasParticle& loaded_particle = loaded_particles[idx];
+      is_restored &= loaded_particle.GetPosition()
+                     == particles[idx].GetPosition();
+      is_restored &= loaded_particle.GetVelocity()
+                     == particles[idx].GetVelocity();
+      is_restored &= loaded_particle.GetTypeName()
+                     == particles[idx].GetTypeName();
+      is_restored &= loaded_particle.GetMass() == particles[idx].GetMass();
+      is_restored &= loaded_particle.GetRadius() == particles[idx].GetRadius();
+    }
+
+    const ParticleSpecs& loaded_light =
+        loaded.GetParticleSpecifications().at("light");
+    is_restored &= loaded_light.color == light.color;
+    is_restored &= loaded_light.name == "light";
+
+    REQUIRE(is_restored);
+  }
+
+  SECTION("Columns start on aligned offsets") {
+    SnapshotManager::SnapshotHeader header;
+    std::ifstream input_file(file_path, std::ios::binary);
+    input_file.read(reinterpret_cast<char*>(&header), sizeof(header));
+
+    bool is_aligned = header.positions_offset % 64 == 0;
+    is_aligned &= header.velocities_offset % 64 == 0;
+    is_aligned &= header.species_ids_offset % 64 == 0;
+    is_aligned &= header.particle_count == 3 && header.species_count == 2;
+
+    REQUIRE(is_aligned);
+  }
+
+  SECTION("Truncated snapshots are rejected") {
+    std::ifstream input_file(file_path, std::ios::binary);
+    vector<char> bytes(100);
+    input_file.read(bytes.data(), bytes.size());
+    input_file.close();
+
+    std::ofstream output_file(file_path, std::ios::binary | std::ios::trunc);
+    output_file.write(bytes.data(), bytes.size());
+    output_file.close();
+
+    REQUIRE_THROWS_AS(snapshot_manager.LoadContainerFromSnapshot(file_path),
+                      std::invalid_argument);
+  }
+
+#ifdef __linux__
+  SECTION("Snapshots that can't be fully written throw") {
+    // Every write to /dev/full fails as if the disk were full
+    REQUIRE_THROWS_AS(
+        snapshot_manager.WriteContainerToSnapshot(container, "/dev/full"),
+        std::invalid_argument);
+  }
+#endif
+
+  SECTION("Files that are not snapshots are rejected") {
+    std::ofstream output_file(file_path, std::ios::binary | std::ios::trunc);
+    output_file << "{\"all_particles_\": []}";
+    output_file.close();
+
+    REQUIRE_THROWS_AS(snapshot_manager.LoadContainerFromSnapshot(file_path),
+                      std::invalid_argument);
+  }
+
+  std::remove(file_path.c_str());
+}
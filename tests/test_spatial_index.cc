@@ -0,0 +1,127 @@
+#include <catch2/catch.hpp>
+#include <spatial_index.h>
+#include "test_helper.h"
+
+#include <algorithm>
+
+using idealgas::GasParticle;
+using idealgas::GasContainer;
+using idealgas::ParticleSpecs;
+using idealgas::SpatialIndex;
+
+using idealgas_test::CreateParticle;
+
+using glm::vec2;
+using std::map;
+using std::string;
+using std::vector;
+
+/**
+ * Scatters particles over the container with a fixed pseudo-random sequence.
+ * @param count - the number of particles to create
+ * @param specs - the specs of every particle
+ * @return a vector of particles inside the container
+ */
+static vector<GasParticle> ScatterParticles(size_t count,
+                                            const ParticleSpecs& specs) {
+  vector<GasParticle> particles;
+  unsigned int state = 12345;
+
+  for (size_t idx = 0; idx < count; idx++) {
+    state = state * 1103515245 + 12345;
+    float x_position = 305 + (state >> 16) % 390;
+    state = state * 1103515245 + 12345;
+    float y_position = 55 + (state >> 16) % 390;
+
+    particles.push_back(CreateParticle(x_position, y_position, 1, -1, specs));
+  }
+
+  return particles;
+}
+
+TEST_CASE("Testing Spatial Index Queries") {
+  ParticleSpecs specs = {1, 1, ci::Color8u(255, 255, 255), "test"};
+  map<string, ParticleSpecs> specifications = {{"test", specs}};
+
+  vector<GasParticle> particles = ScatterParticles(300, specs);
+  GasContainer container = GasContainer(particles, specifications);
+  const SpatialIndex& index = container.GetSpatialIndex();
+
+  SECTION("Radius queries find the same particles as a linear scan") {
+    vec2 center(420, 180);
+    float radius = 60;
+
+    vector<size_t> found = index.FindParticlesWithinRadius(center, radius);
+    vector<size_t> expected;
+    for (size_t idx = 0; idx < particles.size(); idx++) {
+      if (glm::distance(particles[idx].GetPosition(), center) <= radius) {
+        expected.push_back(idx);
+      }
+    }
+
+    std::sort(found.begin(), found.end());
+    REQUIRE((!expected.empty() && found == expected));
+  }
+
+  SECTION("Box queries find the same particles as a linear scan") {
+    vec2 lower_corner(500, 300);
+    vec2 upper_corner(690, 440);
+
+    vector<size_t> found = index.FindParticlesInBox(lower_corner,
+                                                    upper_corner);
+    vector<size_t> expected;
+    for (size_t idx = 0; idx < particles.size(); idx++) {
+      const vec2& position = particles[idx].GetPosition();
+      if (position.x >= lower_corner.x && position.x <= upper_corner.x
+          && position.y >= lower_corner.y && position.y <= upper_corner.y) {
+        expected.push_back(idx);
+      }
+    }
+
+    std::sort(found.begin(), found.end());
+    REQUIRE((!expected.empty() && found == expected));
+  }
+
+  SECTION("Nearest neighbours are the closest particles, nearest first") {
+    size_t particle_idx = 17;
+    vec2 center = particles[particle_idx].GetPosition();
+
+    vector<size_t> neighbors = index.FindNearestNeighbors(particle_idx, 6);
+
+    vector<float> distances;
+    for (size_t idx = 0; idx < particles.size(); idx++) {
+      if (idx != particle_idx) {
+        distances.push_back(glm::distance(particles[idx].GetPosition(),
+                                          center));
+      }
+    }
+    std::sort(distances.begin(), distances.end());
+
+    bool are_nearest = neighbors.size() == 6;
+    for (size_t rank = 0; rank < neighbors.size(); rank++) {
+      are_nearest &= glm::distance(particles[neighbors[rank]].GetPosition(),
+                                   center) == distances[rank];
+    }
+
+    REQUIRE(are_nearest);
+  }
+
+  SECTION("Asking for more neighbours than exist returns every other one") {
+    vector<GasParticle> few_particles = ScatterParticles(4, specs);
+    GasContainer small_container(few_particles, specifications);
+
+    REQUIRE(small_container.GetSpatialIndex().FindNearestNeighbors(0, 10)
+                .size() == 3);
+  }
+
+  SECTION("Advancing a frame rebuilds the index from the new positions") {
+    container.AdvanceOneFrame();
+    const vector<GasParticle>& moved_particles = container.GetParticles();
+    vec2 position = moved_particles[0].GetPosition();
+
+    vector<size_t> found = container.GetSpatialIndex()
+        .FindParticlesWithinRadius(position, 0);
+
+    REQUIRE(std::find(found.begin(), found.end(), 0) != found.end());
+  }
+}
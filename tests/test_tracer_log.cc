@@ -0,0 +1,129 @@
+#include <catch2/catch.hpp>
+#include <tracer_log.h>
+#include "test_helper.h"
+
+#include <cstdio>
+#include <fstream>
+
+using idealgas::GasParticle;
+using idealgas::GasContainer;
+using idealgas::ParticleSpecs;
+using idealgas::TracerSelector;
+using idealgas::TracerRecord;
+using idealgas::TracerLogger;
+using idealgas::SelectTracers;
+
+using idealgas_test::CreateParticle;
+
+using nlohmann::json;
+using std::map;
+using std::string;
+using std::vector;
+
+TEST_CASE("Testing Tracer Selection") {
+  ParticleSpecs heavy = {2, 1, ci::Color8u(255, 255, 255), "heavy"};
+  ParticleSpecs light = {1, 1, ci::Color8u(255, 255, 255), "light"};
+  map<string, ParticleSpecs> specifications = {{"heavy", heavy},
+                                               {"light", light}};
+
+  vector<GasParticle> particles;
+  for (size_t idx = 0; idx < 20; idx++) {
+    particles.push_back(CreateParticle(310 + 15 * idx, 200, 1, 0,
+                                       idx % 2 == 0 ? heavy : light));
+  }
+  GasContainer container = GasContainer(particles, specifications);
+
+  SECTION("Missing json keys select every particle") {
+    TracerSelector selector = json::parse("{\"particle_name\": \"light\"}")
+                                  .get<TracerSelector>();
+
+    vector<size_t> tracer_ids = SelectTracers(container, {selector});
+
+    bool is_every_light_particle = tracer_ids.size() == 10;
+    for (size_t tracer_id : tracer_ids) {
+      is_every_light_particle &= tracer_id % 2 == 1;
+    }
+
+    REQUIRE(is_every_light_particle);
+  }
+
+  SECTION("Id ranges and types are combined") {
+    TracerSelector selector;
+    selector.particle_name = "heavy";
+    selector.first_id = 4;
+    selector.end_id = 10;
+
+    REQUIRE(SelectTracers(container, {selector}) == vector<size_t>({4, 6, 8}));
+  }
+
+  SECTION("Random samples are repeatable and only pick matching particles") {
+    TracerSelector selector;
+    selector.particle_name = "heavy";
+    selector.sample_count = 4;
+    selector.seed = 7;
+
+    vector<size_t> tracer_ids = SelectTracers(container, {selector});
+
+    bool is_sampled = tracer_ids.size() == 4;
+    for (size_t tracer_id : tracer_ids) {
+      is_sampled &= tracer_id % 2 == 0;
+    }
+    is_sampled &= tracer_ids == SelectTracers(container, {selector});
+
+    REQUIRE(is_sampled);
+  }
+
+  SECTION("Overlapping selectors pick each particle once") {
+    TracerSelector first_half;
+    first_half.end_id = 10;
+    TracerSelector middle;
+    middle.first_id = 5;
+    middle.end_id = 15;
+
+    REQUIRE(SelectTracers(container, {first_half, middle}).size() == 15);
+  }
+
+  SECTION("Unknown types can't be selected") {
+    TracerSelector selector;
+    selector.particle_name = "unknown";
+
+    REQUIRE_THROWS_AS(SelectTracers(container, {selector}),
+                      std::invalid_argument);
+  }
+}
+
+TEST_CASE("Testing Tracer Logging") {
+  ParticleSpecs specs = {1, 1, ci::Color8u(255, 255, 255), "test"};
+  map<string, ParticleSpecs> specifications = {{"test", specs}};
+
+  vector<GasParticle> particles = {CreateParticle(400, 200, 1, 0, specs),
+                                   CreateParticle(500, 200, 0, 2, specs),
+                                   CreateParticle(600, 200, -1, 0, specs)};
+  GasContainer container = GasContainer(particles, specifications);
+
+  SECTION("Only the tracers are logged each frame") {
+    string file_path = "test_tracer_log.bin";
+    TracerLogger logger({1}, file_path);
+
+    for (size_t frame = 0; frame < 3; frame++) {
+      logger.Record(container);
+      container.AdvanceOneFrame();
+    }
+    logger.Close();
+
+    vector<TracerRecord> records(4);
+    std::ifstream input_file(file_path, std::ios::binary);
+    input_file.read(reinterpret_cast<char*>(records.data()),
+                    records.size() * sizeof(TracerRecord));
+    size_t record_count = input_file.gcount() / sizeof(TracerRecord);
+    input_file.close();
+    std::remove(file_path.c_str());
+
+    bool is_logged = record_count == 3;
+    is_logged &= records[2].frame == 2 && records[2].particle_id == 1;
+    is_logged &= records[2].x_position == 500 && records[2].y_position == 204;
+    is_logged &= records[2].y_velocity == 2;
+
+    REQUIRE(is_logged);
+  }
+}
@@ -0,0 +1,200 @@
+#include <catch2/catch.hpp>
+#include <trajectory_reader.h>
+#include <replay_engine.h>
+#include <trajectory_writer.h>
+#include "test_helper.h"
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+
+using idealgas::GasParticle;
+using idealgas::GasContainer;
+using idealgas::ParticleSpecs;
+using idealgas::TrajectoryFooter;
+using idealgas::TrajectoryWriter;
+using idealgas::TrajectoryReader;
+using idealgas::ReplayEngine;
+
+using idealgas_test::CreateParticle;
+
+using glm::vec2;
+using std::map;
+using std::string;
+using std::vector;
+
+/**
+ * Checks that every decoded position is within half the precision of the
+ * position that was recorded.
+ * @param positions - the positions read from the trajectory
+ * @param expected_positions - the positions that were recorded
+ * @param precision - the precision of the trajectory
+ * @return a bool indicating whether every position matches
+ */
+static bool ArePositionsWithinPrecision(
+    const vector<vec2>& positions, const vector<vec2>& expected_positions,
+    double precision) {
+  bool is_within_precision = positions.size() == expected_positions.size();
+
+  for (size_t idx = 0; is_within_precision && idx < positions.size(); idx++) {
+    vec2 error = positions[idx] - expected_positions[idx];
+    is_within_precision &= std::abs(error.x) <= precision / 2 + 0.0001
+                           && std::abs(error.y) <= precision / 2 + 0.0001;
+  }
+
+  return is_within_precision;
+}
+
+TEST_CASE("Testing Trajectory Reading") {
+  string file_path = "test_trajectory_reader.trajectory";
+  double precision = 0.01;
+  ParticleSpecs heavy = {4, 2, ci::Color8u(255, 0, 0), "heavy"};
+  ParticleSpecs light = {2, 1, ci::Color8u(0, 0, 255), "light"};
+  map<string, ParticleSpecs> specifications = {{"heavy", heavy},
+                                               {"light", light}};
+
+  // Particles in neighbouring columns head towards each other and collide
+  vector<GasParticle> particles;
+  for (size_t idx = 0; idx < 30; idx++) {
+    float x_velocity = idx % 2 == 0 ? 1.5f : -1.5f;
+    particles.push_back(CreateParticle(310 + 12 * idx, 200 + (idx % 5) * 40,
+                                       x_velocity, 0.7f,
+                                       idx % 3 == 0 ? heavy : light));
+  }
+  GasContainer container = GasContainer(particles, specifications);
+
+  vector<vector<vec2>> expected_frames;
+  {
+    TrajectoryWriter writer(file_path, container, precision, 10);
+    for (size_t frame = 0; frame < 35; frame++) {
+      vector<vec2> positions;
+      for (const GasParticle& particle : container.GetParticles()) {
+        positions.push_back(particle.GetPosition());
+      }
+      expected_frames.push_back(positions);
+
+      writer.Record(container);
+      container.AdvanceOneFrame();
+    }
+  }
+
+  SECTION("The particle types are read back") {
+    TrajectoryReader reader(file_path);
+
+    bool is_table_read = reader.GetFrameCount() == 35
+                         && reader.GetParticleCount() == 30
+                         && reader.GetKeyframeInterval() == 10
+                         && reader.GetParticleSpecs().size() == 2;
+    for (size_t idx = 0; is_table_read && idx < particles.size(); idx++) {
+      const ParticleSpecs& specs =
+          reader.GetParticleSpecs()[reader.GetParticleTypeIds()[idx]];
+      is_table_read &= specs.name == particles[idx].GetTypeName()
+                       && specs.color == (idx % 3 == 0 ? heavy : light).color;
+    }
+
+    REQUIRE(is_table_read);
+  }
+
+  SECTION("Frames can be read in any order") {
+    TrajectoryReader reader(file_path);
+    vector<vec2> positions;
+
+    bool is_every_frame_read = true;
+    for (size_t frame : {34, 5, 6, 29, 0, 10, 9, 33, 34}) {
+      reader.ReadFrame(frame, positions);
+      is_every_frame_read &= ArePositionsWithinPrecision(
+          positions, expected_frames[frame], precision);
+    }
+
+    REQUIRE(is_every_frame_read);
+  }
+
+  SECTION("Frames past the end throw") {
+    TrajectoryReader reader(file_path);
+    vector<vec2> positions;
+
+    REQUIRE_THROWS_AS(reader.ReadFrame(35, positions), std::invalid_argument);
+  }
+
+  SECTION("Files cut short are read up to their last whole frame") {
+    std::ifstream input_file(file_path, std::ios::binary);
+    string data = string(std::istreambuf_iterator<char>(input_file),
+                         std::istreambuf_iterator<char>());
+    TrajectoryFooter footer;
+    std::memcpy(&footer, data.data() + data.size() - sizeof(footer),
+                sizeof(footer));
+
+    // Drop the index and part of the last frame, as a crash would
+    string truncated_path = "test_trajectory_reader_truncated.trajectory";
+    {
+      std::ofstream output_file(truncated_path, std::ios::binary);
+      output_file.write(data.data(), footer.keyframe_index_offset - 3);
+    }
+
+    TrajectoryReader reader(truncated_path);
+    vector<vec2> positions;
+
+    bool is_readable = reader.GetFrameCount() == 34;
+    reader.ReadFrame(33, positions);
+    is_readable &= ArePositionsWithinPrecision(positions, expected_frames[33],
+                                               precision);
+    reader.ReadFrame(20, positions);
+    is_readable &= ArePositionsWithinPrecision(positions, expected_frames[20],
+                                               precision);
+
+    std::remove(truncated_path.c_str());
+    REQUIRE(is_readable);
+  }
+
+  SECTION("Files that are not trajectories throw") {
+    string text_path = "test_trajectory_reader.txt";
+    {
+      std::ofstream output_file(text_path);
+      output_file << "This file is long enough to hold a trajectory header.";
+    }
+
+    REQUIRE_THROWS_AS(TrajectoryReader(text_path), std::invalid_argument);
+    std::remove(text_path.c_str());
+  }
+
+  SECTION("Replays play forwards, backwards, and at any speed") {
+    ReplayEngine replay(file_path);
+    replay.SetSpeed(2.5);
+    replay.Play();
+
+    replay.AdvanceToNextFrame();
+    replay.AdvanceToNextFrame();
+    bool is_played = replay.GetCurrentFrame() == 5
+                     && ArePositionsWithinPrecision(replay.GetPositions(),
+                                                    expected_frames[5],
+                                                    precision);
+
+    replay.Reverse();
+    replay.AdvanceToNextFrame();
+    is_played &= replay.GetCurrentFrame() == 2;
+
+    // Playback stops at the start rather than wrapping around
+    replay.AdvanceToNextFrame();
+    is_played &= replay.GetCurrentFrame() == 0 && !replay.IsPlaying();
+
+    REQUIRE(is_played);
+  }
+
+  SECTION("Replays seek to any frame") {
+    ReplayEngine replay(file_path);
+    replay.Seek(27);
+
+    bool is_seeked = replay.GetCurrentFrame() == 27
+                     && ArePositionsWithinPrecision(replay.GetPositions(),
+                                                    expected_frames[27],
+                                                    precision);
+
+    replay.Seek(1000);
+    is_seeked &= replay.GetCurrentFrame() == 34;
+
+    REQUIRE(is_seeked);
+  }
+
+  std::remove(file_path.c_str());
+}
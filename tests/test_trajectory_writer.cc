@@ -0,0 +1,174 @@
+#include <catch2/catch.hpp>
+#include <trajectory_writer.h>
+#include <trajectory_reader.h>
+#include "test_helper.h"
+
+#include <cstdio>
+#include <fstream>
+#include <limits>
+
+using idealgas::GasParticle;
+using idealgas::GasContainer;
+using idealgas::ParticleSpecs;
+using idealgas::TrajectoryWriter;
+using idealgas::TrajectoryReader;
+using idealgas::EncodeTrajectoryValues;
+using idealgas::DecodeTrajectoryValues;
+
+using idealgas_test::CreateParticle;
+
+using glm::vec2;
+using std::map;
+using std::string;
+using std::vector;
+
+TEST_CASE("Testing Trajectory Value Packing") {
+  SECTION("Every kind of value survives packing") {
+    vector<int32_t> values = {0, 1, -1, 0, 0, 0, 0, 2, -2, 1, 31, -32, 100,
+                              -1000, std::numeric_limits<int32_t>::max(),
+                              std::numeric_limits<int32_t>::min(), 5, 0};
+    values.insert(values.end(), 150, 0);
+    values.push_back(-7);
+
+    vector<uint8_t> packed;
+    EncodeTrajectoryValues(values, packed);
+
+    vector<int32_t> unpacked(values.size());
+    DecodeTrajectoryValues(packed.data(), packed.size(), unpacked);
+
+    REQUIRE(unpacked == values);
+  }
+
+  SECTION("Small residuals are packed 3 to a byte") {
+    vector<int32_t> values;
+    for (size_t idx = 0; idx < 300; idx++) {
+      values.push_back(static_cast<int32_t>(idx % 3) - 1);
+    }
+
+    vector<uint8_t> packed;
+    EncodeTrajectoryValues(values, packed);
+
+    REQUIRE(packed.size() == 100);
+  }
+
+  SECTION("Unpacking into the wrong number of values throws") {
+    vector<int32_t> values = {1, 2, 3, 4};
+    vector<uint8_t> packed;
+    EncodeTrajectoryValues(values, packed);
+
+    vector<int32_t> too_few(3);
+    vector<int32_t> too_many(5);
+
+    REQUIRE_THROWS_AS(DecodeTrajectoryValues(packed.data(), packed.size(),
+                                             too_few), std::invalid_argument);
+    REQUIRE_THROWS_AS(DecodeTrajectoryValues(packed.data(), packed.size(),
+                                             too_many), std::invalid_argument);
+  }
+}
+
+TEST_CASE("Testing Trajectory Recording") {
+  string file_path = "test_trajectory_writer.trajectory";
+  ParticleSpecs specs = {1, 1, ci::Color8u(255, 255, 255), "argon"};
+  map<string, ParticleSpecs> specifications = {{"argon", specs}};
+
+  // Every particle moves the same way, so none of them ever collide
+  vector<GasParticle> particles;
+  for (size_t row = 0; row < 20; row++) {
+    for (size_t column = 0; column < 20; column++) {
+      particles.push_back(CreateParticle(350 + 15 * column, 100 + 15 * row,
+                                         0.1234f, -0.0567f, specs));
+    }
+  }
+  GasContainer container = GasContainer(particles, specifications);
+
+  SECTION("Recorded positions are read back to within the precision") {
+    double precision = 0.01;
+    vector<vector<vec2>> expected_frames;
+    {
+      TrajectoryWriter writer(file_path, container, precision, 10);
+      for (size_t frame = 0; frame < 25; frame++) {
+        vector<vec2> positions;
+        for (const GasParticle& particle : container.GetParticles()) {
+          positions.push_back(particle.GetPosition());
+        }
+        expected_frames.push_back(positions);
+
+        writer.Record(container);
+        container.AdvanceOneFrame();
+      }
+    }
+
+    TrajectoryReader reader(file_path);
+    vector<vec2> positions;
+
+    bool is_within_precision =
+        reader.GetFrameCount() == expected_frames.size();
+    for (size_t frame = 0; is_within_precision && frame < 25; frame++) {
+      reader.ReadFrame(frame, positions);
+
+      for (size_t idx = 0; idx < particles.size(); idx++) {
+        vec2 error = positions[idx] - expected_frames[frame][idx];
+        is_within_precision &= std::abs(error.x) <= precision / 2 + 0.0001
+                               && std::abs(error.y) <= precision / 2 + 0.0001;
+      }
+    }
+
+    REQUIRE(is_within_precision);
+  }
+
+  SECTION("Ballistic particles compress over 10 times smaller than floats") {
+    size_t frame_count = 200;
+    {
+      TrajectoryWriter writer(file_path, container, 0.01, 100);
+      for (size_t frame = 0; frame < frame_count; frame++) {
+        writer.Record(container);
+        container.AdvanceOneFrame();
+      }
+
+      writer.Close();
+      REQUIRE(writer.GetFrameCount() == frame_count);
+    }
+
+    std::ifstream input_file(file_path, std::ios::binary | std::ios::ate);
+    size_t file_size = static_cast<size_t>(input_file.tellg());
+    size_t raw_size = frame_count * particles.size() * sizeof(vec2);
+
+    REQUIRE(file_size * 10 < raw_size);
+  }
+
+  SECTION("Recording a different number of particles throws") {
+    TrajectoryWriter writer(file_path, container, 0.01, 10);
+    GasContainer smaller_container = GasContainer(
+        {CreateParticle(400, 200, 1, 0, specs)}, specifications);
+
+    REQUIRE_THROWS_AS(writer.Record(smaller_container), std::invalid_argument);
+  }
+
+  SECTION("Invalid settings throw") {
+    REQUIRE_THROWS_AS(TrajectoryWriter(file_path, container, 0, 10),
+                      std::invalid_argument);
+    REQUIRE_THROWS_AS(TrajectoryWriter(file_path, container, 0.01, 0),
+                      std::invalid_argument);
+  }
+
+  SECTION("Precisions too fine for 32 bit positions throw") {
+    // A coordinate near 700 would be 7e9 quanta, beyond 32 bits
+    REQUIRE_THROWS_AS(TrajectoryWriter(file_path, container, 1e-7, 10),
+                      std::invalid_argument);
+  }
+
+#ifdef __linux__
+  SECTION("Trajectories that can't be fully written throw on closing") {
+    // Every write to /dev/full fails as if the disk were full
+    TrajectoryWriter writer("/dev/full", container, 0.01, 10);
+    for (size_t frame = 0; frame < 20; frame++) {
+      container.AdvanceOneFrame();
+      writer.Record(container);
+    }
+
+    REQUIRE_THROWS_AS(writer.Close(), std::invalid_argument);
+  }
+#endif
+
+  std::remove(file_path.c_str());
+}